@@ -0,0 +1,655 @@
+//
+//  XPLMStub.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Stand-ins for the XPLM functions LiveTraffic uses, see XPStub.h
+
+#include "XPStub.h"
+
+#include "XPLMDataAccess.h"
+#include "XPLMUtilities.h"
+#include "XPLMPlugin.h"
+#include "XPLMProcessing.h"
+#include "XPLMCamera.h"
+#include "XPLMGraphics.h"
+#include "XPLMScenery.h"
+#include "XPLMMenus.h"
+#include "XPLMDisplay.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <dirent.h>
+#include <unistd.h>
+
+//
+//MARK: Globals
+//
+
+// meters per degree latitude (on the equator also per degree longitude)
+const double STUB_M_PER_DEG = 111319.49;
+// frame time used for the very first real-time frame
+const float  STUB_FIRST_FRAME = 1.0f/30.0f;
+// our fake plugin id
+const XPLMPluginID STUB_MY_ID = 1;
+
+std::string stubSystemPath;
+std::string stubPluginPath;
+
+// camera and local reference point
+XPLMCameraPosition_t stubCamera = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+double stubRefLat = 0.0;
+double stubRefLon = 0.0;
+double stubTerrainAlt = 0.0;
+
+// time
+double stubElapsedTime = 0.0;
+int stubCycleNum = 0;
+std::chrono::steady_clock::time_point stubLastFrame;
+bool stubHadFrame = false;
+
+//
+//MARK: Setup
+//
+
+void XPStubSetSystemPath (const std::string& path)
+{
+    stubSystemPath = path;
+    if (!stubSystemPath.empty() && stubSystemPath.back() != '/')
+        stubSystemPath += '/';
+}
+
+void XPStubSetPluginPath (const std::string& path)
+{
+    stubPluginPath = path;
+}
+
+const std::string& GetStubSystemPath ()
+{
+    if (stubSystemPath.empty()) {
+        char buf[1024];
+        XPStubSetSystemPath(getcwd(buf, sizeof(buf)) ? buf : ".");
+    }
+    return stubSystemPath;
+}
+
+void XPStubSetCamera (double lat, double lon, double alt_m, float heading)
+{
+    // the camera defines the local coordinate system's origin
+    stubRefLat = lat;
+    stubRefLon = lon;
+    stubCamera.x = 0.0f;
+    stubCamera.y = float(alt_m);
+    stubCamera.z = 0.0f;
+    stubCamera.heading = heading;
+}
+
+void XPStubSetTerrainAlt (double alt_m)
+{
+    stubTerrainAlt = alt_m;
+}
+
+//
+//MARK: Data Access
+//
+
+// a dataRef: either provided by a plugin's accessors or just a stored value
+struct stubDataRefTy {
+    std::string         name;
+    std::atomic<double> val {0.0};
+    XPLMDataTypeID      types = xplmType_Int | xplmType_Float | xplmType_Double;
+    XPLMGetDatai_f      readInt     = nullptr;
+    XPLMSetDatai_f      writeInt    = nullptr;
+    XPLMGetDataf_f      readFloat   = nullptr;
+    XPLMSetDataf_f      writeFloat  = nullptr;
+    XPLMGetDatad_f      readDouble  = nullptr;
+    XPLMSetDatad_f      writeDouble = nullptr;
+    void*               readRefcon  = nullptr;
+    void*               writeRefcon = nullptr;
+
+    bool HasAccessor () const
+    { return readInt || readFloat || readDouble || writeInt || writeFloat || writeDouble; }
+    
+    double Get () const
+    {
+        if (readDouble) return readDouble(readRefcon);
+        if (readFloat)  return readFloat(readRefcon);
+        if (readInt)    return readInt(readRefcon);
+        return HasAccessor() ? 0.0 : val.load();
+    }
+    
+    void Set (double d)
+    {
+        if      (writeDouble) writeDouble(writeRefcon, d);
+        else if (writeFloat)  writeFloat(writeRefcon, float(d));
+        else if (writeInt)    writeInt(writeRefcon, int(d));
+        else if (!HasAccessor()) val = d;
+    }
+};
+
+// X-Plane's dataRefs, which don't start with 0
+const struct { const char* name; double val; } STUB_DATAREF_DEFAULTS[] = {
+    { "sim/time/use_system_time",               1.0 },
+    { "sim/operation/misc/frame_rate_period",   STUB_FIRST_FRAME },
+};
+
+// find a dataRef, create it if it doesn't exist yet
+// (plugin code calls us already during static initialization,
+//  hence our containers are constructed on first use)
+stubDataRefTy* FindOrCreateDataRef (const char* name)
+{
+    // all dataRefs ever asked for, never removed so handles stay valid
+    static std::map<std::string, std::unique_ptr<stubDataRefTy>> mapDataRefs;
+    static std::mutex mapDataRefsMutex;
+    
+    std::lock_guard<std::mutex> lock (mapDataRefsMutex);
+    std::unique_ptr<stubDataRefTy>& p = mapDataRefs[name];
+    if (!p) {
+        p = std::make_unique<stubDataRefTy>();
+        p->name = name;
+        for (const auto& def: STUB_DATAREF_DEFAULTS)
+            if (p->name == def.name)
+                p->val = def.val;
+    }
+    return p.get();
+}
+
+// any name is found, so that all of X-Plane's dataRefs exist
+XPLMDataRef XPLMFindDataRef (const char* inDataRefName)
+{
+    return inDataRefName ? FindOrCreateDataRef(inDataRefName) : nullptr;
+}
+
+XPLMDataTypeID XPLMGetDataRefTypes (XPLMDataRef inDataRef)
+{
+    return inDataRef ? static_cast<stubDataRefTy*>(inDataRef)->types : xplmType_Unknown;
+}
+
+int XPLMGetDatai (XPLMDataRef inDataRef)
+{
+    return inDataRef ? int(static_cast<stubDataRefTy*>(inDataRef)->Get()) : 0;
+}
+
+void XPLMSetDatai (XPLMDataRef inDataRef, int inValue)
+{
+    if (inDataRef) static_cast<stubDataRefTy*>(inDataRef)->Set(inValue);
+}
+
+float XPLMGetDataf (XPLMDataRef inDataRef)
+{
+    return inDataRef ? float(static_cast<stubDataRefTy*>(inDataRef)->Get()) : 0.0f;
+}
+
+void XPLMSetDataf (XPLMDataRef inDataRef, float inValue)
+{
+    if (inDataRef) static_cast<stubDataRefTy*>(inDataRef)->Set(inValue);
+}
+
+double XPLMGetDatad (XPLMDataRef inDataRef)
+{
+    return inDataRef ? static_cast<stubDataRefTy*>(inDataRef)->Get() : 0.0;
+}
+
+void XPLMSetDatad (XPLMDataRef inDataRef, double inValue)
+{
+    if (inDataRef) static_cast<stubDataRefTy*>(inDataRef)->Set(inValue);
+}
+
+// array and data accessors are accepted but never called
+XPLMDataRef XPLMRegisterDataAccessor (const char* inDataName,
+                                      XPLMDataTypeID inDataType,
+                                      int /*inIsWritable*/,
+                                      XPLMGetDatai_f inReadInt,
+                                      XPLMSetDatai_f inWriteInt,
+                                      XPLMGetDataf_f inReadFloat,
+                                      XPLMSetDataf_f inWriteFloat,
+                                      XPLMGetDatad_f inReadDouble,
+                                      XPLMSetDatad_f inWriteDouble,
+                                      XPLMGetDatavi_f /*inReadIntArray*/,
+                                      XPLMSetDatavi_f /*inWriteIntArray*/,
+                                      XPLMGetDatavf_f /*inReadFloatArray*/,
+                                      XPLMSetDatavf_f /*inWriteFloatArray*/,
+                                      XPLMGetDatab_f /*inReadData*/,
+                                      XPLMSetDatab_f /*inWriteData*/,
+                                      void* inReadRefcon,
+                                      void* inWriteRefcon)
+{
+    stubDataRefTy* p = FindOrCreateDataRef(inDataName);
+    p->types        = inDataType;
+    p->readInt      = inReadInt;
+    p->writeInt     = inWriteInt;
+    p->readFloat    = inReadFloat;
+    p->writeFloat   = inWriteFloat;
+    p->readDouble   = inReadDouble;
+    p->writeDouble  = inWriteDouble;
+    p->readRefcon   = inReadRefcon;
+    p->writeRefcon  = inWriteRefcon;
+    return p;
+}
+
+// the dataRef turns back into a plain stored value
+void XPLMUnregisterDataAccessor (XPLMDataRef inDataRef)
+{
+    if (!inDataRef) return;
+    stubDataRefTy* p = static_cast<stubDataRefTy*>(inDataRef);
+    p->types = xplmType_Int | xplmType_Float | xplmType_Double;
+    p->readInt = nullptr;       p->writeInt = nullptr;
+    p->readFloat = nullptr;     p->writeFloat = nullptr;
+    p->readDouble = nullptr;    p->writeDouble = nullptr;
+    p->readRefcon = nullptr;    p->writeRefcon = nullptr;
+}
+
+//
+//MARK: Utilities, Plugins
+//
+
+// X-Plane's Log.txt is stderr
+void XPLMDebugString (const char* inString)
+{
+    fputs(inString, stderr);
+}
+
+void XPLMGetSystemPath (char* outSystemPath)
+{
+    // X-Plane's buffer contract: at least 512 bytes
+    strncpy(outSystemPath, GetStubSystemPath().c_str(), 511);
+    outSystemPath[511] = 0;
+}
+
+const char* XPLMGetDirectorySeparator ()
+{
+    return "/";
+}
+
+int XPLMGetDirectoryContents (const char* inDirectoryPath,
+                              int inFirstReturn,
+                              char* outFileNames,
+                              int inFileNameBufSize,
+                              char** outIndices,
+                              int inIndexCount,
+                              int* outTotalFiles,
+                              int* outReturnedFiles)
+{
+    int nTotal = 0, nReturned = 0, bufUsed = 0;
+    bool bComplete = true;
+    DIR* pDir = opendir(inDirectoryPath);
+    if (pDir) {
+        for (const dirent* pEnt = readdir(pDir); pEnt; pEnt = readdir(pDir)) {
+            if (!strcmp(pEnt->d_name, ".") || !strcmp(pEnt->d_name, ".."))
+                continue;
+            if (nTotal++ < inFirstReturn || !bComplete)
+                continue;
+            // does the name still fit into the buffers?
+            const int len = int(strlen(pEnt->d_name)) + 1;
+            if (!outFileNames || bufUsed + len > inFileNameBufSize ||
+                (outIndices && nReturned >= inIndexCount)) {
+                bComplete = false;
+                continue;
+            }
+            memcpy(outFileNames + bufUsed, pEnt->d_name, size_t(len));
+            if (outIndices)
+                outIndices[nReturned] = outFileNames + bufUsed;
+            bufUsed += len;
+            nReturned++;
+        }
+        closedir(pDir);
+    }
+    if (outTotalFiles)    *outTotalFiles = nTotal;
+    if (outReturnedFiles) *outReturnedFiles = nReturned;
+    return pDir && bComplete ? 1 : 0;
+}
+
+void XPLMReloadPlugins ()
+{}
+
+void XPLMEnableFeature (const char* /*inFeature*/, int /*inEnable*/)
+{}
+
+XPLMPluginID XPLMGetMyID ()
+{
+    return STUB_MY_ID;
+}
+
+// there are no other plugins
+XPLMPluginID XPLMFindPluginBySignature (const char* /*inSignature*/)
+{
+    return XPLM_NO_PLUGIN_ID;
+}
+
+void XPLMGetPluginInfo (XPLMPluginID inPlugin,
+                        char* outName,
+                        char* outFilePath,
+                        char* outSignature,
+                        char* outDescription)
+{
+    const bool bMe = inPlugin == STUB_MY_ID;
+    if (outName)        strcpy(outName, bMe ? "LiveTraffic" : "");
+    if (outSignature)   strcpy(outSignature, "");
+    if (outDescription) strcpy(outDescription, "");
+    if (outFilePath) {
+        std::string path;
+        if (bMe)
+            path = stubPluginPath.empty() ?
+                   GetStubSystemPath() + "Resources/plugins/LiveTraffic/64/lin.xpl" :
+                   stubPluginPath;
+        strncpy(outFilePath, path.c_str(), 511);
+        outFilePath[511] = 0;
+    }
+}
+
+void XPLMSendMessageToPlugin (XPLMPluginID /*inPlugin*/, int /*inMessage*/, void* /*inParam*/)
+{}
+
+//
+//MARK: Processing
+//
+
+// a registered flight loop callback and its schedule
+struct stubFlightLoopTy {
+    XPLMFlightLoop_f    cb      = nullptr;
+    void*               refcon  = nullptr;
+    bool                bScheduled = false;
+    bool                bCycles = false;        // next call defined by cycle number?
+    double              tNext   = 0.0;
+    int                 cycleNext = 0;
+    double              tLast   = 0.0;          // time of last call
+
+    // interval > 0: seconds, < 0: cycles, 0: not at all
+    void Schedule (float interval, double base)
+    {
+        bScheduled = interval < 0.0f || interval > 0.0f;
+        bCycles = interval < 0.0f;
+        tNext = base + interval;
+        cycleNext = stubCycleNum + int(std::lround(-interval));
+    }
+    
+    bool IsDue () const
+    { return bScheduled && (bCycles ? cycleNext <= stubCycleNum : tNext <= stubElapsedTime); }
+};
+
+// all registered flight loop callbacks (constructed on first use)
+std::list<stubFlightLoopTy>& StubFlightLoops ()
+{
+    static std::list<stubFlightLoopTy> listFlightLoops;
+    return listFlightLoops;
+}
+
+std::list<stubFlightLoopTy>::iterator FindFlightLoop (XPLMFlightLoop_f cb, void* refcon)
+{
+    std::list<stubFlightLoopTy>& listFl = StubFlightLoops();
+    for (auto iter = listFl.begin(); iter != listFl.end(); ++iter)
+        if (iter->cb == cb && iter->refcon == refcon)
+            return iter;
+    return listFl.end();
+}
+
+float XPLMGetElapsedTime ()
+{
+    return float(stubElapsedTime);
+}
+
+int XPLMGetCycleNumber ()
+{
+    return stubCycleNum;
+}
+
+void XPLMRegisterFlightLoopCallback (XPLMFlightLoop_f inFlightLoop,
+                                     float inInterval,
+                                     void* inRefcon)
+{
+    auto iter = FindFlightLoop(inFlightLoop, inRefcon);
+    if (iter == StubFlightLoops().end())
+        iter = StubFlightLoops().emplace(StubFlightLoops().end());
+    iter->cb = inFlightLoop;
+    iter->refcon = inRefcon;
+    iter->tLast = stubElapsedTime;
+    iter->Schedule(inInterval, stubElapsedTime);
+}
+
+void XPLMUnregisterFlightLoopCallback (XPLMFlightLoop_f inFlightLoop,
+                                       void* inRefcon)
+{
+    auto iter = FindFlightLoop(inFlightLoop, inRefcon);
+    if (iter != StubFlightLoops().end())
+        StubFlightLoops().erase(iter);
+}
+
+void XPLMSetFlightLoopCallbackInterval (XPLMFlightLoop_f inFlightLoop,
+                                        float inInterval,
+                                        int inRelativeToNow,
+                                        void* inRefcon)
+{
+    auto iter = FindFlightLoop(inFlightLoop, inRefcon);
+    if (iter != StubFlightLoops().end())
+        iter->Schedule(inInterval, inRelativeToNow ? stubElapsedTime : iter->tLast);
+}
+
+void XPStubRunFrame (float dt, bool bDraw)
+{
+    // advance time
+    const auto now = std::chrono::steady_clock::now();
+    if (dt <= 0.0f)
+        dt = stubHadFrame ? std::chrono::duration<float>(now - stubLastFrame).count() :
+                            STUB_FIRST_FRAME;
+    stubLastFrame = now;
+    stubHadFrame = true;
+    stubElapsedTime += dt;
+    stubCycleNum++;
+    stubDataRefTy* pDr = FindOrCreateDataRef("sim/time/total_running_time_sec");
+    pDr->Set(pDr->Get() + dt);
+    FindOrCreateDataRef("sim/operation/misc/frame_rate_period")->Set(dt);
+    
+    // which callbacks are due? (callbacks may (un)register others, so we collect first)
+    std::vector<std::pair<XPLMFlightLoop_f,void*>> vDue;
+    for (const stubFlightLoopTy& fl: StubFlightLoops())
+        if (fl.IsDue())
+            vDue.emplace_back(fl.cb, fl.refcon);
+    
+    for (const auto& due: vDue) {
+        auto iter = FindFlightLoop(due.first, due.second);
+        if (iter == StubFlightLoops().end() || !iter->IsDue())
+            continue;
+        const float sinceLast = float(stubElapsedTime - iter->tLast);
+        iter->tLast = stubElapsedTime;
+        const float next = due.first(sinceLast, dt, stubCycleNum, due.second);
+        // the return value defines the next call, if still registered
+        iter = FindFlightLoop(due.first, due.second);
+        if (iter != StubFlightLoops().end())
+            iter->Schedule(next, stubElapsedTime);
+    }
+    
+    // render the planes
+    if (bDraw)
+        XPStubDrawPlanes();
+}
+
+//
+//MARK: Camera, Graphics, Scenery
+//
+
+void XPLMReadCameraPosition (XPLMCameraPosition_t* outCameraPosition)
+{
+    if (outCameraPosition) *outCameraPosition = stubCamera;
+}
+
+// flat projection around the reference point:
+// x points east, y up, z south, just like X-Plane's OpenGL coordinates
+void XPLMWorldToLocal (double inLatitude, double inLongitude, double inAltitude,
+                       double* outX, double* outY, double* outZ)
+{
+    *outX = (inLongitude - stubRefLon) * STUB_M_PER_DEG * std::cos(stubRefLat * M_PI / 180.0);
+    *outY = inAltitude;
+    *outZ = (stubRefLat - inLatitude) * STUB_M_PER_DEG;
+}
+
+void XPLMLocalToWorld (double inX, double inY, double inZ,
+                       double* outLatitude, double* outLongitude, double* outAltitude)
+{
+    *outLatitude  = stubRefLat - inZ / STUB_M_PER_DEG;
+    *outLongitude = stubRefLon + inX / (STUB_M_PER_DEG * std::cos(stubRefLat * M_PI / 180.0));
+    *outAltitude  = inY;
+}
+
+void XPLMSetGraphicsState (int, int, int, int, int, int, int)
+{}
+
+void XPLMDrawTranslucentDarkBox (int, int, int, int)
+{}
+
+void XPLMDrawString (float*, int, int, char*, int*, XPLMFontID)
+{}
+
+// a probe needs no state, any non-null handle will do
+XPLMProbeRef XPLMCreateProbe (XPLMProbeType inProbeType)
+{
+    return new XPLMProbeType(inProbeType);
+}
+
+void XPLMDestroyProbe (XPLMProbeRef inProbe)
+{
+    delete static_cast<XPLMProbeType*>(inProbe);
+}
+
+// flat terrain at stubTerrainAlt
+XPLMProbeResult XPLMProbeTerrainXYZ (XPLMProbeRef inProbe,
+                                     float inX, float /*inY*/, float inZ,
+                                     XPLMProbeInfo_t* outInfo)
+{
+    if (!inProbe || !outInfo)
+        return xplm_ProbeError;
+    outInfo->locationX = inX;
+    outInfo->locationY = float(stubTerrainAlt);
+    outInfo->locationZ = inZ;
+    outInfo->normalX = 0.0f;
+    outInfo->normalY = 1.0f;
+    outInfo->normalZ = 0.0f;
+    outInfo->velocityX = outInfo->velocityY = outInfo->velocityZ = 0.0f;
+    outInfo->is_wet = 0;
+    return xplm_ProbeHitTerrain;
+}
+
+//
+//MARK: Menus, Windows
+//
+
+// menus only need distinct handles
+intptr_t stubNextMenuId = 1;
+
+XPLMMenuID XPLMFindPluginsMenu ()
+{
+    return reinterpret_cast<XPLMMenuID>(stubNextMenuId);
+}
+
+XPLMMenuID XPLMCreateMenu (const char*, XPLMMenuID, int, XPLMMenuHandler_f, void*)
+{
+    return reinterpret_cast<XPLMMenuID>(++stubNextMenuId);
+}
+
+int XPLMAppendMenuItem (XPLMMenuID, const char*, void*, int)
+{
+    static int nextItem = 0;
+    return nextItem++;
+}
+
+void XPLMAppendMenuSeparator (XPLMMenuID)
+{}
+
+void XPLMCheckMenuItem (XPLMMenuID, int, XPLMMenuCheck)
+{}
+
+// a window is just its geometry, never drawn
+struct stubWindowTy {
+    int left = 0, top = 0, right = 0, bottom = 0;
+};
+
+XPLMWindowID XPLMCreateWindowEx (XPLMCreateWindow_t* inParams)
+{
+    stubWindowTy* pWnd = new stubWindowTy;
+    if (inParams) {
+        pWnd->left = inParams->left;
+        pWnd->top = inParams->top;
+        pWnd->right = inParams->right;
+        pWnd->bottom = inParams->bottom;
+    }
+    return pWnd;
+}
+
+void XPLMDestroyWindow (XPLMWindowID inWindowID)
+{
+    delete static_cast<stubWindowTy*>(inWindowID);
+}
+
+void XPLMGetWindowGeometry (XPLMWindowID inWindowID,
+                            int* outLeft, int* outTop, int* outRight, int* outBottom)
+{
+    const stubWindowTy* pWnd = static_cast<stubWindowTy*>(inWindowID);
+    if (!pWnd) return;
+    if (outLeft)   *outLeft = pWnd->left;
+    if (outTop)    *outTop = pWnd->top;
+    if (outRight)  *outRight = pWnd->right;
+    if (outBottom) *outBottom = pWnd->bottom;
+}
+
+void XPLMSetWindowGeometry (XPLMWindowID inWindowID,
+                            int inLeft, int inTop, int inRight, int inBottom)
+{
+    stubWindowTy* pWnd = static_cast<stubWindowTy*>(inWindowID);
+    if (!pWnd) return;
+    pWnd->left = inLeft;
+    pWnd->top = inTop;
+    pWnd->right = inRight;
+    pWnd->bottom = inBottom;
+}
+
+// a single 1024x768 screen
+void XPLMGetScreenSize (int* outWidth, int* outHeight)
+{
+    if (outWidth)  *outWidth = 1024;
+    if (outHeight) *outHeight = 768;
+}
+
+void XPLMGetScreenBoundsGlobal (int* outLeft, int* outTop, int* outRight, int* outBottom)
+{
+    if (outLeft)   *outLeft = 0;
+    if (outTop)    *outTop = 768;
+    if (outRight)  *outRight = 1024;
+    if (outBottom) *outBottom = 0;
+}
+
+void XPLMSetWindowPositioningMode (XPLMWindowID, XPLMWindowPositioningMode, int)
+{}
+
+void XPLMSetWindowResizingLimits (XPLMWindowID, int, int, int, int)
+{}
+
+void XPLMSetWindowTitle (XPLMWindowID, const char*)
+{}
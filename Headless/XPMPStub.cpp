@@ -0,0 +1,203 @@
+//
+//  XPMPStub.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Stand-ins for the xplanemp functions LiveTraffic uses, see XPStub.h.
+// Planes are kept in a list and queried once per frame by XPStubDrawPlanes,
+// which is what xplanemp's renderer does in X-Plane.
+
+#include "XPStub.h"
+
+#include "XPMPMultiplayer.h"
+#include "XPCAircraft.h"
+
+#include <cstring>
+#include <map>
+#include <memory>
+
+//
+//MARK: Plane Store
+//
+
+// a plane and the callback providing its data
+struct stubPlaneTy {
+    XPStubPlaneTy       plane;
+    XPMPPlaneData_f     dataFunc = nullptr;
+    void*               refcon = nullptr;
+};
+
+// all planes, keyed by their id, which is the record's address
+// (constructed on first use as a/c might exist during static initialization)
+std::map<XPMPPlaneID, std::unique_ptr<stubPlaneTy>>& StubPlanes ()
+{
+    static std::map<XPMPPlaneID, std::unique_ptr<stubPlaneTy>> mapPlanes;
+    return mapPlanes;
+}
+
+void XPStubDrawPlanes ()
+{
+    for (auto& p: StubPlanes()) {
+        stubPlaneTy& sp = *p.second;
+        if (!sp.dataFunc) continue;
+        XPStubPlaneTy& pl = sp.plane;
+        pl.pos.size = sizeof(pl.pos);
+        if (sp.dataFunc(pl.id, xpmpDataType_Position, &pl.pos, sp.refcon) != xpmpData_Unavailable)
+            pl.bPos = true;
+        pl.surf.size = sizeof(pl.surf);
+        sp.dataFunc(pl.id, xpmpDataType_Surfaces, &pl.surf, sp.refcon);
+        pl.radar.size = sizeof(pl.radar);
+        sp.dataFunc(pl.id, xpmpDataType_Radar, &pl.radar, sp.refcon);
+    }
+}
+
+size_t XPStubNumPlanes ()
+{
+    return StubPlanes().size();
+}
+
+std::vector<XPStubPlaneTy> XPStubGetPlanes ()
+{
+    std::vector<XPStubPlaneTy> v;
+    v.reserve(StubPlanes().size());
+    for (const auto& p: StubPlanes())
+        v.push_back(p.second->plane);
+    return v;
+}
+
+//
+//MARK: Multiplayer API
+//
+
+// there are no CSL models to load, so all initialization succeeds
+const char* XPMPMultiplayerInitLegacyData (const char*, const char*, const char*,
+                                           const char*, const char*,
+                                           int (*)(const char*, const char*, int),
+                                           float (*)(const char*, const char*, float))
+{
+    return "";
+}
+
+const char* XPMPMultiplayerInit (int (*)(const char*, const char*, int),
+                                 float (*)(const char*, const char*, float))
+{
+    return "";
+}
+
+const char* XPMPMultiplayerEnable ()
+{
+    return "";
+}
+
+void XPMPMultiplayerDisable ()
+{}
+
+void XPMPMultiplayerCleanup ()
+{
+    StubPlanes().clear();
+}
+
+const char* XPMPLoadCSLPackage (const char*, const char*, const char*)
+{
+    return "";
+}
+
+void XPMPLoadPlanesIfNecessary ()
+{}
+
+XPMPPlaneID XPMPCreatePlane (const char* inICAOCode,
+                             const char* inAirline,
+                             const char* inLivery,
+                             XPMPPlaneData_f inDataFunc,
+                             void* inRefcon)
+{
+    std::unique_ptr<stubPlaneTy> p = std::make_unique<stubPlaneTy>();
+    p->plane.id = p.get();
+    p->plane.icao = inICAOCode ? inICAOCode : "";
+    p->plane.airline = inAirline ? inAirline : "";
+    p->plane.livery = inLivery ? inLivery : "";
+    p->dataFunc = inDataFunc;
+    p->refcon = inRefcon;
+    XPMPPlaneID id = p->plane.id;
+    StubPlanes().emplace(id, std::move(p));
+    return id;
+}
+
+void XPMPDestroyPlane (XPMPPlaneID inID)
+{
+    StubPlanes().erase(inID);
+}
+
+// the "model" is just the ICAO type the plane was created with
+int XPMPGetPlaneModelName (XPMPPlaneID inPlaneID, char* outTxtBuf, int outTxtBufSize)
+{
+    auto iter = StubPlanes().find(inPlaneID);
+    const std::string name = iter == StubPlanes().end() ? "" : iter->second->plane.icao;
+    if (outTxtBuf && outTxtBufSize > 0) {
+        strncpy(outTxtBuf, name.c_str(), size_t(outTxtBufSize));
+        outTxtBuf[outTxtBufSize-1] = 0;
+    }
+    return int(name.length());
+}
+
+void XPMPEnableAircraftLabels ()
+{}
+
+void XPMPDisableAircraftLabels ()
+{}
+
+void XPMPSetLabelSSAACorrection (int)
+{}
+
+//
+//MARK: XPCAircraft
+//
+
+XPCAircraft::XPCAircraft (const char* inICAOCode,
+                          const char* inAirline,
+                          const char* inLivery)
+{
+    mPlane = XPMPCreatePlane(inICAOCode, inAirline, inLivery, AircraftCB, this);
+}
+
+XPCAircraft::~XPCAircraft ()
+{
+    XPMPDestroyPlane(mPlane);
+}
+
+XPMPPlaneCallbackResult XPCAircraft::AircraftCB (XPMPPlaneID /*inPlane*/,
+                                                 XPMPPlaneDataType inDataType,
+                                                 void* ioData,
+                                                 void* inRefcon)
+{
+    XPCAircraft* me = static_cast<XPCAircraft*>(inRefcon);
+    switch (inDataType) {
+        case xpmpDataType_Position:
+            return me->GetPlanePosition(static_cast<XPMPPlanePosition_t*>(ioData));
+        case xpmpDataType_Surfaces:
+            return me->GetPlaneSurfaces(static_cast<XPMPPlaneSurfaces_t*>(ioData));
+        case xpmpDataType_Radar:
+            return me->GetPlaneRadar(static_cast<XPMPPlaneRadar_t*>(ioData));
+    }
+    return xpmpData_Unavailable;
+}
@@ -0,0 +1,89 @@
+//
+//  XPStub.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Headless stand-ins for the X-Plane SDK (XPLM, XPWidgets) and for
+// xplanemp, so that livetraffic_core can be linked into a plain executable
+// and driven without X-Plane. The functions below let such a driver play
+// "X-Plane": set up paths and the scene, then advance time frame by frame
+// and look at the planes LiveTraffic has drawn.
+//
+// Local coordinates are a flat projection around a reference point,
+// which is where the camera was last put (see XPStubSetCamera).
+// Terrain is flat, too, at an adjustable elevation.
+
+#ifndef XPStub_h
+#define XPStub_h
+
+#include "XPLMDefs.h"
+#include "XPMPMultiplayer.h"
+
+#include <string>
+#include <vector>
+
+//
+//MARK: Setup
+//
+
+// X-Plane's root folder, incl. trailing separator (default: working directory)
+void XPStubSetSystemPath (const std::string& path);
+// full path of the plugin's .xpl file
+// (default: <system path>Resources/plugins/LiveTraffic/64/lin.xpl)
+void XPStubSetPluginPath (const std::string& path);
+
+// place the camera (world coordinates), also moves the local reference point
+void XPStubSetCamera (double lat, double lon, double alt_m, float heading = 0.0f);
+// terrain elevation returned by all Y probes [m MSL]
+void XPStubSetTerrainAlt (double alt_m);
+
+//
+//MARK: Running
+//
+
+// Runs one simulator frame:
+// advances elapsed time by dt seconds (dt <= 0: real time since last frame),
+// increments the cycle number, calls the flight loop callbacks due,
+// then (if bDraw) queries all xplanemp planes just like the renderer would.
+void XPStubRunFrame (float dt, bool bDraw = true);
+
+// a plane as seen by the last XPStubRunFrame
+struct XPStubPlaneTy {
+    XPMPPlaneID         id = nullptr;
+    std::string         icao, airline, livery;
+    bool                bPos = false;       // position ever provided?
+    XPMPPlanePosition_t pos;
+    XPMPPlaneSurfaces_t surf;
+    XPMPPlaneRadar_t    radar;
+};
+
+// queries all planes' position, surfaces, and radar data now
+// (XPStubRunFrame does that once per frame anyway)
+void XPStubDrawPlanes ();
+
+// number of planes currently created via xplanemp
+size_t XPStubNumPlanes ();
+// snapshot copy of all planes
+std::vector<XPStubPlaneTy> XPStubGetPlanes ();
+
+#endif /* XPStub_h */
@@ -0,0 +1,248 @@
+//
+//  XPWidgetsStub.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Stand-ins for the XPWidgets functions LiveTraffic uses, see XPStub.h.
+// Widgets keep their state (geometry, descriptor, properties, hierarchy),
+// but are never drawn and never receive messages.
+
+#include "XPStub.h"
+
+#include "XPWidgets.h"
+#include "XPWidgetUtils.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+//
+//MARK: Widget Store
+//
+
+struct stubWidgetTy {
+    int left = 0, top = 0, right = 0, bottom = 0;
+    bool bVisible = false;
+    bool bRoot = false;
+    std::string descriptor;
+    XPWidgetClass cls = xpWidgetClass_None;
+    stubWidgetTy* pParent = nullptr;
+    std::vector<stubWidgetTy*> vChildren;
+    std::map<XPWidgetPropertyID, intptr_t> mapProps;
+};
+
+XPWidgetID stubWidgetFocus = nullptr;
+
+inline stubWidgetTy* StubWidget (XPWidgetID inWidget)
+{ return static_cast<stubWidgetTy*>(inWidget); }
+
+//
+//MARK: Widgets
+//
+
+XPWidgetID XPCreateWidget (int inLeft, int inTop, int inRight, int inBottom,
+                           int inVisible,
+                           const char* inDescriptor,
+                           int inIsRoot,
+                           XPWidgetID inContainer,
+                           XPWidgetClass inClass)
+{
+    stubWidgetTy* pW = new stubWidgetTy;
+    pW->left = inLeft;
+    pW->top = inTop;
+    pW->right = inRight;
+    pW->bottom = inBottom;
+    pW->bVisible = inVisible != 0;
+    pW->bRoot = inIsRoot != 0;
+    pW->descriptor = inDescriptor ? inDescriptor : "";
+    pW->cls = inClass;
+    pW->pParent = StubWidget(inContainer);
+    if (pW->pParent)
+        pW->pParent->vChildren.push_back(pW);
+    return pW;
+}
+
+void XPDestroyWidget (XPWidgetID inWidget, int inDestroyChildren)
+{
+    stubWidgetTy* pW = StubWidget(inWidget);
+    if (!pW) return;
+    // children: destroy or orphan
+    for (stubWidgetTy* pChild: std::vector<stubWidgetTy*>(pW->vChildren)) {
+        if (inDestroyChildren)
+            XPDestroyWidget(pChild, 1);
+        else
+            pChild->pParent = nullptr;
+    }
+    if (pW->pParent) {
+        auto& vSibl = pW->pParent->vChildren;
+        vSibl.erase(std::remove(vSibl.begin(), vSibl.end(), pW), vSibl.end());
+    }
+    if (stubWidgetFocus == inWidget)
+        stubWidgetFocus = nullptr;
+    delete pW;
+}
+
+// nobody listens, nobody answers
+int XPSendMessageToWidget (XPWidgetID, XPWidgetMessage, XPDispatchMode, intptr_t, intptr_t)
+{
+    return 0;
+}
+
+void XPAddWidgetCallback (XPWidgetID, XPWidgetFunc_t)
+{}
+
+void XPShowWidget (XPWidgetID inWidget)
+{
+    if (inWidget) StubWidget(inWidget)->bVisible = true;
+}
+
+void XPHideWidget (XPWidgetID inWidget)
+{
+    if (inWidget) StubWidget(inWidget)->bVisible = false;
+}
+
+int XPIsWidgetVisible (XPWidgetID inWidget)
+{
+    for (const stubWidgetTy* pW = StubWidget(inWidget); pW; pW = pW->pParent)
+        if (!pW->bVisible)
+            return 0;
+    return inWidget ? 1 : 0;
+}
+
+XPWidgetID XPFindRootWidget (XPWidgetID inWidget)
+{
+    for (stubWidgetTy* pW = StubWidget(inWidget); pW; pW = pW->pParent)
+        if (pW->bRoot)
+            return pW;
+    return nullptr;
+}
+
+int XPCountChildWidgets (XPWidgetID inWidget)
+{
+    return inWidget ? int(StubWidget(inWidget)->vChildren.size()) : 0;
+}
+
+XPWidgetID XPGetNthChildWidget (XPWidgetID inWidget, int inIndex)
+{
+    if (!inWidget || inIndex < 0 ||
+        inIndex >= int(StubWidget(inWidget)->vChildren.size()))
+        return nullptr;
+    return StubWidget(inWidget)->vChildren[size_t(inIndex)];
+}
+
+XPWidgetID XPGetParentWidget (XPWidgetID inWidget)
+{
+    return inWidget ? StubWidget(inWidget)->pParent : nullptr;
+}
+
+void XPGetWidgetGeometry (XPWidgetID inWidget,
+                          int* outLeft, int* outTop, int* outRight, int* outBottom)
+{
+    const stubWidgetTy* pW = StubWidget(inWidget);
+    if (!pW) return;
+    if (outLeft)   *outLeft = pW->left;
+    if (outTop)    *outTop = pW->top;
+    if (outRight)  *outRight = pW->right;
+    if (outBottom) *outBottom = pW->bottom;
+}
+
+void XPSetWidgetGeometry (XPWidgetID inWidget,
+                          int inLeft, int inTop, int inRight, int inBottom)
+{
+    stubWidgetTy* pW = StubWidget(inWidget);
+    if (!pW) return;
+    pW->left = inLeft;
+    pW->top = inTop;
+    pW->right = inRight;
+    pW->bottom = inBottom;
+}
+
+void XPSetWidgetDescriptor (XPWidgetID inWidget, const char* inDescriptor)
+{
+    if (inWidget) StubWidget(inWidget)->descriptor = inDescriptor ? inDescriptor : "";
+}
+
+int XPGetWidgetDescriptor (XPWidgetID inWidget, char* outDescriptor, int inMaxDescLength)
+{
+    if (!inWidget) return 0;
+    const std::string& desc = StubWidget(inWidget)->descriptor;
+    if (outDescriptor && inMaxDescLength > 0) {
+        const size_t len = std::min(desc.length(), size_t(inMaxDescLength - 1));
+        desc.copy(outDescriptor, len);
+        outDescriptor[len] = 0;
+    }
+    return int(desc.length());
+}
+
+void XPSetWidgetProperty (XPWidgetID inWidget, XPWidgetPropertyID inProperty, intptr_t inValue)
+{
+    if (inWidget) StubWidget(inWidget)->mapProps[inProperty] = inValue;
+}
+
+intptr_t XPGetWidgetProperty (XPWidgetID inWidget, XPWidgetPropertyID inProperty, int* inExists)
+{
+    if (inWidget) {
+        const auto& mapProps = StubWidget(inWidget)->mapProps;
+        auto iter = mapProps.find(inProperty);
+        if (iter != mapProps.end()) {
+            if (inExists) *inExists = 1;
+            return iter->second;
+        }
+    }
+    if (inExists) *inExists = 0;
+    return 0;
+}
+
+XPWidgetID XPSetKeyboardFocus (XPWidgetID inWidget)
+{
+    return stubWidgetFocus = inWidget;
+}
+
+void XPLoseKeyboardFocus (XPWidgetID inWidget)
+{
+    if (stubWidgetFocus == inWidget)
+        stubWidgetFocus = nullptr;
+}
+
+XPWidgetID XPGetWidgetWithFocus ()
+{
+    return stubWidgetFocus;
+}
+
+//
+//MARK: Widget Utils
+//
+
+// moves the widget and all its children
+void XPUMoveWidgetBy (XPWidgetID inWidget, int inDeltaX, int inDeltaY)
+{
+    stubWidgetTy* pW = StubWidget(inWidget);
+    if (!pW) return;
+    pW->left += inDeltaX;
+    pW->right += inDeltaX;
+    pW->top += inDeltaY;
+    pW->bottom += inDeltaY;
+    for (stubWidgetTy* pChild: pW->vChildren)
+        XPUMoveWidgetBy(pChild, inDeltaX, inDeltaY);
+}
@@ -56,8 +56,15 @@ constexpr double PI         = 3.141592653589793238462643383279502884197169399375
 constexpr double EARTH_D_M  = 6371.0 * 2 * 1000;    // earth diameter in meter
 
 //MARK: Flight Data-related
+constexpr int MAX_NUM_AC            = 100;      // upper limit of max_num_ac in the plugin
+constexpr int MAX_NUM_AC_HEADLESS   = 10000;    // upper limit headless drivers (benchmarks) can raise it to
 constexpr double FLIGHT_LOOP_INTVL  = -5.0;     // call ourselves every 5 frames
-constexpr double AC_MAINT_INTVL     = 2.0;      // seconds (calling a/c maintenance periodically)
+constexpr double AC_UPDATE_INTVL    = -1.0;     // per-frame batch update of all aircraft: every frame
+constexpr int AC_CALC_MAX_WORKERS   = 3;        // max number of worker threads for the per-frame aircraft calculation
+constexpr size_t AC_CALC_PARALLEL_MIN = 50;     // with less aircraft the per-frame calculation is done in the main thread only
+constexpr size_t AC_CALC_CHUNK      = 8;        // number of aircraft a worker grabs at a time
+constexpr double AC_MAINT_INTVL     = 2.0;      // seconds (all aircraft are maintained once within this period)
+constexpr long AC_MAINT_BUDGET_US   = 1000;     // [µs] time budget per flight loop call for incremental a/c maintenance
 constexpr double TIME_REQU_POS      = 0.5;      // seconds before reaching current 'to' position we request calculation of next position
 constexpr double SIMILAR_TS_INTVL = 3;          // seconds: Less than that difference and position-timestamps are considered "similar" -> positions are merged rather than added additionally
 constexpr double SIMILAR_POS_DIST = 3;          // [m] if distance between positions less than this then favor heading from flight data over vector between positions
@@ -65,6 +72,28 @@ constexpr double FD_GND_CHECK_AGL = 300;        // [ft] if pos is that close to
 constexpr double FD_GND_AGL =       10;         // [ft] consider pos 'ON GRND' if this close to YProbe
 constexpr double PROBE_HEIGHT_LIM[] = {5000,1000,500,-999999};  // if height AGL is more than ... feet
 constexpr double PROBE_DELAY[]      = {  10,   1,0.5,    0.2};  // delay next Y-probe ... seconds.
+constexpr double PROBE_PRIO_NOT_CRIT = 100000;  // [m] probe priority penalty if not on the ground/on final (priority is distance to camera)
+constexpr double PROBE_PRIO_AGING   = 20000;    // [m/s] probe priority bonus per second waiting in the queue
+constexpr double TERRAIN_CACHE_RES  = 0.00005;  // [°] lat/lon size of a terrain cache cell (about 5m)
+constexpr size_t TERRAIN_CACHE_SIZE = 20000;    // max number of cells in the terrain cache
+constexpr double GOV_FRAME_SHARE    = 0.05;     // below target FPS: share of the target frame time LiveTraffic may use for deferrable work
+constexpr int GOV_MAX_DEFER_SEQ     = 30;       // max consecutive deferrals of one kind of work before it is done anyway
+constexpr double GOV_COST_SMOOTH    = 0.05;     // smoothing factor for the published frame cost
+
+//MARK: Logging
+constexpr size_t LOG_LINE_LEN       = 2048;     // max length of one log line (longer text is split)
+constexpr size_t LOG_RING_SIZE      = 512;      // number of lines the log ring buffer holds (power of 2!)
+constexpr size_t LOG_BATCH_LEN      = 16384;    // characters written to X-Plane's log at once
+constexpr int LOG_WRITER_INTVL_MS   = 100;      // [ms] log writer thread writes this often
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE-1)) == 0, "LOG_RING_SIZE must be a power of 2");
+constexpr size_t TRACE_RING_SIZE    = 65536;    // number of events the position pipeline trace holds (power of 2!)
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE-1)) == 0, "TRACE_RING_SIZE must be a power of 2");
+constexpr int TRACE_ERR_MAX_FILES   = 5;        // max trace files written on errors per session
+constexpr int TRACE_ERR_MIN_INTVL   = 60;       // [s] min time between two trace files written on errors
+constexpr int RAW_REC_MAX_PENDING   = 64;       // max records waiting for the raw data recorder, more are dropped
+constexpr int RAW_REC_INTVL_MS      = 250;      // [ms] raw data recorder writes this often
+constexpr size_t ARENA_CHUNK_INIT   = 64*1024;  // [bytes] first chunk of a channel's parson arena, following ones double
+constexpr size_t ARENA_CHUNK_MAX    = 4*1024*1024;  // [bytes] chunks grow up to this size (unless a single allocation needs more)
 
 //MARK: Flight Model
 constexpr double MDL_ALT_MIN =         -1500;   // [ft] minimum allowed altitude
@@ -118,6 +147,8 @@ extern char LT_BETA_VER_LIMIT_TXT[];
 #define CFG_CSL_SECTION         "[CSLPaths]"
 #define CFG_DEFAULT_AC_TYPE     "DEFAULT_AC_TYPE"
 #define CFG_DEFAULT_CAR_TYPE    "DEFAULT_CAR_TYPE"
+#define CFG_SBS_HOST            "SBS_HOST"
+#define CFG_ADSBEX_STREAM_HOST  "ADSBEX_STREAM_HOST"
 #define CFG_DEFAULT_AC_TYP_INFO "Default a/c type is '%s'"
 #define CFG_DEFAULT_CAR_TYP_INFO "Default car type is '%s'"
 #define XPPRF_RENOPT_HDR        "renopt_HDR"					// XP10
@@ -141,6 +172,9 @@ extern char LT_BETA_VER_LIMIT_TXT[];
 #define PATH_RESOURCES_SCSL     "Resources/ShippedCSL"
 // these are under X-Plane's root dir
 #define PATH_DEBUG_RAW_FD       "LTRawFD.log"   // this is under X-Plane's system dir
+#define PATH_RAW_CAPTURE        "LTRawFD.ltc.gz" // this is under X-Plane's system dir
+#define PATH_TRACE_FILE         "LTTrace.bin"   // this is under X-Plane's system dir
+#define PATH_TRACE_ERR_FILE     "LTTrace_%Y%m%d_%H%M%S.bin" // written on errors, strftime format
 #define PATH_RES_PLUGINS        "Resources/plugins"
 #define PATH_CONFIG_FILE        "Output/preferences/LiveTraffic.prf"
 #define PATH_XPLANE_PRF         "Output/preferences/X-Plane.prf"
@@ -177,6 +211,7 @@ constexpr int SERR_LEN = 100;                   // size of buffer for IO error t
 #define ERR_JSON_AC             "JSON: Could not get %d. aircraft in '%s'"
 #define ERR_NEW_OBJECT          "Could not create new object (memory?): %s"
 #define ERR_LOCK_ERROR          "Could not acquire lock for '%s': %s"
+#define ERR_LOG_DROPPED         "%d log messages dropped, log buffer was full"
 #define ERR_MALLOC              "Could not (re)allocate %ld bytes of memory"
 #define ERR_ASSERT              "ASSERT FAILED: %s"
 #define ERR_AC_NO_POS           "No positional data available when creating aircraft %s"
@@ -295,6 +330,10 @@ constexpr double OPSKY_WAIT_BETWEEN = 0.5;          // seconds to pause between
 #define ADSBEX_ORIGIN           "From"
 #define ADSBEX_DESTINATION      "To"
 
+#define ADSBEX_STREAM_NAME      "ADSB Exchange Live Stream"
+#define ADSBEX_STREAM_HOST_DEFAULT "localhost:32001"
+#define ADSBEX_ALT              "Alt"               // barometric altitude, if GAlt is missing
+
 #define ADSBEX_HIST_NAME        "ADSB Exchange Historic File"
 constexpr int ADSBEX_HIST_MIN_CHARS   = 20;             // minimum nr chars per line to be a 'reasonable' line
 constexpr int ADSBEX_HIST_MAX_ERR_CNT = 5;              // after that many errorneous line we stop reading
@@ -318,6 +357,91 @@ constexpr int ADSBEX_HIST_MAX_ERR_CNT = 5;              // after that many error
 #define ADSBEX_HIST_START_FILE  "START OF FILE "
 #define ADSBEX_HIST_END_FILE    "END OF FILE "
 
+//MARK: Streaming channels
+constexpr int STREAM_POLL_MS        = 20;       // [ms] wait if no data is available on a stream
+constexpr int STREAM_RECONNECT_INTVL = 10;      // [s] wait before reconnecting a lost stream
+constexpr long STREAM_CONNECT_TIMEOUT = 5;      // [s] timeout for establishing a stream connection
+#define STREAM_CONNECTED        "%s: Connected to %s"
+#define ERR_STREAM_CONNECT      "%s: Could not connect to %s: %s"
+#define ERR_STREAM_CLOSED       "%s: Connection to %s lost: %s"
+
+//MARK: SBS-1 BaseStation
+#define SBS_NAME                "SBS-1 BaseStation Feed"
+#define SBS_HOST_DEFAULT        "localhost:30003"   // dump1090's BaseStation output
+constexpr double SBS_FLUSH_INTVL  = 0.25;           // [s] coalesced updates are handed over this often
+#define SBS_MSG                 "MSG"               // the only message type carrying data
+constexpr int SBS_TRANSM_TYPE   = 1;                // transmission type 1..8
+constexpr int SBS_HEX_IDENT     = 4;                // transponder icao
+constexpr int SBS_CALL          = 10;               // callsign
+constexpr int SBS_ALT           = 11;               // altitude [ft]
+constexpr int SBS_SPD           = 12;               // ground speed [kn]
+constexpr int SBS_TRACK         = 13;               // track
+constexpr int SBS_LAT           = 14;               // latitude
+constexpr int SBS_LON           = 15;               // longitude
+constexpr int SBS_VSI           = 16;               // vertical rate [ft/min]
+constexpr int SBS_SQUAWK        = 17;               // squawk
+constexpr int SBS_GND           = 21;               // is on ground (-1 = true)
+
+//MARK: Replay of recorded raw data
+#define REPLAY_NAME             "Replay of Recorded Data"
+#define REPLAY_PATH             PATH_RAW_CAPTURE    // binary capture written by the raw data recorder
+#define REPLAY_PATH_2           PATH_DEBUG_RAW_FD   // fallback: text log of older versions
+constexpr size_t REPLAY_LN_CHUNK = 4096;            // read text captures in chunks of this size
+#define REPLAY_NOT_FOUND        "Replay capture file doesn't exist or can't be opened: %s"
+#define REPLAY_STARTING         "Replaying %s (%s)"
+#define REPLAY_FINISHED         "Replay finished after %ld responses"
+#define REPLAY_ERR_FORMAT       "Replay capture %s is damaged, stopped after %ld responses"
+#define REPLAY_SPEED_AFAP       "as fast as possible"
+#define REPLAY_SPEED_X          "%dx speed"
+
+//MARK: Synthetic traffic
+#define SYNTH_NAME              "Synthetic Traffic"
+#define SYNTH_DENSITY_PATH      "Resources/SynthDensity.txt"   // optional density map, relative to plugin dir
+constexpr double SYNTH_STEP         = 1.0;      // [s] simulation step
+constexpr double SYNTH_REPORT_INTVL = 10.0;     // [s] average time between two reports of a flight
+constexpr double SYNTH_RWY_LEN      = 3000.0;   // [m] runway length
+constexpr double SYNTH_AP_SPREAD    = 0.5;      // airports lie within this share of their area's radius
+constexpr int    SYNTH_DEFAULT_NUM_AP = 3;      // airports around the view position if there is no density map
+constexpr double SYNTH_GATE_DIST_MIN = 400.0;   // [m] min distance of gates from the runway
+constexpr double SYNTH_GATE_DIST_MAX = 1500.0;  // [m] max distance of gates from the runway
+constexpr double SYNTH_MIN_LEG      = 15000.0;  // [m] min distance between origin and cruise waypoint
+constexpr double SYNTH_WP_REACHED   = 3000.0;   // [m] waypoint considered passed when that close
+constexpr double SYNTH_FAF_DIST     = 10.0 * M_per_NM;  // [m] final approach fix before the threshold
+constexpr double SYNTH_FAF_HEIGHT   = 3000.0 * M_per_FT;// [m] height of the final approach fix
+constexpr double SYNTH_FAF_REACHED  = 2500.0;   // [m] approach starts when that close to the fix
+constexpr double SYNTH_GLIDE_SLOPE  = 3.0;      // [°] glide slope, also used for planning descends
+constexpr double SYNTH_TURN_RATE    = 3.0;      // [°/s] standard rate turn in flight
+constexpr double SYNTH_ACCEL_GND    = 2.0;      // [m/s²] acceleration during take-off roll
+constexpr double SYNTH_ACCEL_AIR    = 0.8;      // [m/s²] acceleration/deceleration in flight
+constexpr double SYNTH_ARRIVED      = 30.0;     // [m] gate/runway reached when taxiing that close
+constexpr double SYNTH_TAXI_FACTOR  = 0.4;      // taxi speed: share of MAX_TAXI_SPEED
+constexpr double SYNTH_LOF_FACTOR   = 0.9;      // lift-off speed: share of SPEED_INIT_CLIMB
+constexpr double SYNTH_APPR_FACTOR  = 0.7;      // final approach speed: share of FLAPS_DOWN_SPEED
+constexpr double SYNTH_CRUISE_FACTOR = 2.5;     // cruise speed: multiple of FLAPS_UP_SPEED...
+constexpr double SYNTH_CRUISE_FACTOR_LOW = 1.3; // ...for models cruising below SYNTH_SPD_LIM_ALT
+constexpr double SYNTH_SPD_LIM      = 250.0;    // [kt] speed limit...
+constexpr double SYNTH_SPD_LIM_ALT  = 10000.0;  // [ft] ...below this altitude
+constexpr double SYNTH_VSI_DESCEND  = -2000.0;  // [ft/min] steepest descend
+constexpr double SYNTH_ALT_MAX      = 41000.0;  // [ft] highest cruise altitude
+constexpr double SYNTH_ALT_MIN_AGL  = 2000.0;   // [ft] lowest cruise height
+// initial mix of flights, the remainder is in cruise
+constexpr double SYNTH_SHARE_TAXI   = 0.15;
+constexpr double SYNTH_SHARE_TAKE_OFF = 0.05;
+constexpr double SYNTH_SHARE_CLIMB  = 0.10;
+constexpr double SYNTH_SHARE_APPROACH = 0.15;
+// imperfections of the reports
+constexpr double SYNTH_NOISE_POS    = 8.0;      // [m] standard deviation of horizontal position
+constexpr double SYNTH_NOISE_ALT    = 25.0;     // [ft] standard deviation of altitude (airborne only)
+constexpr double SYNTH_NOISE_SPD    = 2.0;      // [kt] standard deviation of speed
+constexpr double SYNTH_NOISE_HDG    = 1.0;      // [°] standard deviation of heading
+constexpr double SYNTH_P_DUPLICATE  = 0.03;     // probability of a report being sent twice
+constexpr double SYNTH_P_LATE       = 0.03;     // probability of a report arriving late (out of order)
+constexpr double SYNTH_P_DROP       = 0.02;     // probability of a report being lost
+constexpr uint32_t SYNTH_ICAO_BASE  = 0xF00000; // synthetic transponder codes start here
+#define SYNTH_STARTING          "Synthetic traffic: %d flights at %d airports, seed %d"
+#define SYNTH_DENSITY_READ      "Synthetic traffic: Density map %s with %d areas"
+#define ERR_SYNTH_DENSITY_LN    "Synthetic traffic: Density map %s, line %d ignored: %s"
+
 //MARK: Debug Texts
 #define DBG_MENU_CREATED        "Menu created"
 #define DBG_WND_CREATED_UNTIL   "Created window, display until total running time %.2f, for text: %s"
@@ -330,6 +454,11 @@ constexpr int ADSBEX_HIST_MAX_ERR_CNT = 5;              // after that many error
 #define DBG_RAW_FD_START        "DEBUG Starting to log raw flight data to %s"
 #define DBG_RAW_FD_STOP         "DEBUG Stopped logging raw flight data to %s"
 #define DBG_RAW_FD_ERR_OPEN_OUT "DEBUG Could not open output file %s: %s"
+#define DBG_RAW_FD_ERR_WRITE    "DEBUG Could not write to %s: %s"
+#define DBG_RAW_FD_DROPPED      "DEBUG Raw flight data recorder fell behind, %ld records dropped"
+#define DBG_ARENA_STAT          "DEBUG %s: JSON arena: %lu cycles, %lu allocations (%lu given back), peak %lu bytes/cycle, %lu bytes in %lu chunks"
+#define DBG_TRACE_WRITTEN       "DEBUG Position trace with %u events written to %s"
+#define DBG_TRACE_ERR_OPEN_OUT  "DEBUG Could not open position trace file %s: %s"
 #define DBG_FILTER_AC           "DEBUG Filtering for a/c '%s'"
 #define DBG_FILTER_AC_REMOVED   "DEBUG Filtering for a/c REMOVED"
 #define DBG_MERGED_POS          "DEBUG MERGED POS %s into updated TS %.1f"
@@ -59,8 +59,10 @@ vectorTy CoordVectorBetween (const positionTy& from, const positionTy& to );
 positionTy CoordPlusVector (const positionTy& pos, const vectorTy& vec);
 
 // returns terrain altitude at given position
+// (from terrain cache if available and bUseCache)
 // returns NaN in case of failure
-double YProbe_at_m (const positionTy& posAt, XPLMProbeRef& probeRef);
+double YProbe_at_m (const positionTy& posAt, XPLMProbeRef& probeRef,
+                    bool bUseCache = true);
 
 //
 //MARK: Data Structures
@@ -207,6 +209,30 @@ public:
 
 typedef std::deque<positionTy> dequePositionTy;
 
+// A precomputed great-circle path from one position to another.
+// Set up once per from/to pair (expensive part: unit vectors on the sphere),
+// then each At() call is just one sin/cos pair plus asin/atan2 and
+// a few multiply-adds, no allocation.
+// lat/lon follow the great circle, all other values (alt, ts, roll...)
+// are interpolated linearly. f = 0.0 is 'from', f = 1.0 is 'to',
+// values outside [0;1] extrapolate along the same circle.
+struct greatCircleSegTy {
+protected:
+    double a[3] = {0,0,0};              // unit vector of 'from' (ECEF, on the unit sphere)
+    double c[3] = {0,0,0};              // unit tangent vector at 'from' pointing towards 'to'
+    double omega = 0;                   // central angle between 'from' and 'to' [rad]
+    double v0[positionTy::ROLL+1];      // 'from' values
+    double dv[positionTy::ROLL+1];      // 'to' minus 'from' values
+    bool bLinear = true;                // (nearly) degenerated segment: interpolate lat/lon linearly
+    bool bValid = false;
+public:
+    void Init (const positionTy& from, const positionTy& to);
+    inline void Clear () { bValid = false; }
+    inline bool IsValid () const { return bValid; }
+    // writes the position at factor f into pos (pos.v must be fully sized)
+    void At (double f, positionTy& pos) const;
+};
+
 // stringify all elements of a list for debugging purposes
 std::string positionDeque2String (const dequePositionTy& l);
 
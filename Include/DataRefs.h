@@ -95,6 +95,7 @@ enum dataRefsXP {
     DR_LOCAL_DATE_DAYS,
     DR_USE_SYSTEM_TIME,
     DR_ZULU_TIME_SEC,
+    DR_FRAME_RATE_PERIOD,
     CNT_DATAREFS_XP                     // always last, number of elements
 };
 
@@ -139,19 +140,40 @@ enum dataRefsLT {
     DR_CFG_FD_REFRESH_INTVL,
     DR_CFG_FD_BUF_PERIOD,
     DR_CFG_AC_OUTDATED_INTVL,
+    DR_CFG_LOD_MID_DISTANCE,
+    DR_CFG_LOD_FAR_DISTANCE,
+    DR_CFG_LOD_MID_INTVL,
+    DR_CFG_LOD_FAR_INTVL,
+    DR_CFG_PROBE_BUDGET,
+    DR_CFG_GOV_TARGET_FPS,
+    DR_CFG_REPLAY_SPEED,
+    DR_CFG_SYNTH_NUM_AC,
+    DR_CFG_SYNTH_SEED,
     DR_CHANNEL_ADSB_EXCHANGE_ONLINE,
     DR_CHANNEL_ADSB_EXCHANGE_HISTORIC,
     DR_CHANNEL_OPEN_SKY_ONLINE,
     DR_CHANNEL_OPEN_SKY_AC_MASTERDATA,
     DR_CHANNEL_FUTUREDATACHN_ONLINE,
+    DR_CHANNEL_REPLAY,
+    DR_CHANNEL_SBS_TCP,
+    DR_CHANNEL_ADSB_EXCHANGE_STREAM,
+    DR_CHANNEL_SYNTHETIC,
     DR_DBG_AC_FILTER,
     DR_DBG_AC_POS,
     DR_DBG_LOG_RAW_FD,
     DR_DBG_MODEL_MATCHING,
+    DR_DBG_TERRAIN_CACHE_HIT_RATE,
+    DR_DBG_FRAME_COST,
+    DR_DBG_DEFERRED_CREATE_AC,
+    DR_DBG_DEFERRED_LABELS,
+    DR_DBG_DEFERRED_PROBES,
+    DR_DBG_DEFERRED_AC_MAINT,
+    DR_DBG_LOG_DROPPED,
+    DR_DBG_TRACE_FLUSH,
     CNT_DATAREFS_LT                     // always last, number of elements
 };
 
-const int CNT_DR_CHANNELS = 5;          // number of flight data channels
+const int CNT_DR_CHANNELS = 9;          // number of flight data channels
 const int DR_CHANNEL_FIRST = DR_CHANNEL_ADSB_EXCHANGE_ONLINE;
 
 class DataRefs
@@ -272,7 +294,7 @@ protected:
     int bShowingAircrafts       = false;
     unsigned uDebugAcFilter     = 0;    // icao24 for a/c filter
     int bDebugAcPos             = false;// output debug info on position calc into log file?
-    int bDebugLogRawFd          = false;// log raw flight data to LTRawFD.log
+    int bDebugLogRawFd          = false;// record raw flight data to LTRawFD.ltc.gz
     int bDebugModelMatching     = false;// output debug info on model matching in xplanemp?
     std::string XPSystemPath;
     std::string LTPluginPath;           // path to plugin directory
@@ -281,6 +303,7 @@ protected:
     int bChannel[CNT_DR_CHANNELS];     // is channel enabled?
     int iTodaysDayOfYear        = 0;
     time_t tStartThisYear = 0, tStartPrevYear = 0;
+    std::atomic<double> simTimeStepped { NAN };   // sim time set by a headless driver (NAN: follow the clock)
     
     // generic config values
     int bAutoStart              = true; // shall display a/c right after startup?
@@ -289,17 +312,30 @@ protected:
     bool bLabelColDynamic  = false;     // dynamic label color?
     int labelColor      = COLOR_YELLOW; // label color, by default yellow
     int maxNumAc        = 50;           // how many aircrafts to create at most?
+    int maxNumAcLimit   = MAX_NUM_AC;   // upper limit of maxNumAc (raised by headless drivers only)
+    bool bSaveConfig    = true;         // SaveConfigFile writes the config file? (not for headless drivers)
     int maxFullNumAc    = 50;           // how many of these to draw in full (as opposed to 'lights only')?
     int fullDistance    = 5;            // kilometer: Farther away a/c is drawn 'lights only'
     int fdStdDistance   = 25;           // kilometer to look for a/c around myself
     int fdRefreshIntvl  = 20;           // how often to fetch new flight data
     int fdBufPeriod     = 90;           // seconds to buffer before simulating aircrafts
     int acOutdatedIntvl = 50;           // a/c considered outdated if latest flight data more older than this compare to 'now'
+    int lodMidDistance  = 3;            // kilometer: Farther away a/c is fully calculated only every lodMidIntvl-th frame
+    int lodFarDistance  = 15;           // kilometer: Farther away a/c is fully calculated only every lodFarIntvl-th frame
+    int lodMidIntvl     = 2;            // frames between full calculations of mid-distance a/c
+    int lodFarIntvl     = 8;            // frames between full calculations of far-distance a/c
+    int probeBudget     = 20;           // max number of terrain probes per frame
+    int govTargetFps    = 20;           // below this frame rate deferrable work is limited (0 = off)
+    int replaySpeed     = 1;            // replay channel: 1 = real time, n = n times faster, 0 = as fast as possible
+    int synthNumAc      = 1000;         // synthetic channel: number of simultaneous flights
+    int synthSeed       = 1;            // synthetic channel: seed of the random generator
 
     vecCSLPaths vCSLPaths;              // list of paths to search for CSL packages
     
     std::string sDefaultAcIcaoType  = CSL_DEFAULT_ICAO_TYPE;
     std::string sDefaultCarIcaoType = CSL_CAR_ICAO_TYPE;
+    std::string sSbsHost            = SBS_HOST_DEFAULT;     // host:port of the SBS-1 feed
+    std::string sAdsbexStreamHost   = ADSBEX_STREAM_HOST_DEFAULT;   // host:port of the ADS-B Exchange stream
     
     int renopt_HDR_antial = 0;          // value from X-Plane.prf describing configured HDR antialiasing
     
@@ -329,6 +365,7 @@ public:
     inline int   GetLocalDateDays() const       { return XPLMGetDatai(adrXP[DR_LOCAL_DATE_DAYS]); }
     inline bool  GetUseSystemTime() const       { return XPLMGetDatai(adrXP[DR_USE_SYSTEM_TIME]) != 0; }
     inline float GetZuluTimeSec() const         { return XPLMGetDataf(adrXP[DR_ZULU_TIME_SEC]); }
+    inline float GetFrameRatePeriod() const     { return XPLMGetDataf(adrXP[DR_FRAME_RATE_PERIOD]); }
     
     inline void SetLocalDateDays(int days)      { XPLMSetDatai(adrXP[DR_LOCAL_DATE_DAYS], days); }
     inline void SetUseSystemTime(bool bSys)     { XPLMSetDatai(adrXP[DR_USE_SYSTEM_TIME], (int)bSys); }
@@ -352,6 +389,8 @@ public:
     // seconds since epoch including fractionals
     double GetSimTime() const;
     std::string GetSimTimeString() const;
+    // headless drivers step sim time themselves (NAN: back to the clock)
+    inline void SetSimTimeStepped (double t) { simTimeStepped = t; }
     
     // livetraffic/sim/date and .../time
     static void LTSetSimDateTime(void* p, int i);
@@ -382,6 +421,8 @@ public:
     inline int GetLabelColor() const { return labelColor; }
     void GetLabelColor (float outColor[4]) const;
     inline int GetMaxNumAc() const { return maxNumAc; }
+    inline void SetMaxNumAcLimit (int lim) { maxNumAcLimit = lim; }
+    inline void SetSaveConfig (bool b) { bSaveConfig = b; }
     inline int GetMaxFullNumAc() const { return maxFullNumAc; }
     inline int GetFullDistance_km() const { return fullDistance; }
     inline double GetFullDistance_nm() const { return fullDistance * double(M_per_KM) / double(M_per_NM); }
@@ -390,6 +431,15 @@ public:
     inline int GetFdRefreshIntvl() const { return fdRefreshIntvl; }
     inline int GetFdBufPeriod() const { return fdBufPeriod; }
     inline int GetAcOutdatedIntvl() const { return acOutdatedIntvl; }
+    inline int GetLODMidDistance_m() const { return lodMidDistance * M_per_KM; }
+    inline int GetLODFarDistance_m() const { return lodFarDistance * M_per_KM; }
+    inline int GetLODMidIntvl() const { return lodMidIntvl; }
+    inline int GetLODFarIntvl() const { return lodFarIntvl; }
+    inline int GetProbeBudget() const { return probeBudget; }
+    inline int GetGovTargetFPS() const { return govTargetFps; }
+    inline int GetReplaySpeed() const { return replaySpeed; }
+    inline int GetSynthNumAc() const { return synthNumAc; }
+    inline int GetSynthSeed() const { return synthSeed; }
     
     const vecCSLPaths& GetCSLPaths() const { return vCSLPaths; }
     vecCSLPaths& GetCSLPaths()             { return vCSLPaths; }
@@ -399,6 +449,10 @@ public:
     std::string GetDefaultCarIcaoType() const { return sDefaultCarIcaoType; }
     bool SetDefaultAcIcaoType(const std::string type);
     bool SetDefaultCarIcaoType(const std::string type);
+    std::string GetSbsHost() const { return sSbsHost; }
+    bool SetSbsHost(const std::string host);
+    std::string GetAdsbexStreamHost() const { return sAdsbexStreamHost; }
+    bool SetAdsbexStreamHost(const std::string host);
     
     inline int GetRenOptHdrAntial() const { return renopt_HDR_antial; }
 
@@ -424,6 +478,20 @@ public:
     // livetraffic/dbg/model_matching: Debug Model Matching (by XPMP API)
     inline bool GetDebugModelMatching() const   { return bDebugModelMatching; }
     
+    // livetraffic/dbg/terrain_cache_hit_rate: percentage of terrain altitudes served from cache
+    static float LTGetTerrainCacheHitRate(void*);
+    
+    // livetraffic/dbg/frame_cost_us, .../deferred_*: frame-time governor statistics
+    static float LTGetFrameCost(void*);
+    static int LTGetGovDeferred(void* p);
+    
+    // livetraffic/dbg/log_dropped: log lines dropped because the log buffer was full
+    static int LTGetLogDropped(void*);
+    
+    // livetraffic/dbg/trace_flush: setting it writes the position pipeline trace to file
+    static int LTGetTraceFlush(void*) { return 0; }
+    static void LTSetTraceFlush(void*, int i);
+    
     // Number of aircrafts
     inline int GetNumAircrafts() const          { return cntAc; }
     inline int IncNumAircrafts()                { return ++cntAc; }
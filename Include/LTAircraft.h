@@ -129,6 +129,38 @@ public:
     inline double getTargetDeltaDist() const    { return targetDeltaDist; }
 };
 
+//
+//MARK: acFrameDataTy
+//      Results of the per-frame update of all aircraft, kept in
+//      contiguous arrays (structure of arrays), one entry per aircraft.
+//      Filled once per cycle by LTAircraft::UpdateAll,
+//      the XPMP callbacks then only copy out of here.
+//      Only to be accessed from X-Plane's main thread!
+//
+class LTAircraft;
+struct acFrameDataTy {
+    std::vector<LTAircraft*>    vAc;            // the aircraft (index is LTAircraft::frameIdx)
+    std::vector<double>         vLat, vLon, vAlt_ft;
+    std::vector<float>          vPitch, vRoll, vHeading;
+    std::vector<float>          vGear, vFlaps;
+    std::vector<XPMPPlaneCallbackResult> vPosRes;   // result of this cycle's position calculation
+    int                         cycle = -1;     // cycle of last batch update
+    
+    inline size_t size() const { return vAc.size(); }
+    // adds an aircraft, returns its index
+    size_t Add (LTAircraft* pAc);
+    // removes an aircraft, last one is moved into its place (and re-indexed)
+    void Remove (size_t idx);
+    // stores a frame's results
+    void Set (size_t idx, const positionTy& pos,
+              double gear, double flaps,
+              XPMPPlaneCallbackResult posRes);
+    // copies a position out in XPMP's format
+    void Get (size_t idx, XPMPPlanePosition_t& pos) const;
+};
+
+extern acFrameDataTy acFrameData;
+
 //
 //MARK: LTAircraft
 //      Represents an aircrafts as displayed in XP by use of the
@@ -136,6 +168,7 @@ public:
 //
 class LTAircraft : XPCAircraft
 {
+    friend struct acFrameDataTy;
 public:
     class FlightModel {
     public:
@@ -224,6 +257,8 @@ protected:
     positionTy          ppos;
     // and this the current vector from 'from' to 'to'
     vectorTy            vec;
+    // precomputed great-circle path from 'from' to 'to' for per-frame ppos
+    greatCircleSegTy    segFromTo;
     
     // timestamp we last requested new positions from flight data
     double              tsLastCalcRequested;
@@ -242,7 +277,6 @@ protected:
     MovingParam         pitch;
     
     // Y-Probe
-    XPLMProbeRef        probeRef;
     double              probeNextTs;    // timestamp of NEXT probe
     double              terrainAlt;     // in feet
     
@@ -251,6 +285,18 @@ protected:
     
     // object valid? (set to false after exceptions)
     bool                bValid;
+    
+    // index into acFrameData
+    size_t              frameIdx;
+    // prepared for this frame's calculation (see CalcFramePrepare)
+    bool                bFrameCalcDue;
+    // level of detail: full calculation only every lodIntvl-th cycle,
+    // linear extrapolation from lodPos in between (see LODUpdate)
+    bool                bFrameExtrapolate;  // this frame: extrapolate only
+    int                 lodIntvl;       // cycles between full calculations
+    int                 lodNextCycle;   // cycle of next full calculation
+    positionTy          lodPos;         // ppos at last full calculation
+    double              lodRate[positionTy::ALT+1]; // lat/lon/alt change per second
 public:
     LTAircraft(LTFlightData& fd);
     virtual ~LTAircraft();
@@ -297,13 +343,34 @@ public:
     // object valid? (set to false after exceptions)
     inline bool IsValid() const { return bValid; }
     void SetInvalid() { bValid = false; }
+    
+    // per-frame batch update of all aircraft (main thread, once per cycle)
+    static void UpdateAll ();
+    // worker threads for the parallel part of the per-frame update
+    static void StartCalcWorkers ();
+    static void StopCalcWorkers ();
 
 protected:
+    // parallel phase of the per-frame update: calc chunks of aircraft till done
+    static void CalcFrameChunks ();
+    static void CalcWorkerMain ();
+    // main thread part of the frame calculation: fetch positions, probe terrain
+    void CalcFramePrepare ();
+    // thread-safe part: calculate this frame's values and store them in acFrameData
+    void CalcFrameCompute ();
+    // level of detail: after a full calculation determine next one and extrapolation rates
+    void LODUpdate ();
+    // level of detail: cheap linear extrapolation of ppos between full calculations
+    void LODExtrapolate ();
+    // main thread part of CalcPPos: fetch new positions from flight data if needed
+    bool FetchPositions ();
     // based on current sim time and posList calculate the present position
-    bool CalcPPos ();
+    // (if not bMainThread then FetchPositions and YProbe must have been called before)
+    bool CalcPPos (bool bMainThread = true);
     // determine other parameters like gear, flap, roll etc. based on flight model assumptions
     void CalcFlightModel (const positionTy& from, const positionTy& to);
-    bool YProbe ();
+    bool YProbe (bool bSync);
+    void YProbeDelivered (double terrainAlt_m);
 
     // XPMP Aircraft Updates (callbacks)
     virtual XPMPPlaneCallbackResult GetPlanePosition(XPMPPlanePosition_t* outPosition);
@@ -0,0 +1,105 @@
+//
+//  LTArena.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LTArena_h
+#define LTArena_h
+
+#include <vector>
+
+//
+//MARK: Arena allocator for parson
+//      parson does one malloc per value, object, and string, and
+//      json_value_free gives them back one by one. With ArenaInit()
+//      all of parson's allocations go through ArenaMalloc/ArenaFree:
+//      While an LTArenaScope is active on a thread, allocations are
+//      served from that scope's arena by bumping a pointer, frees are
+//      no-ops, and the end of the scope resets the arena in O(1).
+//      Outside of any scope plain malloc/free is used.
+//      Each channel owns its arena (LTChannel::jsonArena), so channels
+//      running on different threads never share one.
+//      JSON values allocated in a scope must not outlive it!
+//
+
+// allocation statistics
+struct arenaStatTy {
+    unsigned long   nCycles     = 0;    // number of scopes ended (resets)
+    unsigned long   nAlloc      = 0;    // allocations served
+    unsigned long   nGiveBack   = 0;    // frees of the latest allocation, taken back right away
+    unsigned long   nChunks     = 0;    // chunks held
+    size_t          bytesPeak   = 0;    // most bytes used in one cycle
+    size_t          capacity    = 0;    // bytes held in chunks
+};
+
+class LTArena
+{
+protected:
+    struct chunkTy {
+        char*   pMem;
+        size_t  size;
+    };
+    std::vector<chunkTy> vChunks;       // kept across resets, freed in destructor
+    size_t  currChunk   = 0;            // chunk currently being filled
+    size_t  currPos     = 0;            // fill level of current chunk
+    void*   pLast       = nullptr;      // latest allocation...
+    size_t  lastPos     = 0;            // ...and where it started
+    size_t  bytesCycle  = 0;            // bytes used in this cycle
+    arenaStatTy stat;
+    
+public:
+    LTArena () {}
+    ~LTArena ();
+    
+    // no copying, no moving
+    LTArena(const LTArena&) = delete;
+    LTArena& operator=(const LTArena&) = delete;
+    
+    void* Alloc (size_t size);
+    // true if p is ours (then it's a no-op), false if it needs a real free
+    bool Free (void* p);
+    // forget all allocations, keeps the chunks
+    void Reset ();
+    
+    const arenaStatTy& GetStat () const { return stat; }
+    
+protected:
+    bool Owns (const void* p) const;
+};
+
+// makes 'arena' the allocator for parson on this thread until destroyed,
+// then resets it
+class LTArenaScope
+{
+protected:
+    LTArena& arena;
+    LTArena* pPrevArena;                // scopes can nest
+public:
+    LTArenaScope (LTArena& a);
+    ~LTArenaScope ();
+};
+
+// registers ArenaMalloc/ArenaFree with parson
+void ArenaInit ();
+
+#endif /* LTArena_h */
@@ -30,6 +30,7 @@
 #include <fstream>
 #include <list>
 #include "curl/curl.h"              // for CURL*
+#include "zlib.h"                   // for gzFile
 #include "parson.h"                 // for JSON parsing
 
 // MARK: Generic types
@@ -43,6 +44,9 @@ extern std::mutex  FDThreadSynchMutex;         // supports wake-up and stop sync
 extern std::condition_variable FDThreadSynchCV;
 // stop all threads?
 extern volatile bool bFDMainStop;
+// headless drivers: no threads, the driver calls LTFlightDataSelectAcCycle
+// and LTFlightData::CalcNextPosPending itself (set before showing aircraft)
+extern bool bFDSynchronous;
 
 //
 //MARK: Flight Data Connection (abstract base class)
@@ -51,6 +55,7 @@ class LTChannel
 {
 protected:
     dataRefsLT channel;             // id of channel (see dataRef)
+    LTArena jsonArena;              // parson allocates from here within an LTArenaScope
 
 private:
     bool bValid;                    // valid connection?
@@ -76,6 +81,8 @@ public:
 public:
     virtual bool FetchAllData (const positionTy& pos) = 0;
     virtual bool ProcessFetchedData (mapLTFlightDataTy& fd) = 0;
+    // stops any activity of the channel's own (called when hiding aircraft)
+    virtual void Stop () {}
 };
 
 // Collection of smart pointers requires C++ 17 to compile correctly!
@@ -149,12 +156,16 @@ class LTOnlineChannel : virtual public LTChannel
 protected:
     CURL* pCurl;                    // handle into CURL
     char* netData;                  // where the response goes
+    std::shared_ptr<char> netDataRec;   // netData while shared with the raw data recorder
     size_t netDataPos;              // current write pos into netData
     size_t netDataSize;             // current size of netData
     char curl_errtxt[CURL_ERROR_SIZE];    // where error text goes
     long httpResponse;              // last HTTP response code
-    
-    static std::ofstream outRaw;    // output file for raw logging
+    // mapping of timestamps of received positions (replay only):
+    // ts' = tsReplayBase + (ts - tsCapBase) / tsSpeed
+    double tsCapBase;
+    double tsReplayBase;
+    double tsSpeed;
     
 public:
     LTOnlineChannel ();
@@ -165,13 +176,21 @@ protected:
     void CleanupCurl ();
     // CURL callback
     static size_t ReceiveData ( const char *ptr, size_t size, size_t nmemb, void *userdata );
-    // logs raw data to a text file
-    void DebugLogRaw (const char* data);
+    // maps a received timestamp (identity unless replaying)
+    inline double MapTs (double ts) const
+    { return tsReplayBase + (ts - tsCapBase) / tsSpeed; }
+    // hands the response buffer over to the raw data recorder
+    void RecordRawResponse ();
     
 public:
     virtual bool FetchAllData (const positionTy& pos);
     virtual std::string GetURL (const positionTy& pos) = 0;
     virtual bool IsLiveFeed () const    { return true; }
+    // processes recorded data as if it had just been received,
+    // timestamps mapped from capture time capBase to replayBase at given speed
+    bool ProcessRecordedData (const std::string& data, long httpStatus,
+                              double capBase, double replayBase, double speed,
+                              mapLTFlightDataTy& fdMap);
 };
 
 //
@@ -189,11 +208,52 @@ public:
     virtual bool IsLiveFeed () const    {return false;}
 };
 
+//
+//MARK: LTStreamChannel
+//       Keeps a TCP connection open and processes data as it arrives,
+//       in a thread of its own. The regular network thread only makes
+//       sure the stream thread runs.
+//
+class LTStreamChannel : virtual public LTChannel
+{
+protected:
+    CURL* pCurl;                    // connect-only CURL handle
+    char curl_errtxt[CURL_ERROR_SIZE];  // where error text goes
+    std::string streamHost;         // host:port connected to
+    std::string streamBuf;          // received but not yet processed data
+    std::thread thrStream;          // the receiving thread
+    volatile bool bStopStream;      // stream thread to stop?
+    std::atomic<bool> bStreamRunning;   // stream thread running?
+    std::mutex posViewMutex;        // guards posView
+    positionTy posView;             // last known view position
+    
+public:
+    LTStreamChannel ();
+    virtual ~LTStreamChannel ();
+    virtual bool IsLiveFeed () const    { return true; }
+    virtual bool FetchAllData (const positionTy& pos);
+    virtual bool ProcessFetchedData (mapLTFlightDataTy&) { return true; }
+    virtual void Stop ();
+    
+protected:
+    virtual std::string GetStreamHost () const = 0;     // host:port to connect to
+    // process data received so far in 'streamBuf' (also called when idle)
+    virtual bool ProcessStreamData (mapLTFlightDataTy& fdMap) = 0;
+    // new connection: reset any parsing state
+    virtual void StreamReset () {}
+    positionTy GetViewPos ();
+    bool StreamConnect ();
+    void StreamDisconnect ();
+    void StreamMain ();             // the receiving thread
+};
+
 //
 //MARK: OpenSky
 //
 class OpenSkyConnection : public LTOnlineChannel, LTFlightDataChannel
 {
+protected:
+    vecOpenSkyStateTy vStates;          // decoded states, reused between requests
 public:
     OpenSkyConnection () :
     LTChannel(DR_CHANNEL_OPEN_SKY_ONLINE),
@@ -221,6 +281,51 @@ public:
     virtual bool FetchAllData(const positionTy& pos) { return LTOnlineChannel::FetchAllData(pos); }
 };
 
+//
+//MARK: ADS-B Exchange Stream
+//       Reads the streaming feed (concatenated JSON objects, each an
+//       'acList' with just the fields that changed) and applies the
+//       changes to the flight data.
+//
+class ADSBExchangeStream : public LTStreamChannel, LTFlightDataChannel
+{
+protected:
+    // last known dynamic values of an aircraft
+    struct StreamAcTy {
+        double lat      = NAN;
+        double lon      = NAN;
+        double alt_ft   = NAN;
+        double trk      = NAN;
+        double spd      = 0.0;
+        double vsi      = 0.0;
+        double inHg     = 0.0;
+        long squawk     = 0;
+        bool gnd        = false;
+        double lastMsg  = 0.0;      // when the last change was received
+    };
+    std::map<std::string,StreamAcTy> mapStreamAc;
+    // incremental scanning of streamBuf for complete objects
+    size_t scanPos      = 0;        // next char to look at
+    size_t objStart     = 0;        // start of the current object
+    int scanDepth       = 0;        // nesting depth of braces
+    bool bScanInStr     = false;    // inside a string?
+    bool bScanEsc       = false;    // after a backslash inside a string?
+    
+public:
+    ADSBExchangeStream () :
+    LTChannel(DR_CHANNEL_ADSB_EXCHANGE_STREAM),
+    LTStreamChannel(),
+    LTFlightDataChannel()  { SetValid(true); }
+    
+protected:
+    virtual std::string GetStreamHost () const;
+    virtual bool ProcessStreamData (mapLTFlightDataTy& fdMap);
+    virtual void StreamReset ();
+    bool ProcessObject (mapLTFlightDataTy& fdMap, const char* sObj, double now);
+    void ProcessAc (mapLTFlightDataTy& fdMap, const JSON_Object* pJAc,
+                    const positionTy& viewPos, double now);
+};
+
 //
 //MARK: ADS-B Exchange Historical Data
 //
@@ -243,6 +348,116 @@ public:
     virtual bool ProcessFetchedData (mapLTFlightDataTy& fdMap);
 };
 
+//
+//MARK: SBS-1 BaseStation
+//       Reads the BaseStation CSV stream of a local receiver (e.g. dump1090
+//       on port 30003). Messages are merged per aircraft and handed over
+//       every SBS_FLUSH_INTVL.
+//
+class SBSConnection : public LTStreamChannel, LTFlightDataChannel
+{
+protected:
+    // what we know about an aircraft so far
+    struct SBSAcTy {
+        std::string call;
+        long squawk     = 0;
+        double alt_ft   = NAN;
+        double spd      = NAN;
+        double trk      = NAN;
+        double vsi      = NAN;
+        double lat      = NAN;
+        double lon      = NAN;
+        double posTs    = NAN;      // when the position was received
+        double lastMsg  = 0.0;      // when the last message was received
+        bool gnd        = false;
+        bool bNewPos    = false;    // position received since last hand-over?
+        bool bNewStat   = false;    // static data received since last hand-over?
+    };
+    std::map<std::string,SBSAcTy> mapSbsAc;
+    double lastFlush = 0.0;         // when were updates last handed over?
+    
+public:
+    SBSConnection () :
+    LTChannel(DR_CHANNEL_SBS_TCP),
+    LTStreamChannel(),
+    LTFlightDataChannel()  { SetValid(true); }
+    
+protected:
+    virtual std::string GetStreamHost () const;
+    virtual bool ProcessStreamData (mapLTFlightDataTy& fdMap);
+    void ProcessMsg (const std::string& ln, double now);
+    void Flush (mapLTFlightDataTy& fdMap, double now);
+};
+
+//
+//MARK: Replay of recorded raw data
+//       Reads a capture of the raw data recorder (or a text log of older
+//       versions) and feeds the recorded responses through the
+//       OpenSky and ADS-B Exchange processing, keyed to sim time:
+//       livetraffic/cfg/replay_speed 1 = real time, n = n times faster,
+//       0 = as fast as possible.
+//
+class ReplayChannel : public LTFlightDataChannel
+{
+protected:
+    std::string pathCapture;        // the capture file
+    gzFile pFile;                   // the opened capture file
+    bool bBinary;                   // binary capture? (or text log)
+    uint16_t recHeadSize;           // size of record headers in a binary capture
+    // the next record to replay
+    bool bHaveRec;                  // is there a next record read already?
+    rawRecHeadTy nextHead;
+    std::string nextData;
+    // mapping capture time to replay time
+    bool bRebase;                   // new recording session: rebase the mapping
+    double capBase;                 // [s] capture's sim time at...
+    double replayBase;              // [s] ...this sim time of the replay
+    int lastSpeed;                  // replay speed the mapping is based on
+    long cntReplayed;               // number of responses replayed
+    // the channels processing the recorded responses
+    OpenSkyConnection       opSky;
+    ADSBExchangeConnection  adsbEx;
+    
+public:
+    ReplayChannel (std::string path = REPLAY_PATH,
+                   std::string fallback = REPLAY_PATH_2);
+    virtual ~ReplayChannel ();
+    virtual bool FetchAllData (const positionTy& pos);
+    virtual bool IsLiveFeed() const { return false; }
+    virtual bool ProcessFetchedData (mapLTFlightDataTy& fdMap);
+    
+protected:
+    bool OpenCapture ();
+    void CloseCapture ();
+    bool ReadNextRec ();            // reads the next response record into nextHead/nextData
+    bool ReadLine (std::string& ln);    // text logs only
+    bool FormatError ();            // logs the error, closes the capture, returns false
+};
+
+//
+//MARK: Synthetic traffic
+//       Generates flights (see LTSynthetic.h) around the view position
+//       or as per the density map SYNTH_DENSITY_PATH and feeds their
+//       reports through the ADS-B Exchange processing:
+//       livetraffic/cfg/synth_num_ac number of flights,
+//       livetraffic/cfg/synth_seed seed of the random generator.
+//
+class SyntheticChannel : public LTFlightDataChannel
+{
+protected:
+    std::unique_ptr<SynthTraffic> pTraffic;  // created with the first fetch
+    vecSynthReportTy vRpt;          // reports generated by the last fetch...
+    std::string response;           // ...formatted as ADS-B Exchange response
+    // the channel processing the generated responses
+    ADSBExchangeConnection  adsbEx;
+    
+public:
+    SyntheticChannel ();
+    virtual bool FetchAllData (const positionTy& pos);
+    virtual bool IsLiveFeed() const { return false; }
+    virtual bool ProcessFetchedData (mapLTFlightDataTy& fdMap);
+};
+
 
 //
 //MARK: OpenSkyAcMasterdata
@@ -271,13 +486,15 @@ bool LTFlightDataInit();
 bool LTFlightDataEnable();
 bool LTFlightDataShowAircraft();
 void LTFlightDataHideAircraft();
+void LTFlightDataSelectAcCycle();       // one cycle of fetching/processing all channels
 void LTFlightDataDisable();
 void LTFlightDataStop();
 
 //
 //MARK: Aircraft Maintenance (called from flight loop callback)
 //
-void LTFlightDataAcMaintenance();
+void LTFlightDataAcMaintenance(float inElapsedSinceLastCall);
+void LTFlightDataAcMaintenanceMsgs();
 
 //
 //MARK: Parson Helper Functions
@@ -28,6 +28,7 @@
 #define LTFlightData_h
 
 #include <mutex>
+#include <atomic>
 #include <deque>
 #include "CoordCalc.h"
 
@@ -166,7 +167,24 @@ protected:
     // buffered positions / dynamic data as deque, sorted by timestamp
     // first element is oldest and current (the 'from' position/data)
     // second is pos a/c is currently headed for, and the others then further on into the future
-    dequePositionTy         posDeque, posToAdd;
+    dequePositionTy         posDeque;
+    // new positions handed over from the network threads to the main thread
+    // without lock: a preallocated ring, which overflows into qPosOverflow,
+    // each position tagged with the channel switch generation posGen
+    struct newPosTy {
+        positionTy          pos;
+        unsigned            gen = 0;
+    };
+    LTRingQueue<newPosTy,32> qPosToAdd;
+    LTMpscQueue<newPosTy>   qPosOverflow;
+    // incremented by a channel switch, voids positions of older generations
+    std::atomic<unsigned>   posGen {0};
+    // generation of the positions in posDeque/posToAdd (main thread only)
+    unsigned                posGenAppended = 0;
+    // new positions taken over from qPosToAdd, yet to analyse (main thread only)
+    dequePositionTy         posToAdd;
+    // key is in qFdWithNewPos, i.e. AppendNewPos will be called (not copied)
+    std::atomic<bool>       bQueuedNewPos {false};
     dequeFDDynDataTy        dynDataDeque;
     double                  rotateTS;
     double                  youngestTS;
@@ -178,8 +196,15 @@ protected:
     // the simulated aircraft, which is based on this flight data
     // see Create/DestroyAircraft
     LTAircraft*             pAc;
-    // Y probe reference
-    XPLMProbeRef        probeRef;
+    // terrain altitudes [m] delivered by the terrain probe service, by position timestamp
+    std::map<double,double> mapTerrainAlt;
+    // the channel currently feeding us and its latest accepted timestamp,
+    // maintained by AddDynData, consulted by IsRedundantUpdate
+    struct FDOwnerTy {
+        dataRefsLT  ch      = DR_CHANNEL_ADSB_EXCHANGE_ONLINE;
+        double      ts      = NAN;
+        uint32_t    chSeen  = 0;        // bit mask of channels, which got through once
+    } owner;
     
     // object valid? (will be re-set in case of exceptions)
     bool                bValid;
@@ -239,12 +264,19 @@ public:
     void DataCleansing (bool& bChanged);
     bool CalcNextPos ( double simTime );
     static void CalcNextPosMain ();
+    static void CalcNextPosPending ();  // processes all pending keys (headless drivers, see bFDSynchronous)
     void TriggerCalcNewPos ( double simTime );
 
     // new pos read from data stream to be stored
-    void AddNewPos ( positionTy& pos ); // called from network thread, no terrain calc
+    void AddNewPos ( positionTy& pos ); // called from network threads, no lock, no terrain calc
+    void AddNewPosBatch (const dequePositionTy& batch); // same for a batch sorted by timestamp
     static void AppendAllNewPos();      // called from main thread, can calc terrain
     void AppendNewPos();                // called from AppendAllNewPos
+protected:
+    void QueueNewPos();                 // queues key for AppendAllNewPos unless queued already
+    void PushNewPos (const positionTy& pos);    // hands over to qPosToAdd, or qPosOverflow if full
+    void TakeOverNewPos (const newPosTy& np);   // from the queues into posToAdd (main thread)
+public:
 
     // check if thisPos would be OK after lastPos
     bool IsPosOK (const positionTy& lastPos,
@@ -264,10 +296,15 @@ public:
     // const access to posDeque
     const dequePositionTy& GetPosDeque() const { return posDeque; }
     
-    // determine Ground-status based on dynDataDeque, requires lock for access, so may fail if locked
-    bool TryDeriveGrndStatus (positionTy& pos);
-    // determine terrain alt at pos
-    double YProbe_at_m (const positionTy& pos);
+    // determine Ground-status based on terrain altitude, requires lock for access, so may fail if locked
+    // TRY_NO_DATA: terrain probe requested, call again later (bSync: probe right away, main thread only)
+    tryResult TryDeriveGrndStatus (positionTy& pos, bool bSync = false);
+protected:
+    // receives terrain altitude from the terrain probe service
+    void TerrainAltDelivered (double ts, double terrainAlt_m);
+    // calculates the next position of one key from the list of pending ones
+    static bool CalcNextPosFromList ();
+public:
     // returns vector at timestamp (which has speed, direction and the like)
     tryResult TryGetVec (double ts, vectorTy& vec) const;
     
@@ -276,6 +313,9 @@ public:
     
     // access dynamic data (other than position)
     void AddDynData ( const FDDynamicData& inDyn, int rcvr, int sig, positionTy* pos = nullptr ); // new data read from stream to be stored
+    // cross-channel duplicate suppression ahead of AddDynData (any thread, caller must not hold mapFdMutex):
+    // would AddDynData throw away this update of 'key' by 'pChannel' anyway?
+    static bool IsRedundantUpdate (const std::string& key, const LTChannel* pChannel, double ts);
     // access to current dynData, i.e. dnDataDeque[0]
     bool TryGetSafeCopy ( FDDynamicData& outDyn ) const;    // tries to get a copy, fails if lock unavailable
     FDDynamicData WaitForSafeCopyDyn(bool bFirst = true) const;  // waits for lock and returns a copy
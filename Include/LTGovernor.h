@@ -0,0 +1,62 @@
+//
+//  LTGovernor.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LTGovernor_h
+#define LTGovernor_h
+
+//
+//MARK: Frame-time governor
+//      Measures the time LiveTraffic spends in X-Plane's main thread per frame.
+//      While the sim runs below the target frame rate (DataRefs::GetGovTargetFPS)
+//      deferrable work is done only within a budget per frame, which shrinks
+//      the further the frame rate drops. Callers retry deferred work later.
+//      Only to be used from X-Plane's main thread!
+//
+
+// kinds of deferrable work
+enum govWorkTy {
+    GOV_CREATE_AC = 0,                  // aircraft creation
+    GOV_LABELS,                         // label rebuilds
+    GOV_PROBES,                         // terrain probes (cache hits are always served)
+    GOV_AC_MAINT,                       // aircraft maintenance slices
+    GOV_CNT_WORK                        // always last, number of elements
+};
+
+// measures the time spent in its scope as LiveTraffic's frame cost
+// (only the outermost of nested scopes counts)
+class GovFrameCostTy {
+public:
+    GovFrameCostTy();
+    ~GovFrameCostTy();
+};
+
+// may deferrable work be done now? If not, the deferral is counted.
+bool GovernorAllow (govWorkTy work);
+// LiveTraffic's main-thread time per frame [µs], smoothed
+float GovernorFrameCost ();
+// number of deferrals of the given kind of work so far
+int GovernorDeferred (govWorkTy work);
+
+#endif /* LTGovernor_h */
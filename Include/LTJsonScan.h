@@ -0,0 +1,186 @@
+//
+//  LTJsonScan.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LTJsonScan_h
+#define LTJsonScan_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "Constants.h"
+
+//
+//MARK: Single-pass JSON scanning
+//      Walks a JSON text front to back without building a DOM.
+//      Keys are hashed while being scanned, so field tables can
+//      dispatch on the hash instead of doing string lookups.
+//      This header is also used by Tools/LTJsonBench, so it must not
+//      depend on anything else of LiveTraffic but Constants.h.
+//
+
+// FNV-1a hash of a key, usable at compile time for field tables
+constexpr uint32_t JSON_HASH_INIT  = 2166136261u;
+constexpr uint32_t JSON_HASH_PRIME = 16777619u;
+
+constexpr uint32_t JsonHashAdd (uint32_t h, char c)
+{ return (h ^ uint8_t(c)) * JSON_HASH_PRIME; }
+
+constexpr uint32_t JsonKeyHash (const char* key)
+{
+    uint32_t h = JSON_HASH_INIT;
+    while (*key)
+        h = JsonHashAdd(h, *key++);
+    return h;
+}
+
+class JsonScanner
+{
+protected:
+    const char* p;                  // current read position
+    const char* const end;          // end of text
+    bool bErr = false;              // text malformed?
+    
+public:
+    JsonScanner (const char* json, size_t len) : p(json), end(json+len) {}
+    
+    bool IsError () const { return bErr; }
+    bool IsEnd ()         { return !SkipWs(); }
+    
+    // skips whitespace, returns false at end of text
+    bool SkipWs ();
+    // next non-whitespace char is 'c'? Consumes it only if so.
+    bool Next (char c);
+    // like Next, but sets error state if 'c' isn't there
+    bool Expect (char c);
+    
+    // reads `"key":`, returns hash and the raw key
+    bool ScanKey (uint32_t& hash, const char*& key, size_t& keyLen);
+    // after a value: returns true on ',' (more to come),
+    // false on 'close' (or error)
+    bool NextMember (char close);
+    
+    // value readers: return true and consume the value if it has the
+    // expected type, return false and leave it untouched otherwise
+    bool ReadNull ();
+    bool ReadBool (bool& b);
+    bool ReadString (std::string& s);
+    // same into a fixed buffer, truncated to bufSize-1 chars, zero-terminated
+    bool ReadString (char* buf, size_t bufSize);
+    // reads a number, also if encapsulated in a string ("2008")
+    bool ReadNumber (double& d);
+    // skips any value including nested objects/arrays
+    bool SkipValue ();
+    
+    // in the current object: skips members until 'key',
+    // positions at its value
+    bool FindKey (const char* key);
+    
+protected:
+    // decodes a string value, passing decoded pieces to append(const char*, size_t)
+    template <class AppendFn>
+    bool ReadStringPieces (AppendFn append);
+    // converts [b,e) to a number, false if there is no number at all
+    static bool ParseNumber (const char* b, const char* e, double& d);
+};
+
+//
+//MARK: ADS-B Exchange aircraft list
+//
+
+// one aircraft of the acList, fields not sent keep their defaults,
+// which match what the earlier parson-based access returned
+struct ADSBExAcTy {
+    // strings (default: empty)
+    std::string transpIcao, reg, country, acTypeIcao, man, mdl,
+                op, opIcao, call, origin, dest;
+    // numbers (default: 0 or NAN)
+    double year = 0.0, trt = 0.0, posTime = 0.0, radarCode = 0.0,
+           heading = NAN, inHg = 0.0, brng = 0.0, dst = 0.0,
+           spd = 0.0, vsi = 0.0, lat = NAN, lon = NAN, alt = NAN,
+           engType = 0.0, engMount = 0.0, rcvr = 0.0, sig = 0.0;
+    // booleans (default: false)
+    bool posStale = false, gnd = false, mil = false;
+    
+    // back to defaults, keeps string capacity
+    void Reset ();
+};
+
+// walks an ADS-B Exchange AircraftList.json response:
+// FindAcList() once, then NextAc() until it returns false
+class ADSBExDecoder : public JsonScanner
+{
+protected:
+    bool bFirstAc = true;
+    bool bListEnd = false;
+public:
+    ADSBExDecoder (const char* json, size_t len) : JsonScanner(json,len) {}
+    
+    // positions at the first aircraft of ADSBEX_AIRCRAFT_ARR
+    bool FindAcList ();
+    // decodes the next aircraft, false at end of list or on error
+    bool NextAc (ADSBExAcTy& ac);
+};
+
+//
+//MARK: OpenSky state vectors
+//
+
+constexpr size_t OPSKY_ICAO_BUF    = 8;     // icao24: 6 hex digits
+constexpr size_t OPSKY_CALL_BUF    = 12;    // callsign: 8 chars
+constexpr size_t OPSKY_COUNTRY_BUF = 64;    // origin_country
+
+// one entry of the states array, flat and without heap allocations,
+// fields not sent keep their defaults, which match what the earlier
+// parson-based access returned
+struct OpenSkyStateTy {
+    char    transpIcao[OPSKY_ICAO_BUF];
+    char    call[OPSKY_CALL_BUF];           // trailing spaces removed
+    char    country[OPSKY_COUNTRY_BUF];
+    double  posTime = 0.0, lon = NAN, lat = NAN, spd = 0.0,
+            heading = NAN, vsi = 0.0, alt = NAN, radarCode = 0.0;
+    bool    gnd = false;
+    
+    OpenSkyStateTy () { transpIcao[0] = call[0] = country[0] = 0; }
+};
+typedef std::vector<OpenSkyStateTy> vecOpenSkyStateTy;
+
+// walks an OpenSky /states/all response, picking the values
+// by their OPSKY_* position in each state array
+class OpenSkyDecoder : public JsonScanner
+{
+public:
+    OpenSkyDecoder (const char* json, size_t len) : JsonScanner(json,len) {}
+    
+    // decodes all of OPSKY_AIRCRAFT_ARR into vStates (cleared first,
+    // capacity is kept), "states":null is a valid empty result
+    bool DecodeStates (vecOpenSkyStateTy& vStates);
+protected:
+    bool DecodeState (OpenSkyStateTy& st);
+};
+
+#endif /* LTJsonScan_h */
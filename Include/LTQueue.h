@@ -0,0 +1,177 @@
+//
+//  LTQueue.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LTQueue_h
+#define LTQueue_h
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+//
+//MARK: Lock-free multi-producer/single-consumer queue
+//
+// Any number of threads can Push() without ever blocking,
+// one thread (the consumer) takes out everything at once with PopAll().
+// Internally this is a linked list with an atomic head,
+// to which producers prepend with compare-and-swap.
+// As the consumer always takes the entire list there is no ABA problem.
+template <class T>
+class LTMpscQueue
+{
+protected:
+    struct NodeTy {
+        T       val;
+        NodeTy* pNext = nullptr;
+        NodeTy (const T& v) : val(v) {}
+    };
+    std::atomic<NodeTy*> pHead;
+    
+public:
+    LTMpscQueue() : pHead(nullptr) {}
+    ~LTMpscQueue()  { std::vector<T> v; PopAll(v); }
+    
+    // no copying, no moving
+    LTMpscQueue(const LTMpscQueue&) = delete;
+    LTMpscQueue& operator=(const LTMpscQueue&) = delete;
+    
+    // any thread: add an element
+    void Push (const T& v)
+    {
+        NodeTy* pNode = new NodeTy(v);
+        pNode->pNext = pHead.load(std::memory_order_relaxed);
+        while (!pHead.compare_exchange_weak(pNode->pNext, pNode,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed))
+            ;
+    }
+    
+    // (approximately) anything in the queue?
+    bool empty() const { return pHead.load(std::memory_order_relaxed) == nullptr; }
+    
+    // consumer thread only: takes out all elements, appends them to v
+    // in the order they had been pushed, returns number of elements taken
+    size_t PopAll (std::vector<T>& v)
+    {
+        NodeTy* pNode = pHead.exchange(nullptr, std::memory_order_acquire);
+        // list is in reverse order of pushing: reverse it first
+        NodeTy* pRev = nullptr;
+        size_t n = 0;
+        while (pNode) {
+            NodeTy* pNext = pNode->pNext;
+            pNode->pNext = pRev;
+            pRev = pNode;
+            pNode = pNext;
+            n++;
+        }
+        // now move the values out and free the nodes
+        v.reserve(v.size() + n);
+        while (pRev) {
+            NodeTy* pNext = pRev->pNext;
+            v.emplace_back(std::move(pRev->val));
+            delete pRev;
+            pRev = pNext;
+        }
+        return n;
+    }
+};
+
+//
+//MARK: Lock-free bounded ring buffer
+//
+// A fixed number of preallocated slots, so Push() never allocates:
+// the slots' values are assigned to, which lets them keep their storage.
+// Any number of threads can Push() without blocking, one thread
+// (the consumer) calls Pop(). If the ring is full Push() returns false,
+// it is then up to the caller where to put the element instead.
+// Each slot carries a sequence number telling if it is free for
+// producing (== push position) or ready for consuming (== push position + 1).
+template <class T, size_t N>
+class LTRingQueue
+{
+protected:
+    struct SlotTy {
+        std::atomic<size_t> seq;
+        T                   val;
+    };
+    std::array<SlotTy,N>    aSlots;
+    std::atomic<size_t>     posPush;    // producer side: next position to push to
+    size_t                  posPop;     // consumer side: next position to pop from
+    
+public:
+    LTRingQueue() : posPush(0), posPop(0)
+    {
+        for (size_t i = 0; i < N; i++)
+            aSlots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    
+    // no copying, no moving
+    LTRingQueue(const LTRingQueue&) = delete;
+    LTRingQueue& operator=(const LTRingQueue&) = delete;
+    
+    // any thread: reserves the next slot and calls fill(T&) for it,
+    // returns false (without calling fill) if the ring is full
+    template <class FillT>
+    bool Push (FillT fill)
+    {
+        size_t pos = posPush.load(std::memory_order_relaxed);
+        for (;;) {
+            SlotTy& slot = aSlots[pos % N];
+            const size_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq == pos) {
+                // slot is free, try reserving it
+                if (posPush.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) {
+                    fill(slot.val);
+                    slot.seq.store(pos+1, std::memory_order_release);
+                    return true;
+                }
+                // (compare_exchange has updated pos)
+            }
+            else if (seq < pos)
+                return false;                   // not yet consumed: ring is full
+            else
+                pos = posPush.load(std::memory_order_relaxed);  // someone else was faster
+        }
+    }
+    
+    // consumer thread only: anything in the queue?
+    bool empty() const
+    { return aSlots[posPop % N].seq.load(std::memory_order_acquire) != posPop+1; }
+    
+    // consumer thread only: take out the first element, false if queue is empty
+    // (the value is copied, not moved, so the slot keeps its storage)
+    bool Pop (T& v)
+    {
+        SlotTy& slot = aSlots[posPop % N];
+        if (slot.seq.load(std::memory_order_acquire) != posPop+1)
+            return false;
+        v = slot.val;
+        slot.seq.store(posPop + N, std::memory_order_release);
+        posPop++;
+        return true;
+    }
+};
+
+#endif /* LTQueue_h */
@@ -0,0 +1,81 @@
+//
+//  LTRecorder.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LTRecorder_h
+#define LTRecorder_h
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+//
+//MARK: Raw flight data recorder
+//      Captures all requests and responses of the online channels
+//      while livetraffic/dbg/log_raw_fd is set.
+//      Channels hand over their response buffers without copying,
+//      a background thread compresses them and writes them to
+//      PATH_RAW_CAPTURE as a sequence of records.
+//      The file is gzip-compressed. Each recording session starts with
+//      a rawFileHeadTy, each record is a rawRecHeadTy followed by
+//      'len' bytes of data (no terminating zero).
+//
+
+// record types
+enum rawRecTypeTy : uint8_t {
+    RAW_REC_URL = 1,            // request URL sent
+    RAW_REC_RESPONSE,           // response received
+};
+
+// header of a recording session
+struct rawFileHeadTy {
+    char        magic[4];       // RAW_FILE_MAGIC
+    uint16_t    version;        // RAW_FILE_VER
+    uint16_t    recHeadSize;    // sizeof(rawRecHeadTy)
+};
+
+// header of one record
+struct rawRecHeadTy {
+    uint32_t    len;            // length of data following this header
+    uint16_t    httpStatus;     // HTTP response code (responses only)
+    uint8_t     type;           // rawRecTypeTy
+    uint8_t     chId;           // channel: dataRefsLT - DR_CHANNEL_FIRST
+    double      simTime;        // sim time when data was sent/received
+    double      wallTime;       // [s] since the epoch (system clock)
+};
+
+constexpr char RAW_FILE_MAGIC[4] = {'L','T','R','C'};
+constexpr uint16_t RAW_FILE_VER  = 1;
+
+// is recording switched on?
+bool RawRecIsActive ();
+// record a request URL (network thread)
+void RawRecUrl (dataRefsLT ch, const std::string& url);
+// record a response (network thread), takes shared ownership of the buffer
+void RawRecResponse (dataRefsLT ch, long httpStatus,
+                     const std::shared_ptr<char>& buf, size_t len);
+// write everything outstanding and stop the recorder thread
+void RawRecStop ();
+
+#endif /* LTRecorder_h */
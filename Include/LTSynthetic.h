@@ -0,0 +1,185 @@
+//
+//  LTSynthetic.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LTSynthetic_h
+#define LTSynthetic_h
+
+#include <memory>
+#include <random>
+
+//
+//MARK: Synthetic traffic
+//      Generates flights for scale testing: Taxi out, take-off, climb,
+//      cruise, descend, approach, roll-out, and taxi in between
+//      generated airports, driven by the parameters of the flight model
+//      matching each flight's aircraft type (FlightModels.prf).
+//      Reports are sent like a receiver network would: every
+//      SYNTH_REPORT_INTVL or so, with noise, and with some of them
+//      duplicated, late (out of order), or lost.
+//      Same seed, same density map, same sequence of Advance() calls:
+//      same reports (own random helpers, no std distributions,
+//      as these differ between standard libraries).
+//
+//      Used by SyntheticChannel and by the fixture writer
+//      Tools/LTSynthGen.cpp (livetraffic_synth).
+//
+
+// one area of the density map:
+// flights start and end at airports within the area,
+// its weight defines the share of all flights
+struct synthAreaTy {
+    double lat      = NAN;          // center
+    double lon      = NAN;
+    double radius   = 0.0;          // [m]
+    double weight   = 1.0;          // relative share of all flights
+    double elev     = 0.0;          // [m] elevation of the area's airports
+    int    numAp    = 1;            // number of airports in the area
+};
+typedef std::vector<synthAreaTy> vecSynthAreaTy;
+
+// reads a density map, one area per line:
+//   <lat> <lon> <radius [nm]> <weight> [<elevation [ft]> [<num airports>]]
+// '#' starts a comment; returns false if the file can't be read
+bool SynthReadDensityMap (const std::string& path, vecSynthAreaTy& vAreas);
+
+// phases of a synthetic flight
+enum synthPhaseTy {
+    SYN_TAXI_OUT = 0,
+    SYN_TAKE_OFF,
+    SYN_CLIMB,
+    SYN_CRUISE,
+    SYN_DESCEND,
+    SYN_APPROACH,
+    SYN_ROLL_OUT,
+    SYN_TAXI_IN,
+    SYN_DONE,                       // parked, to be replaced by a new flight
+    SYN_CNT_PHASES
+};
+
+// static data of a synthetic flight, shared by all its reports
+struct synthFlightStatTy {
+    std::string transpIcao, call, reg, acTypeIcao, op, opIcao, origin, dest;
+    int sqk = 0;
+};
+typedef std::shared_ptr<const synthFlightStatTy> ptrSynthFlightStatTy;
+
+// one position report as a receiver network would send it
+struct synthReportTy {
+    ptrSynthFlightStatTy pStat;
+    double ts       = NAN;          // [s] since the epoch
+    double lat      = NAN;
+    double lon      = NAN;
+    double alt_ft   = NAN;
+    double heading  = NAN;
+    double spd_kn   = NAN;
+    double vsi_ft   = NAN;          // [ft/min]
+    bool   gnd      = false;
+};
+typedef std::vector<synthReportTy> vecSynthReportTy;
+
+// formats reports as ADS-B Exchange AircraftList.json response
+void SynthWriteADSBEx (std::string& out, const vecSynthReportTy& vRpt);
+
+class SynthTraffic
+{
+public:
+    // counters of what was generated so far
+    struct statsTy {
+        long flights    = 0;        // flights started
+        long reports    = 0;        // reports sent (including duplicates)
+        long duplicates = 0;        // reports sent twice
+        long late       = 0;        // reports held back till the next Advance()
+        long dropped    = 0;        // reports lost
+    };
+    
+protected:
+    struct apTy {
+        std::string id;
+        double lat, lon;            // runway threshold
+        double elev;                // [m]
+        double rwyHdg;              // [°]
+        double fafLat, fafLon;      // final approach fix
+    };
+    
+    struct flightTy {
+        ptrSynthFlightStatTy pStat;
+        const LTAircraft::FlightModel* pMdl = nullptr;
+        synthPhaseTy phase = SYN_DONE;
+        double lat = NAN, lon = NAN;
+        double alt = 0.0;           // [m]
+        double hdg = 0.0;           // [°]
+        double spd = 0.0;           // [m/s]
+        double vsi = 0.0;           // [m/s]
+        size_t apFrom = 0, apTo = 0;
+        double tgtLat = NAN, tgtLon = NAN;  // where the current phase heads to
+        double wpLat = NAN, wpLon = NAN;    // cruise waypoint...
+        bool   bWp = false;                 // ...still to pass?
+        double cruiseAlt = 0.0;     // [m]
+        double cruiseSpd = 0.0;     // [m/s]
+        double nextRptTs = NAN;     // next report is due then
+        
+        inline bool IsOnGnd () const
+        { return phase <= SYN_TAKE_OFF || phase >= SYN_ROLL_OUT; }
+    };
+    
+    std::mt19937 rnd;               // all randomness comes from here
+    std::vector<apTy> vAp;          // all airports
+    std::vector<double> vApWeight;  // accumulated weights of the airports
+    std::vector<flightTy> vFlights; // fixed number of flight slots
+    std::vector<const LTAircraft::FlightModel*> vTypeMdl;  // flight model per synthetic a/c type
+    vecSynthReportTy vLate;         // reports held back for the next Advance()
+    double simTs;                   // [s] time of the simulation
+    uint32_t cntFlights = 0;        // running number of flights started
+    statsTy stats;
+    
+public:
+    // without areas there is one around ctrPos with radius fdStdDistance
+    SynthTraffic (unsigned seed, int numFlights, const vecSynthAreaTy& vAreas,
+                  const positionTy& ctrPos, double startTs);
+    
+    // advances all flights to ts, appending the reports sent on the way
+    void Advance (double ts, vecSynthReportTy& vOut);
+    
+    inline double GetTime () const          { return simTs; }
+    inline size_t GetNumFlights () const    { return vFlights.size(); }
+    inline size_t GetNumAirports () const   { return vAp.size(); }
+    inline const statsTy& GetStats () const { return stats; }
+    // number of flights currently in the given phase
+    size_t CntPhase (synthPhaseTy phase) const;
+    
+protected:
+    // random helpers, defined the same on all platforms
+    double RndUniform (double from, double to);
+    double RndNormal (double sigma);
+    inline bool RndChance (double p) { return RndUniform(0.0, 1.0) < p; }
+    size_t RndAirport ();
+    
+    void CreateAirports (const vecSynthAreaTy& vAreas);
+    void NewFlight (flightTy& f, bool bInit);
+    void Step (flightTy& f, double dt);
+    void Report (const flightTy& f, vecSynthReportTy& vOut);
+};
+
+#endif /* LTSynthetic_h */
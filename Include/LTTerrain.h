@@ -0,0 +1,83 @@
+//
+//  LTTerrain.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LTTerrain_h
+#define LTTerrain_h
+
+#include <functional>
+
+//
+//MARK: Terrain probe service
+//      All Y probes go through here. Requests are queued with a priority
+//      and served once per frame by TerrainProbeProcess, not more than
+//      the configured budget (DataRefs::GetProbeBudget) per frame.
+//      Results are delivered back via callback.
+//      Requests can be made from any thread, probing and delivery
+//      happen in X-Plane's main thread only.
+//      The terrain cache is consulted once per request: right away
+//      if requested from the main thread, otherwise in the next frame.
+//
+
+// receives the terrain altitude [m], NaN if probe failed
+typedef std::function<void(double terrainAlt_m)> probeDeliverFuncTy;
+
+// to be called from X-Plane's main thread before any request
+void TerrainProbeInit ();
+// Queues a probe request. A request is identified by owner and key,
+// requesting again with same owner/key updates position and priority.
+// 'bCritical' requests (on the ground, on final) are served first.
+// Returns the terrain altitude [m] if the main thread requested a cached
+// position (nothing queued then, 'deliver' not called), NaN otherwise.
+double TerrainProbeRequest (const void* owner, double key,
+                            const positionTy& pos, bool bCritical,
+                            probeDeliverFuncTy&& deliver);
+// removes all requests of the owner (call before owner is destroyed)
+void TerrainProbeCancel (const void* owner);
+// probes right away (main thread only), counts against the frame's budget
+double TerrainProbeSync (const positionTy& pos);
+// serves the most urgent requests (main thread only, once per frame)
+void TerrainProbeProcess ();
+// number of requests waiting to be served
+size_t TerrainProbeNumPending ();
+// removes all requests, releases probe handle
+void TerrainProbeCleanup ();
+
+//
+//MARK: Terrain elevation cache
+//      Terrain altitudes by small lat/lon cells (TERRAIN_CACHE_RES),
+//      shared by all aircraft, least recently used cells are evicted.
+//      Only to be accessed from X-Plane's main thread!
+//
+
+// cached terrain altitude [m] at pos, NaN if not cached
+double TerrainCacheGet (const positionTy& pos);
+// stores terrain altitude [m] at pos
+void TerrainCachePut (const positionTy& pos, double terrainAlt_m);
+// empties the cache, e.g. after scenery reload
+void TerrainCacheClear ();
+// percentage of terrain altitudes served from the cache instead of probing
+float TerrainCacheHitRate ();
+
+#endif /* LTTerrain_h */
@@ -0,0 +1,114 @@
+//
+//  LTTrace.h
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LTTrace_h
+#define LTTrace_h
+
+#include <cstdint>
+
+//
+//MARK: Position pipeline trace
+//      Compact binary records of what happens to positions on their way
+//      from the network to the aircraft, for all aircraft, always on.
+//      Records are kept in a memory ring (TRACE_RING_SIZE), which is
+//      written in the background to PATH_TRACE_FILE on demand
+//      (livetraffic/dbg/trace_flush) and to time-stamped files on errors
+//      (LTErrorFD, limited by TRACE_ERR_MAX_FILES and TRACE_ERR_MIN_INTVL).
+//      Tools/LTTraceDecode turns such a file
+//      into a timeline per aircraft.
+//      This header is also used by the decoder, so it must not
+//      depend on anything else of LiveTraffic.
+//
+
+// trace event types
+enum traceEvtTy : uint8_t {
+    TRC_NONE = 0,
+    TRC_INGEST,                 // position received from network (AddNewPos)
+    TRC_MERGE,                  // merged into an existing position (AppendNewPos)
+    TRC_APPEND,                 // inserted into posDeque (AppendNewPos)
+    TRC_DROP,                   // not added (AppendNewPos), info: reason
+    TRC_CLEANSE,                // removed as invalid (DataCleansing)
+    TRC_FETCH,                  // handed over to the aircraft (TryFetchNewPos)
+    TRC_SWITCH,                 // aircraft started flying towards this position
+    TRC_AC_CREATE,              // aircraft created at this position
+    TRC_AC_REMOVE,              // aircraft removed at this position
+    TRC_ERROR,                  // LTErrorFD raised for this aircraft
+    TRC_CNT_EVT                 // always last, number of elements
+};
+
+// reasons for TRC_DROP
+enum traceDropTy : uint16_t {
+    TRC_DROP_BEFORE_TO = 1,     // before aircraft's current 'to' position
+    TRC_DROP_OVERLAP,           // merge would overlap with neighbours
+    TRC_DROP_NOT_OK,            // sharp turn or invalid speed (IsPosOK)
+    TRC_DROP_CH_SWITCH,         // from a channel the flight switched away from
+};
+
+// event names for output
+constexpr const char* TRACE_EVT_NAMES[TRC_CNT_EVT] = {
+    "-", "INGEST", "MERGE", "APPEND", "DROP", "CLEANSE",
+    "FETCH", "SWITCH", "AC_CREATE", "AC_REMOVE", "ERROR"
+};
+
+// one trace record
+struct traceRecTy {
+    double      tWall;          // [s] since trace start (steady clock)
+    double      posTs;          // timestamp of the position concerned
+    double      lat;            // position concerned
+    double      lon;
+    float       alt_m;
+    uint32_t    acKey;          // transponder icao as integer
+    uint8_t     evt;            // traceEvtTy
+    uint8_t     gnd;            // positionTy::onGrndE
+    uint16_t    info;           // event-specific detail
+};
+
+// header of the trace file, followed by numRec records, oldest first
+struct traceFileHeadTy {
+    char        magic[4];       // TRACE_FILE_MAGIC
+    uint16_t    version;        // TRACE_FILE_VER
+    uint16_t    recSize;        // sizeof(traceRecTy)
+    uint32_t    numRec;         // number of records following
+    uint32_t    numLost;        // older records overwritten in the ring
+};
+
+constexpr char TRACE_FILE_MAGIC[4] = {'L','T','T','R'};
+constexpr uint16_t TRACE_FILE_VER  = 1;
+
+#ifndef LT_TRACE_DECODER
+struct positionTy;
+
+// record an event (any thread, lock-free)
+void TraceEvent (traceEvtTy evt, unsigned int acKey, const positionTy& pos, uint16_t info = 0);
+// write the memory ring to PATH_TRACE_FILE in the background (any thread),
+// false if a previous write is still busy
+bool TraceFlush ();
+// same for errors: write to a time-stamped file, false if rate-limited
+bool TraceFlushOnError ();
+// wait for a pending write
+void TraceStop ();
+#endif
+
+#endif /* LTTrace_h */
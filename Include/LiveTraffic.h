@@ -62,6 +62,7 @@
 #include <utility>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <list>
 #include <deque>
@@ -96,9 +97,17 @@
 #include "Constants.h"
 #include "DataRefs.h"
 #include "CoordCalc.h"
+#include "LTTerrain.h"
+#include "LTQueue.h"
+#include "LTGovernor.h"
+#include "LTTrace.h"
+#include "LTRecorder.h"
+#include "LTJsonScan.h"
+#include "LTArena.h"
 #include "TextIO.h"
 #include "LTAircraft.h"
 #include "LTFlightData.h"
+#include "LTSynthetic.h"
 #include "LTChannel.h"
 #include "TFWidgets.h"
 #include "SettingsUI.h"
@@ -126,6 +135,8 @@ int LTNumFilesInPath ( const std::string path );
 std::string& str_toupper(std::string& s);
 // are all chars alphanumeric?
 bool str_isalnum(const std::string& s);
+// comparing 2 doubles for near-equality
+bool dequal ( const double d1, const double d2 );
 // format timestamp
 std::string ts2string (time_t t);
 // limits text to m characters, replacing the last ones with ... if too long
@@ -77,7 +77,7 @@ public:
 class LTErrorFD : public LTError {
 public:
     LTFlightData&   fd;
-    std::string     posStr;
+    std::string     posStr;         // positions dump, for the debug aircraft only
 public:
     LTErrorFD (LTFlightData& _fd,
                const char* szFile, int ln, const char* szFunc, logLevelTy lvl,
@@ -108,12 +108,25 @@ void DestroyWindow();
 
 // MARK: Write to X-Plane log
 
-// returns ptr to static buffer filled with log string
+// returns ptr to thread-local buffer filled with log string
 const char* GetLogString ( const char* szFile, int ln, const char* szFunc, logLevelTy lvl, const char* szMsg, va_list args );
              
 // Log Text to log file
 void LogMsg ( const char* szFile, int ln, const char* szFunc, logLevelTy lvl, const char* szMsg, ... );
 
+// MARK: Asynchronous log writer
+// Log lines are formatted in the calling thread and queued in a lock-free
+// ring buffer, a background thread writes them to X-Plane's log in batches.
+// If the ring buffer is full lines are dropped (and counted).
+
+// start/stop the writer thread (while not running lines are written synchronously)
+void LogWriterStart ();
+void LogWriterStop ();
+// queue text for writing to the log
+void LogWrite ( const char* szText );
+// number of log lines dropped because the ring buffer was full
+int LogDroppedCount ();
+
 // Log a message if lvl is greater or equal currently defined log level
 // Note: First parameter after lvl must be the message text,
 //       which can be a format string with its parameters following like in sprintf
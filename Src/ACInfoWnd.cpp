@@ -397,6 +397,7 @@ bool ACIWnd::MsgTextFieldChanged (XPWidgetID textWidget, std::string text)
 // triggered every seond to update values in the window
 bool ACIWnd::TfwMsgMain1sTime ()
 {
+    GovFrameCostTy govCost;             // this counts as LiveTraffic's frame time
     TFMainWindowWidget::TfwMsgMain1sTime();
     if (!UpdateFocusAc())               // changed focus a/c? If not:
         UpdateDynValues();              // update our values
@@ -106,8 +106,16 @@ positionTy CoordPlusVector (const positionTy& p, const vectorTy& vec)
 
 // returns terrain altitude at given position
 // returns NaN in case of failure
-double YProbe_at_m (const positionTy& posAt, XPLMProbeRef& probeRef)
+double YProbe_at_m (const positionTy& posAt, XPLMProbeRef& probeRef,
+                    bool bUseCache)
 {
+    // known already?
+    if (bUseCache) {
+        const double cachedAlt = TerrainCacheGet(posAt);
+        if (!std::isnan(cachedAlt))
+            return cachedAlt;
+    }
+    
     // first call, don't have handle?
     if (!probeRef)
         probeRef = XPLMCreateProbe(xplm_ProbeY);
@@ -133,6 +141,7 @@ double YProbe_at_m (const positionTy& posAt, XPLMProbeRef& probeRef)
     // convert to World coordinates and save terrain altitude [in ft]
     pos = positionTy(probeInfo);
     pos.LocalToWorld();
+    TerrainCachePut(posAt, pos.alt_m());
     return pos.alt_m();             // THIS is terrain altitude beneath posAt
 }
 
@@ -371,6 +380,93 @@ positionTy::onGrndE positionTy::DeriveGrndStatus (positionTy::onGrndE from,
     return gndMatrix[to][from];
 }
 */
+
+//
+//MARK: greatCircleSegTy
+//
+
+// below this central angle (about 6mm) we don't bother with the sphere
+constexpr double GC_MIN_OMEGA = 1e-9;
+
+// precompute unit vectors and deltas for the segment 'from' -> 'to'
+void greatCircleSegTy::Init (const positionTy& from, const positionTy& to)
+{
+    LOG_ASSERT(from.unitAngle==positionTy::UNIT_DEG && from.unitCoord==positionTy::UNIT_WORLD);
+    LOG_ASSERT(to.unitAngle==positionTy::UNIT_DEG && to.unitCoord==positionTy::UNIT_WORLD);
+
+    // linear part: start values and deltas of all elements
+    for (size_t i = 0; i <= positionTy::ROLL; i++) {
+        v0[i] = from.v[i];
+        dv[i] = to.v[i] - from.v[i];
+    }
+    // take the shorter way around in case we cross the 180° meridian
+    if (dv[positionTy::LON] >  180) dv[positionTy::LON] -= 360;
+    if (dv[positionTy::LON] < -180) dv[positionTy::LON] += 360;
+
+    // unit vectors of 'from' (a) and 'to' (b) on the unit sphere
+    using namespace std;
+    const double lat1 = ::deg2rad(from.lat()), lon1 = ::deg2rad(from.lon());
+    const double lat2 = ::deg2rad(to.lat()),   lon2 = ::deg2rad(to.lon());
+    a[0] = cos(lat1) * cos(lon1);
+    a[1] = cos(lat1) * sin(lon1);
+    a[2] = sin(lat1);
+    const double b[3] = {
+        cos(lat2) * cos(lon2),
+        cos(lat2) * sin(lon2),
+        sin(lat2)
+    };
+
+    // n = a x b is the normal of the great circle's plane, |n| = sin(omega)
+    const double n[3] = {
+        a[1]*b[2] - a[2]*b[1],
+        a[2]*b[0] - a[0]*b[2],
+        a[0]*b[1] - a[1]*b[0]
+    };
+    const double sinOmega = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+    const double cosOmega = a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+    omega = atan2(sinOmega, cosOmega);
+
+    // (nearly) identical or antipodal positions don't define a great circle
+    bLinear = !(omega > GC_MIN_OMEGA && PI - omega > GC_MIN_OMEGA);
+    if (!bLinear) {
+        // c = (n x a) / |n| is the unit tangent at 'from' in direction of 'to'
+        c[0] = (n[1]*a[2] - n[2]*a[1]) / sinOmega;
+        c[1] = (n[2]*a[0] - n[0]*a[2]) / sinOmega;
+        c[2] = (n[0]*a[1] - n[1]*a[0]) / sinOmega;
+    }
+
+    bValid = true;
+}
+
+// position at factor f, written directly into pos.v (no temporaries)
+void greatCircleSegTy::At (double f, positionTy& pos) const
+{
+    LOG_ASSERT(bValid && pos.v.size() > positionTy::ROLL);
+
+    // all elements linearly first: v0 + f * dv
+    for (size_t i = 0; i <= positionTy::ROLL; i++)
+        pos.v[i] = std::fma(dv[i], f, v0[i]);
+
+    if (bLinear) {
+        // linear lon might have run beyond the 180° meridian
+        if (pos.lon() >  180) pos.lon() -= 360;
+        if (pos.lon() < -180) pos.lon() += 360;
+        return;
+    }
+
+    // lat/lon: rotate 'from' by f * omega along the great circle
+    // p = a * cos(f*omega) + c * sin(f*omega)
+    const double ang = f * omega;
+    const double cosA = std::cos(ang), sinA = std::sin(ang);
+    const double p[3] = {
+        std::fma(a[0], cosA, c[0] * sinA),
+        std::fma(a[1], cosA, c[1] * sinA),
+        std::fma(a[2], cosA, c[2] * sinA)
+    };
+    pos.lat() = ::rad2deg(std::asin(std::max(-1.0, std::min(1.0, p[2]))));
+    pos.lon() = ::rad2deg(std::atan2(p[1], p[0]));
+}
+
 //
 //MARK: dequePositionTy
 //
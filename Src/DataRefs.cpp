@@ -179,6 +179,7 @@ const char* DATA_REFS_XP[CNT_DATAREFS_XP] = {
     "sim/time/local_date_days",
     "sim/time/use_system_time",
     "sim/time/zulu_time_sec",
+    "sim/operation/misc/frame_rate_period",
 };
 
 //
@@ -228,15 +229,36 @@ DataRefs::dataRefDefinitionT DATA_REFS_LT[] = {
     {"livetraffic/cfg/fd_refresh_intvl",            DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/fd_buf_period",               DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/cfg/ac_outdated_intvl",           DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/lod_mid_distance",            DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/lod_far_distance",            DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/lod_mid_intvl",               DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/lod_far_intvl",               DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/probe_budget",                DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/gov_target_fps",              DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/replay_speed",                DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/synth_num_ac",                DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
+    {"livetraffic/cfg/synth_seed",                  DataRefs::LTGetInt, DataRefs::LTSetCfgValue,    GET_VAR, true },
     {"livetraffic/channel/adsb_exchange/online",    DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/adsb_exchange/historic",  DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/open_sky/online",         DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/open_sky/ac_masterdata",  DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/channel/futuredatachn/online",    DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, false },
+    {"livetraffic/channel/replay",                  DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, false },
+    {"livetraffic/channel/sbs/tcp",                 DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
+    {"livetraffic/channel/adsb_exchange/stream",    DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
+    {"livetraffic/channel/synthetic",               DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, false },
     {"livetraffic/dbg/ac_filter",                   DataRefs::LTGetInt, DataRefs::LTSetDebugAcFilter, GET_VAR, true },
     {"livetraffic/dbg/ac_pos",                      DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
     {"livetraffic/dbg/log_raw_fd",                  DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, false },
     {"livetraffic/dbg/model_matching",              DataRefs::LTGetInt, DataRefs::LTSetBool,        GET_VAR, true },
+    {"livetraffic/dbg/terrain_cache_hit_rate",      DataRefs::LTGetTerrainCacheHitRate, NULL,       NULL, false },
+    {"livetraffic/dbg/frame_cost_us",               DataRefs::LTGetFrameCost, NULL,                 NULL, false },
+    {"livetraffic/dbg/deferred_create_ac",          DataRefs::LTGetGovDeferred, NULL,               (void*)GOV_CREATE_AC, false },
+    {"livetraffic/dbg/deferred_labels",             DataRefs::LTGetGovDeferred, NULL,               (void*)GOV_LABELS, false },
+    {"livetraffic/dbg/deferred_probes",             DataRefs::LTGetGovDeferred, NULL,               (void*)GOV_PROBES, false },
+    {"livetraffic/dbg/deferred_ac_maint",           DataRefs::LTGetGovDeferred, NULL,               (void*)GOV_AC_MAINT, false },
+    {"livetraffic/dbg/log_dropped",                 DataRefs::LTGetLogDropped, NULL,                NULL, false },
+    {"livetraffic/dbg/trace_flush",                 DataRefs::LTGetTraceFlush, DataRefs::LTSetTraceFlush, NULL, false },
 };
 
 static_assert(sizeof(DATA_REFS_LT)/sizeof(DATA_REFS_LT[0]) == CNT_DATAREFS_LT,
@@ -261,6 +283,15 @@ void* DataRefs::getVarAddr (dataRefsLT dr)
         case DR_CFG_FD_REFRESH_INTVL:       return &fdRefreshIntvl;
         case DR_CFG_FD_BUF_PERIOD:          return &fdBufPeriod;
         case DR_CFG_AC_OUTDATED_INTVL:      return &acOutdatedIntvl;
+        case DR_CFG_LOD_MID_DISTANCE:       return &lodMidDistance;
+        case DR_CFG_LOD_FAR_DISTANCE:       return &lodFarDistance;
+        case DR_CFG_LOD_MID_INTVL:          return &lodMidIntvl;
+        case DR_CFG_LOD_FAR_INTVL:          return &lodFarIntvl;
+        case DR_CFG_PROBE_BUDGET:           return &probeBudget;
+        case DR_CFG_GOV_TARGET_FPS:         return &govTargetFps;
+        case DR_CFG_REPLAY_SPEED:           return &replaySpeed;
+        case DR_CFG_SYNTH_NUM_AC:           return &synthNumAc;
+        case DR_CFG_SYNTH_SEED:             return &synthSeed;
 
         case DR_DBG_AC_FILTER:              return &uDebugAcFilter;
         case DR_DBG_AC_POS:                 return &bDebugAcPos;
@@ -368,6 +399,12 @@ iLogLevel (initLogLevel)
     // enable all channels
     for ( int& i: bChannel )
         i = true;
+    // ...except for replay and synthetic traffic, which replace the live channels,
+    // and for the streaming feeds, which need to be set up first
+    SetChannelEnabled(DR_CHANNEL_REPLAY, false);
+    SetChannelEnabled(DR_CHANNEL_SBS_TCP, false);
+    SetChannelEnabled(DR_CHANNEL_ADSB_EXCHANGE_STREAM, false);
+    SetChannelEnabled(DR_CHANNEL_SYNTHETIC, false);
 
     // Clear the dataRefs arrays
     memset ( adrXP, 0, sizeof(adrXP));
@@ -681,6 +718,11 @@ float DataRefs::LTGetAcInfoF(void* p)
 // simulated time (seconds since Unix epoch, including fractionals)
 double DataRefs::GetSimTime() const
 {
+    // a headless driver steps the time itself
+    const double stepped = simTimeStepped;
+    if ( !std::isnan(stepped) )
+        return stepped;
+    
     // using historic data means: we take the date configured in X-Plane's date&time settings
     if ( bUseHistoricData )
     {
@@ -931,13 +973,22 @@ bool DataRefs::SetCfgValue (void* p, int val)
     
     // any configuration value invalid?
     if (labelColor      < 0                 || labelColor       > 0xFFFFFF ||
-        maxNumAc        < 5                 || maxNumAc         > 100   ||
+        maxNumAc        < 5                 || maxNumAc         > maxNumAcLimit ||
         maxFullNumAc    < 5                 || maxFullNumAc     > 100   ||
         fullDistance    < 1                 || fullDistance     > 100   ||
         fdStdDistance   < 5                 || fdStdDistance    > 100   ||
         fdRefreshIntvl  < 10                || fdRefreshIntvl   > 5*60  ||
         fdBufPeriod     < fdRefreshIntvl    || fdBufPeriod      > 5*60  ||
-        acOutdatedIntvl < 2*fdRefreshIntvl  || acOutdatedIntvl  > 5*60)
+        acOutdatedIntvl < 2*fdRefreshIntvl  || acOutdatedIntvl  > 5*60  ||
+        lodMidDistance  < 1                 || lodMidDistance   > 100   ||
+        lodFarDistance  < lodMidDistance    || lodFarDistance   > 100   ||
+        lodMidIntvl     < 1                 || lodMidIntvl      > 10    ||
+        lodFarIntvl     < lodMidIntvl       || lodFarIntvl      > 30    ||
+        probeBudget     < 1                 || probeBudget      > 200   ||
+        govTargetFps    < 0                 || govTargetFps     > 100   ||
+        replaySpeed     < 0                 || replaySpeed      > 100   ||
+        synthNumAc      < 1                 || synthNumAc       > 50000 ||
+        synthSeed       < 0)
     {
         // undo change
         *reinterpret_cast<int*>(p) = oldVal;
@@ -975,6 +1026,37 @@ std::string DataRefs::GetDebugAcFilter() const
     return key;
 }
 
+// percentage of terrain altitudes served from cache
+float DataRefs::LTGetTerrainCacheHitRate(void*)
+{
+    return TerrainCacheHitRate();
+}
+
+// LiveTraffic's main-thread time per frame [µs]
+float DataRefs::LTGetFrameCost(void*)
+{
+    return GovernorFrameCost();
+}
+
+// number of deferrals of a kind of work (refCon) by the frame-time governor
+int DataRefs::LTGetGovDeferred(void* p)
+{
+    return GovernorDeferred(govWorkTy(reinterpret_cast<long long>(p)));
+}
+
+// log lines dropped because the log buffer was full
+int DataRefs::LTGetLogDropped(void*)
+{
+    return LogDroppedCount();
+}
+
+// write the position pipeline trace to file
+void DataRefs::LTSetTraceFlush(void*, int i)
+{
+    if (i)
+        TraceFlush();
+}
+
 // sets A/C filter
 void DataRefs::LTSetDebugAcFilter( void* /*inRefcon*/, int i )
 {
@@ -1215,6 +1297,10 @@ bool DataRefs::LoadConfigFile()
                 dataRefs.SetDefaultAcIcaoType(sVal);
             else if (sDataRef == CFG_DEFAULT_CAR_TYPE)
                 dataRefs.SetDefaultCarIcaoType(sVal);
+            else if (sDataRef == CFG_SBS_HOST)
+                dataRefs.SetSbsHost(sVal);
+            else if (sDataRef == CFG_ADSBEX_STREAM_HOST)
+                dataRefs.SetAdsbexStreamHost(sVal);
             else
             {
                 // unknown config entry, ignore
@@ -1287,6 +1373,10 @@ bool DataRefs::LoadConfigFile()
 
 bool DataRefs::SaveConfigFile()
 {
+    // headless drivers change the config for their runs only
+    if (!bSaveConfig)
+        return true;
+    
     // open an output config file
     std::string sFileName (LTCalcFullPath(PATH_CONFIG_FILE));
     std::ofstream fOut (sFileName, std::ios_base::out | std::ios_base::trunc);
@@ -1312,6 +1402,8 @@ bool DataRefs::SaveConfigFile()
     // *** Strings ***
     fOut << CFG_DEFAULT_AC_TYPE << ' ' << dataRefs.GetDefaultAcIcaoType() << '\n';
     fOut << CFG_DEFAULT_CAR_TYPE << ' ' << dataRefs.GetDefaultCarIcaoType() << '\n';
+    fOut << CFG_SBS_HOST << ' ' << dataRefs.GetSbsHost() << '\n';
+    fOut << CFG_ADSBEX_STREAM_HOST << ' ' << dataRefs.GetAdsbexStreamHost() << '\n';
 
     // *** [CSLPatchs] ***
     // add section of CSL paths to the end
@@ -1418,6 +1510,26 @@ bool DataRefs::SetDefaultCarIcaoType(const std::string type)
     return false;
 }
 
+// sets host:port of the SBS-1 feed, no spaces allowed (config file format)
+bool DataRefs::SetSbsHost(const std::string host)
+{
+    if (!host.empty() && host.find(' ') == std::string::npos) {
+        sSbsHost = host;
+        return true;
+    }
+    return false;
+}
+
+// sets host:port of the ADS-B Exchange stream, no spaces allowed
+bool DataRefs::SetAdsbexStreamHost(const std::string host)
+{
+    if (!host.empty() && host.find(' ') == std::string::npos) {
+        sAdsbexStreamHost = host;
+        return true;
+    }
+    return false;
+}
+
 //MARK: Processed values (static functions)
 
 // return the camera's position in world coordinates
@@ -28,6 +28,8 @@
 
 #include <fstream>
 #include <regex>
+#include <condition_variable>
+#include <random>
 
 //
 //MARK: Globals
@@ -843,8 +845,10 @@ gear(mdl.GEAR_DURATION),
 flaps(mdl.FLAPS_DURATION),
 heading(mdl.TAXI_TURN_TIME, 360, 0, true),
 pitch((mdl.PITCH_MAX-mdl.PITCH_MIN)/mdl.PITCH_RATE, mdl.PITCH_MAX, mdl.PITCH_MIN),
-probeRef(NULL), probeNextTs(0), terrainAlt(0),
-bValid(true)
+probeNextTs(0), terrainAlt(0),
+bValid(true),
+frameIdx(0), bFrameCalcDue(false),
+bFrameExtrapolate(false), lodIntvl(1), lodNextCycle(0), lodRate{0,0,0}
 {
     // for some calcs we need correct timestamps _before_ first draw already
     // so make sure the currCycle struct is up-to-date
@@ -892,6 +896,7 @@ bValid(true)
         
         // tell the world we've added something
         dataRefs.IncNumAircrafts();
+        TraceEvent(TRC_AC_CREATE, fd.keyInt(), ppos);
         LOG_MSG(logINFO,INFO_AC_ADDED,
                 labelInternal.c_str(),
                 statCopy.opIcao.c_str(),
@@ -902,17 +907,25 @@ bValid(true)
     } catch(const std::system_error& e) {
         LOG_MSG(logERR, ERR_LOCK_ERROR, key().c_str(), e.what());
     }
+    
+    // take part in the per-frame batch update, starting with what we have now
+    frameIdx = acFrameData.Add(this);
+    acFrameData.Set(frameIdx, ppos, gear.get(), flaps.get(),
+                    ppos.isNormal() ? xpmpData_NewData : xpmpData_Unavailable);
 }
 
 // Destructor
 LTAircraft::~LTAircraft()
 {
-    // Release probe handle
-    if (probeRef)
-        XPLMDestroyProbe(probeRef);
+    // no longer part of the per-frame batch update
+    acFrameData.Remove(frameIdx);
+    
+    // no more terrain probes for us
+    TerrainProbeCancel(this);
     
     // Decrease number of visible aircrafts and log a message about that fact
     dataRefs.DecNumAircrafts();
+    TraceEvent(TRC_AC_REMOVE, fd.keyInt(), ppos);
     LOG_MSG(logINFO,INFO_AC_REMOVED,labelInternal.c_str());
 }
 
@@ -965,20 +978,12 @@ bool LTAircraft::OutOfPositions() const
 }
 
 
-// The basic idea is: We are given a 'from'-position and a 'to'-position,
-// both including a timestamp. The 'from'-timestamp is in the past,
-// the 'to'-timestamp is in the future (as compared to simulated LT time,
-// which is lagging behind real time by a buffer [defaults to 60 seconds]).
-// The present position is basically inbetween 'from' and 'to',
-// moving linear with time as to reach 'to' when reaching the 'to'-timestamp
-// in simulated LT time.
-// All aspects of flight position and attitude (pitch, roll, heading)
-// are deducted from that movement, also see CalcFlightModel
-bool LTAircraft::CalcPPos()
+// Fetches new positions from flight data if we are (about to be) running out.
+// Must be called from the main thread as TryFetchNewPos might need to
+// probe terrain for fetched positions.
+// Returns false if there aren't enough positions to fly.
+bool LTAircraft::FetchPositions()
 {
-    // new positions to work with?
-    bool bPosSwitch = phase == FPH_UNKNOWN;
-    
     // *** some checks on our positional information ***
 
     // are there sufficient position information for a calculation?
@@ -1025,6 +1030,28 @@ bool LTAircraft::CalcPPos()
         }
     }
     
+    return true;
+}
+
+// The basic idea is: We are given a 'from'-position and a 'to'-position,
+// both including a timestamp. The 'from'-timestamp is in the past,
+// the 'to'-timestamp is in the future (as compared to simulated LT time,
+// which is lagging behind real time by a buffer [defaults to 60 seconds]).
+// The present position is basically inbetween 'from' and 'to',
+// moving linear with time as to reach 'to' when reaching the 'to'-timestamp
+// in simulated LT time.
+// All aspects of flight position and attitude (pitch, roll, heading)
+// are deducted from that movement, also see CalcFlightModel
+bool LTAircraft::CalcPPos(bool bMainThread)
+{
+    // fetching positions might require terrain probes: main thread only
+    if (bMainThread && !FetchPositions())
+        return false;
+    
+    // new positions to work with?
+    bool bPosSwitch = phase == FPH_UNKNOWN;
+    LOG_ASSERT_FD(fd, posList.size() >= 2);
+    
     // Finally: Time to switch to next position?
     // (Must have reach/passed posList[1] and there must be a third position,
     //  which can now serve as 'to')
@@ -1040,6 +1067,7 @@ bool LTAircraft::CalcPPos()
             posList[0] = ppos;
         // flag: switched positions
         bPosSwitch = true;
+        TraceEvent(TRC_SWITCH, fd.keyInt(), posList[1]);
     }
 
     // *** fixed to/from positions ***
@@ -1257,9 +1285,12 @@ bool LTAircraft::CalcPPos()
     // Now we apply the factor so that with time we move from 'from' to 'to'.
     // Note that this calculation also works if we passed 'to' already
     // (due to no newer 'to' available): we just keep going the same way.
-    // Here now valarray comes in handy as we can write the calculation
-    // with simple vector notation:
-    ppos.v = from.v * (1-f) + to.v * f;
+    // Lat/lon follow the great circle between 'from' and 'to', which
+    // is set up only once per position switch; per frame this is just
+    // a few multiply-adds written directly into ppos.
+    if (bPosSwitch || !segFromTo.IsValid())
+        segFromTo.Init(from, to);
+    segFromTo.At(f, ppos);
     // (this also computes values for heading, pitch, roll, which is a historic
     //  relict. We later decided to use MovingParam for those values.)
     
@@ -1294,7 +1325,10 @@ bool LTAircraft::CalcPPos()
 
     // *** Height and Flight Model ***
     // Now we know our new position, determine height above ground
-    YProbe();
+    // (in the batch update this happened on the main thread already
+    //  before the parallel calculation, based on the previous frame's position)
+    if (bMainThread)
+        YProbe(true);
 
     // Calculate other a/c parameters
     CalcFlightModel (from, to);
@@ -1470,7 +1504,10 @@ void LTAircraft::CalcFlightModel (const positionTy& /*from*/, const positionTy&
         // -> can be used for flight model initialization
         // some assumption to begin with...
         surfaces.thrust            = 0.1f;
-        surfaces.lights.timeOffset = (unsigned int)rand();
+        // (rand() isn't thread-safe and we might run in a calc worker,
+        //  seeded by key, so the same flight always flashes the same way)
+        std::mt19937 rnd ((std::mt19937::result_type)std::hash<std::string>()(fd.key()));
+        surfaces.lights.timeOffset = (unsigned int)rnd();
         surfaces.lights.landLights = 0;
         surfaces.lights.bcnLights  = 1;
         surfaces.lights.strbLights = 0;
@@ -1602,8 +1639,10 @@ void LTAircraft::CalcFlightModel (const positionTy& /*from*/, const positionTy&
 }
 
 
-// determines terrain altitude via XPLM's Y Probe
-bool LTAircraft::YProbe ()
+// determines terrain altitude via the terrain probe service
+// bSync: probe right away, otherwise the result is delivered by
+//        TerrainProbeProcess later in this or in a following frame
+bool LTAircraft::YProbe (bool bSync)
 {
     // short-cut if not yet due
     // (we do probes only every so often, more often close to the ground,
@@ -1611,8 +1650,29 @@ bool LTAircraft::YProbe ()
     if ( currCycle.simTime < probeNextTs )
         return true;
     
+    if (bSync)
+        YProbeDelivered(TerrainProbeSync(ppos));
+    else {
+        // requesting again while waiting just updates position and priority
+        const double cachedAlt =
+        TerrainProbeRequest(this, 0.0, ppos,
+                            bOnGrnd ||
+                            (FPH_TAKE_OFF <= phase && phase <= FPH_LIFT_OFF) ||
+                            (FPH_FINAL <= phase && phase <= FPH_ROLL_OUT),
+                            [this](double alt_m){ YProbeDelivered(alt_m); });
+        if (!std::isnan(cachedAlt))
+            YProbeDelivered(cachedAlt);
+    }
+    return true;
+}
+
+// receives the terrain altitude [m] beneath ppos
+//NOTE: Called by TerrainProbeProcess, i.e. an entry point into a/c code
+void LTAircraft::YProbeDelivered (double terrainAlt_m)
+try
+{
     // This is terrain altitude right beneath us in [ft]
-    terrainAlt = YProbe_at_m(ppos, probeRef) / M_per_FT;
+    terrainAlt = terrainAlt_m / M_per_FT;
     
     // lastly determine when to do a probe next, more often if closer to the ground
     static_assert(sizeof(PROBE_HEIGHT_LIM) == sizeof(PROBE_DELAY));
@@ -1630,10 +1690,15 @@ bool LTAircraft::YProbe ()
     // calc current bearing and distance for pure informational purpose ***
     vecView = positionTy(dataRefs.GetViewPos()).between(ppos);
     // update the a/c label with fresh values
-    LabelUpdate();
-    
-    // Success
-    return true;
+    // (unless deferred by the frame-time governor, then we'll do it with the next probe)
+    if (GovernorAllow(GOV_LABELS))
+        LabelUpdate();
+}
+catch (const std::exception& e)
+{
+    LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+    // for any kind of exception: don't use this object any more!
+    SetInvalid();
 }
 
 // return a string indicating the use of nav/beacon/strobe/landing lights
@@ -1649,6 +1714,388 @@ std::string LTAircraft::GetLightsStr() const
     return std::string(buf);
 }
 
+//
+//MARK: Per-frame batch update
+//
+
+// all aircraft's per-frame results
+acFrameDataTy acFrameData;
+
+// remove element idx by moving the last one into its place
+template<class T>
+inline void vecSwapRemove (std::vector<T>& v, size_t idx)
+{
+    v[idx] = v.back();
+    v.pop_back();
+}
+
+size_t acFrameDataTy::Add (LTAircraft* pAc)
+{
+    vAc.push_back(pAc);
+    vLat.push_back(NAN);
+    vLon.push_back(NAN);
+    vAlt_ft.push_back(NAN);
+    vPitch.push_back(0.0f);
+    vRoll.push_back(0.0f);
+    vHeading.push_back(0.0f);
+    vGear.push_back(0.0f);
+    vFlaps.push_back(0.0f);
+    vPosRes.push_back(xpmpData_Unavailable);
+    return vAc.size() - 1;
+}
+
+void acFrameDataTy::Remove (size_t idx)
+{
+    LOG_ASSERT(idx < size());
+    vecSwapRemove(vAc, idx);
+    vecSwapRemove(vLat, idx);
+    vecSwapRemove(vLon, idx);
+    vecSwapRemove(vAlt_ft, idx);
+    vecSwapRemove(vPitch, idx);
+    vecSwapRemove(vRoll, idx);
+    vecSwapRemove(vHeading, idx);
+    vecSwapRemove(vGear, idx);
+    vecSwapRemove(vFlaps, idx);
+    vecSwapRemove(vPosRes, idx);
+    // the a/c, which was last, now has a new index
+    if (idx < size())
+        vAc[idx]->frameIdx = idx;
+}
+
+void acFrameDataTy::Set (size_t idx, const positionTy& pos,
+                         double gear, double flaps,
+                         XPMPPlaneCallbackResult posRes)
+{
+    LOG_ASSERT(idx < size());
+    const XPMPPlanePosition_t xp = pos;     // type conversion handles NaN attitude
+    vLat[idx]       = xp.lat;
+    vLon[idx]       = xp.lon;
+    vAlt_ft[idx]    = xp.elevation;
+    vPitch[idx]     = xp.pitch;
+    vRoll[idx]      = xp.roll;
+    vHeading[idx]   = xp.heading;
+    vGear[idx]      = float(gear);
+    vFlaps[idx]     = float(flaps);
+    vPosRes[idx]    = posRes;
+}
+
+void acFrameDataTy::Get (size_t idx, XPMPPlanePosition_t& pos) const
+{
+    LOG_ASSERT(idx < size());
+    pos.lat         = vLat[idx];
+    pos.lon         = vLon[idx];
+    pos.elevation   = vAlt_ft[idx];
+    pos.pitch       = vPitch[idx];
+    pos.roll        = vRoll[idx];
+    pos.heading     = vHeading[idx];
+}
+
+// worker threads for the parallel calculation phase
+std::vector<std::thread>    vCalcWorkers;
+std::mutex                  calcWorkMutex;
+std::condition_variable     calcWorkCV;         // wakes up workers for a new frame
+std::condition_variable     calcDoneCV;         // wakes up main thread when workers are done
+unsigned                    calcGeneration = 0; // counts frames handed to the workers
+size_t                      calcWorkersBusy = 0;// workers still calculating current frame
+bool                        bCalcWorkersStop = false;
+std::atomic<size_t>         calcNextIdx(0);     // next a/c index to calculate
+
+// camera position/heading of current cycle, basis for level of detail
+positionTy                  lodViewPos;
+double                      lodViewHeading = 0.0;
+
+// calculates aircraft in chunks until there are no more
+// (executed by the workers _and_ the main thread)
+void LTAircraft::CalcFrameChunks ()
+{
+    const size_t n = acFrameData.size();
+    for (size_t i = calcNextIdx.fetch_add(AC_CALC_CHUNK);
+         i < n;
+         i = calcNextIdx.fetch_add(AC_CALC_CHUNK))
+    {
+        const size_t e = std::min(i + AC_CALC_CHUNK, n);
+        for (; i < e; i++)
+            acFrameData.vAc[i]->CalcFrameCompute();
+    }
+}
+
+// worker thread: waits for a new frame, calculates, reports back
+void LTAircraft::CalcWorkerMain ()
+{
+    unsigned myGen = 0;
+    for (;;) {
+        // wait for the next frame to calculate (or to stop)
+        {
+            std::unique_lock<std::mutex> lk(calcWorkMutex);
+            calcWorkCV.wait(lk, [&myGen]{return bCalcWorkersStop || calcGeneration != myGen;});
+            if (bCalcWorkersStop)
+                return;
+            myGen = calcGeneration;
+        }
+        
+        // calculate as many aircraft as we can get hold of
+        CalcFrameChunks();
+        
+        // report done, last one wakes up the main thread
+        std::lock_guard<std::mutex> lk(calcWorkMutex);
+        if (--calcWorkersBusy == 0)
+            calcDoneCV.notify_one();
+    }
+}
+
+// start the worker threads (called from main thread when showing aircraft)
+void LTAircraft::StartCalcWorkers ()
+{
+    if (!vCalcWorkers.empty())
+        return;
+    
+    // leave at least one core for X-Plane's main thread
+    const int hw = int(std::thread::hardware_concurrency());
+    const int nWorkers = std::min(AC_CALC_MAX_WORKERS, hw - 1);
+    
+    bCalcWorkersStop = false;
+    for (int i = 0; i < nWorkers; i++)
+        vCalcWorkers.emplace_back(CalcWorkerMain);
+}
+
+// stop and join the worker threads
+void LTAircraft::StopCalcWorkers ()
+{
+    {
+        std::lock_guard<std::mutex> lk(calcWorkMutex);
+        bCalcWorkersStop = true;
+    }
+    calcWorkCV.notify_all();
+    for (std::thread& t: vCalcWorkers)
+        t.join();
+    vCalcWorkers.clear();
+}
+
+// Calculates all aircraft's positions and configuration for the current
+// cycle in one go. Called early in the frame by the flight loop callback
+// LoopCBAircraftUpdate, but also by the XPMP callbacks in case the
+// flight loop didn't run in this cycle. Only the first call per cycle
+// does the work.
+// X-Plane APIs may only be called from the main thread, so the update
+// is split into phases:
+// 1. main thread: fetch new positions from flight data, probe terrain
+//                 (via the terrain probe service, see TerrainProbeProcess)
+// 2. parallel:    all the calculation (CalcPPos, CalcFlightModel),
+//                 shared between workers and main thread, then a barrier
+// The XPMP callbacks then hand the results to XPMP, again on the main thread.
+void LTAircraft::UpdateAll ()
+{
+    // already done in this cycle?
+    const int cycle = XPLMGetCycleNumber();
+    if (cycle == acFrameData.cycle)
+        return;
+    acFrameData.cycle = cycle;
+    
+    // new cycle: new simulated time
+    if ( cycle != currCycle.num )
+        NextCycle(cycle);
+    
+    // where is the camera? (once per cycle for all aircraft's level of detail)
+    if (!acFrameData.vAc.empty()) {
+        lodViewPos      = DataRefs::GetViewPos();
+        lodViewHeading  = DataRefs::GetViewHeading();
+    }
+    
+    // *** Phase 1: main thread only ***
+    for (LTAircraft* pAc: acFrameData.vAc)
+        pAc->CalcFramePrepare();
+    
+    // terrain probes as per frame budget, delivers the aircraft's requests
+    // from above right away if possible
+    TerrainProbeProcess();
+    
+    // *** Phase 2: parallel calculation ***
+    calcNextIdx = 0;
+    if (vCalcWorkers.empty() || acFrameData.size() < AC_CALC_PARALLEL_MIN) {
+        // not worth the synchronization overhead: all in main thread
+        CalcFrameChunks();
+    } else {
+        // wake up the workers
+        {
+            std::lock_guard<std::mutex> lk(calcWorkMutex);
+            calcWorkersBusy = vCalcWorkers.size();
+            calcGeneration++;
+        }
+        calcWorkCV.notify_all();
+        
+        // main thread helps out
+        CalcFrameChunks();
+        
+        // barrier: wait for all workers to finish this frame
+        std::unique_lock<std::mutex> lk(calcWorkMutex);
+        calcDoneCV.wait(lk, []{return calcWorkersBusy == 0;});
+    }
+}
+
+// main thread part of the per-frame calculation:
+// everything that might call X-Plane APIs
+void LTAircraft::CalcFramePrepare ()
+{
+    bFrameCalcDue = false;
+    bFrameExtrapolate = false;
+    
+    //NOTE: This is an entry point into LiveTraffic code, just like the callbacks below.
+    try {
+        // object invalid (due to exceptions most likely), don't calc anymore
+        if (!IsValid()) {
+            acFrameData.vPosRes[frameIdx] = xpmpData_Unavailable;
+            return;
+        }
+        
+        // avoid any calc if to be re-initialized
+        if (dataRefs.IsReInitAll()) {
+            acFrameData.vPosRes[frameIdx] = xpmpData_Unchanged;
+            return;
+        }
+        
+        // level of detail: in between full calculations we just extrapolate,
+        // which needs neither new positions nor terrain probes
+        if (currCycle.num < lodNextCycle) {
+            bFrameExtrapolate = bFrameCalcDue = true;
+            return;
+        }
+        
+        // enough positions to fly? (might probe terrain for new positions)
+        if (!FetchPositions()) {
+            acFrameData.Set(frameIdx, ppos, gear.get(), flaps.get(), xpmpData_Unchanged);
+            return;
+        }
+        
+        // terrain altitude (if due) based on previous frame's position,
+        // in time for the flight model calculation of this frame
+        if (ppos.isNormal())
+            YProbe(false);
+        
+        bFrameCalcDue = true;
+        return;
+        
+    } catch (const std::exception& e) {
+        LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+    } catch (...) {}
+    
+    // for any kind of exception: don't use this object any more!
+    SetInvalid();
+    acFrameData.vPosRes[frameIdx] = xpmpData_Unavailable;
+}
+
+// calculates this aircraft's values for the current frame
+// and stores them in acFrameData
+// (can run in any thread, must not call X-Plane APIs!)
+void LTAircraft::CalcFrameCompute ()
+{
+    // not prepared for calculation?
+    if (!bFrameCalcDue)
+        return;
+    
+    try {
+        // calculate new position, fully or (far away) just extrapolated
+        XPMPPlaneCallbackResult posRes = xpmpData_NewData;
+        if (bFrameExtrapolate)
+            LODExtrapolate();
+        else if (CalcPPos(false))
+            LODUpdate();
+        else
+            posRes = xpmpData_Unchanged;
+        
+        // for radar 'calculation' we need some dynData
+        // but radar doesn't change often...just only check every 100th cycle
+        if (currCycle.num % 100 == 0)
+        {
+            // fetch new data if available
+            LTFlightData::FDDynamicData dynCopy;
+            if ( fd.TryGetSafeCopy(dynCopy) )
+            {
+                // copy fresh radar data
+                radar               = dynCopy.radar;
+            }
+        }
+        
+        // store the results, including current gear/flaps value (might be moving),
+        // while extrapolating gear/flaps stay as per last full calculation
+        if (bFrameExtrapolate)
+            acFrameData.Set(frameIdx, ppos,
+                            acFrameData.vGear[frameIdx], acFrameData.vFlaps[frameIdx],
+                            posRes);
+        else
+            acFrameData.Set(frameIdx, ppos, gear.get(), flaps.get(), posRes);
+        return;
+        
+    } catch (const std::exception& e) {
+        LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+    } catch (...) {}
+    
+    // for any kind of exception: don't use this object any more!
+    SetInvalid();
+    acFrameData.vPosRes[frameIdx] = xpmpData_Unavailable;
+}
+
+// Level of detail: After a full calculation determine when the next one
+// is due, based on distance from the camera and if the aircraft is in front
+// of it. Also keeps the rates for extrapolating ppos till then.
+// (thread-safe, called from CalcFrameCompute)
+void LTAircraft::LODUpdate ()
+{
+    // rate of change since last full calculation
+    const double dt = currCycle.simTime - lodPos.ts();
+    if (lodPos.isNormal() && dt > 0) {
+        double dLon = ppos.lon() - lodPos.lon();
+        if (dLon > 180)  dLon -= 360;           // crossed 180° meridian
+        if (dLon < -180) dLon += 360;
+        lodRate[positionTy::LAT] = (ppos.lat() - lodPos.lat()) / dt;
+        lodRate[positionTy::LON] = dLon / dt;
+        lodRate[positionTy::ALT] = (ppos.alt_m() - lodPos.alt_m()) / dt;
+    } else {
+        // first calculation or time jumped back: don't move
+        std::fill(std::begin(lodRate), std::end(lodRate), 0.0);
+    }
+    lodPos = ppos;
+    lodPos.ts() = currCycle.simTime;
+    
+    // bearing/distance from camera
+    vecView = lodViewPos.between(ppos);
+    
+    // level of detail: 0 - every frame, 1 - mid distance, 2 - far away
+    int lod =
+    vecView.dist > dataRefs.GetLODFarDistance_m() ? 2 :
+    vecView.dist > dataRefs.GetLODMidDistance_m() ? 1 : 0;
+    // not in front of the camera: mid distance is treated like far away
+    if (lod == 1 && std::abs(HeadingDiff(lodViewHeading, vecView.angle)) > 90)
+        lod = 2;
+    // always full detail for the a/c we write debug output for
+    if (dataRefs.GetDebugAcPos(key()))
+        lod = 0;
+    
+    const int intvl =
+    lod == 2 ? dataRefs.GetLODFarIntvl() :
+    lod == 1 ? dataRefs.GetLODMidIntvl() : 1;
+    
+    if (intvl != lodIntvl) {
+        // changing level: spread aircraft over the interval
+        // so they don't all do their full calculation in the same frame
+        lodIntvl = intvl;
+        lodNextCycle = currCycle.num + 1 + int(frameIdx % size_t(lodIntvl));
+    } else
+        lodNextCycle = currCycle.num + lodIntvl;
+}
+
+// Level of detail: linear extrapolation of ppos from the last full calculation.
+// Attitude, gear, flaps etc. stay as they are.
+// (thread-safe, called from CalcFrameCompute)
+void LTAircraft::LODExtrapolate ()
+{
+    const double dt = currCycle.simTime - lodPos.ts();
+    ppos.lat()   = lodPos.lat()   + lodRate[positionTy::LAT] * dt;
+    ppos.lon()   = lodPos.lon()   + lodRate[positionTy::LON] * dt;
+    ppos.alt_m() = lodPos.alt_m() + lodRate[positionTy::ALT] * dt;
+    ppos.ts()    = currCycle.simTime;
+    ppos.normalize();
+}
+
 //
 //MARK: XPMP Aircraft Updates (callbacks)
 //
@@ -1659,35 +2106,34 @@ std::string LTAircraft::GetLightsStr() const
 //
 XPMPPlaneCallbackResult LTAircraft::GetPlanePosition(XPMPPlanePosition_t* outPosition)
 {
+    GovFrameCostTy govCost;
     try {
         // object invalid (due to exceptions most likely), don't use anymore, don't call LT functions
         if (!IsValid())
             return xpmpData_Unavailable;
         
-        // We (LT) don't get called anywhere else once per frame.
-        // XPMP API calls directly for aircraft positions.
-        // So we need to figure out our way if we are called the first time of a cycle
-        int cycle = XPLMGetCycleNumber();
-        if ( cycle != currCycle.num )            // new cycle!
-            NextCycle(cycle);
+        // Usually the batch update ran already in this cycle from the
+        // flight loop callback. If not (e.g. when X-Plane is paused)
+        // the first callback of a cycle triggers it.
+        UpdateAll();
         
-        // calculate new position and return it
-        if (!dataRefs.IsReInitAll() &&          // avoid any calc if to be re-initialized
-            CalcPPos())
+        // copy this frame's position (calculated in CalcFrameCompute)
+        const XPMPPlaneCallbackResult res = acFrameData.vPosRes[frameIdx];
+        if (res == xpmpData_Unavailable)
+            return res;
+        acFrameData.Get(frameIdx, *outPosition);
+        
+        // with new data add the label
+        if (res == xpmpData_NewData)
         {
-            *outPosition = ppos;                // copy ppos (by type conversion), and add the label
             memcpy(outPosition->label, szLabelAc, sizeof(outPosition->label));
             // color depends on setting and maybe model
             if (dataRefs.IsLabelColorDynamic())
                 memmove(outPosition->label_color, mdl.LABEL_COLOR, sizeof(outPosition->label_color));
             else
                 dataRefs.GetLabelColor(outPosition->label_color);
-            return xpmpData_NewData;
         }
-
-        // no new position available...what a shame, return the last one
-        *outPosition = ppos;
-        return xpmpData_Unchanged;
+        return res;
 
     } catch (const std::exception& e) {
         LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
@@ -1700,20 +2146,17 @@ XPMPPlaneCallbackResult LTAircraft::GetPlanePosition(XPMPPlanePosition_t* outPos
 
 XPMPPlaneCallbackResult LTAircraft::GetPlaneSurfaces(XPMPPlaneSurfaces_t* outSurfaces)
 {
+    GovFrameCostTy govCost;
     try {
         // object invalid (due to exceptions most likely), don't use anymore, don't call LT functions
         if (!IsValid())
             return xpmpData_Unavailable;
         
-        
-        if (!dataRefs.IsReInitAll()) {
-            // get current gear/flaps value (might be moving)
-            surfaces.gearPosition = (float)gear.get();
-            surfaces.flapRatio = (float)flaps.get();
-        }
-        
         // just copy over our entire structure
+        // with this frame's gear/flaps values (calculated in CalcFrameCompute)
         *outSurfaces = surfaces;
+        outSurfaces->gearPosition = acFrameData.vGear[frameIdx];
+        outSurfaces->flapRatio    = acFrameData.vFlaps[frameIdx];
         
         return xpmpData_NewData;
 
@@ -1728,26 +2171,13 @@ XPMPPlaneCallbackResult LTAircraft::GetPlaneSurfaces(XPMPPlaneSurfaces_t* outSur
 
 XPMPPlaneCallbackResult LTAircraft::GetPlaneRadar(XPMPPlaneRadar_t* outRadar)
 {
+    GovFrameCostTy govCost;
     try {
         // object invalid (due to exceptions most likely), don't use anymore, don't call LT functions
         if (!IsValid())
             return xpmpData_Unavailable;
         
-        // for radar 'calculation' we need some dynData
-        // but radar doesn't change often...just only check every 100th cycle
-        if (!dataRefs.IsReInitAll() &&
-            currCycle.num % 100 == 0 )
-        {
-            // fetch new data if available
-            LTFlightData::FDDynamicData dynCopy;
-            if ( fd.TryGetSafeCopy(dynCopy) )
-            {
-                // copy fresh radar data
-                radar               = dynCopy.radar;
-            }
-        }
-        
-        // GetPlaneSurfaces fetches fresh data every 10th cycle
+        // CalcFrameCompute fetches fresh data every 100th cycle
         // just copy over our entire structure
         *outRadar = radar;
         
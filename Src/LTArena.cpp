@@ -0,0 +1,150 @@
+//
+//  LTArena.cpp
+//  LiveTraffic
+
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "LiveTraffic.h"
+
+//
+//MARK: Globals
+//
+
+// the arena of the innermost active scope on this thread
+thread_local LTArena* pThreadArena = nullptr;
+
+void* ArenaMalloc (size_t size)
+{
+    return pThreadArena ? pThreadArena->Alloc(size) : malloc(size);
+}
+
+void ArenaFree (void* p)
+{
+    if (p && (!pThreadArena || !pThreadArena->Free(p)))
+        free(p);
+}
+
+void ArenaInit ()
+{
+    json_set_allocation_functions(ArenaMalloc, ArenaFree);
+}
+
+//
+//MARK: LTArena
+//
+
+// all allocations are aligned like malloc does
+constexpr size_t ARENA_ALIGN = alignof(std::max_align_t);
+
+LTArena::~LTArena ()
+{
+    for (chunkTy& c: vChunks)
+        free(c.pMem);
+}
+
+void* LTArena::Alloc (size_t size)
+{
+    size = size ? (size + ARENA_ALIGN-1) & ~(ARENA_ALIGN-1) : ARENA_ALIGN;
+    
+    // find a chunk with enough room, starting with the current one
+    while (currChunk < vChunks.size() &&
+           vChunks[currChunk].size - currPos < size)
+    {
+        currChunk++;
+        currPos = 0;
+    }
+    
+    // need a new one? (twice the size of the previous one)
+    if (currChunk >= vChunks.size()) {
+        size_t chunkSize = vChunks.empty() ? ARENA_CHUNK_INIT :
+                           std::min(vChunks.back().size * 2, ARENA_CHUNK_MAX);
+        chunkSize = std::max(chunkSize, size);
+        char* pMem = (char*)malloc(chunkSize);
+        if (!pMem)
+            return nullptr;
+        vChunks.push_back({pMem, chunkSize});
+        stat.nChunks++;
+        stat.capacity += chunkSize;
+        currChunk = vChunks.size() - 1;
+        currPos = 0;
+    }
+    
+    // bump
+    pLast = vChunks[currChunk].pMem + currPos;
+    lastPos = currPos;
+    currPos += size;
+    bytesCycle += size;
+    stat.nAlloc++;
+    return pLast;
+}
+
+bool LTArena::Free (void* p)
+{
+    if (!Owns(p))
+        return false;
+    
+    // parson often frees what it just allocated (growing arrays),
+    // that we can take back
+    if (p == pLast) {
+        bytesCycle -= currPos - lastPos;
+        currPos = lastPos;
+        pLast = nullptr;
+        stat.nGiveBack++;
+    }
+    return true;
+}
+
+void LTArena::Reset ()
+{
+    stat.nCycles++;
+    stat.bytesPeak = std::max(stat.bytesPeak, bytesCycle);
+    bytesCycle = 0;
+    currChunk = currPos = lastPos = 0;
+    pLast = nullptr;
+}
+
+// only chunks used in this cycle can hold p
+bool LTArena::Owns (const void* p) const
+{
+    const char* pc = static_cast<const char*>(p);
+    for (size_t i = 0; i <= currChunk && i < vChunks.size(); i++)
+        if (vChunks[i].pMem <= pc && pc < vChunks[i].pMem + vChunks[i].size)
+            return true;
+    return false;
+}
+
+//
+//MARK: LTArenaScope
+//
+
+LTArenaScope::LTArenaScope (LTArena& a) :
+arena(a), pPrevArena(pThreadArena)
+{
+    pThreadArena = &arena;
+}
+
+LTArenaScope::~LTArenaScope ()
+{
+    arena.Reset();
+    pThreadArena = pPrevArena;
+}
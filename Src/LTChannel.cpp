@@ -50,6 +50,7 @@ std::thread CalcPosThread;              // the thread for pos calc (TriggerCalcN
 std::mutex  FDThreadSynchMutex;         // supports wake-up and stop synchronization
 std::condition_variable FDThreadSynchCV;
 volatile bool bFDMainStop = true;       // will be reset once the main thread starts
+bool bFDSynchronous = false;            // headless drivers: no threads, driver calls the cycles
 
 // the global vector of all flight and master data connections
 listPtrLTChannelTy    listFDC;
@@ -130,7 +131,15 @@ double jag_n_nan (const JSON_Array *array, size_t idx)
 //
 
 LTChannel::~LTChannel ()
-{}
+{
+    // how did the JSON arena do?
+    const arenaStatTy& aStat = jsonArena.GetStat();
+    if (aStat.nAlloc)
+        LOG_MSG(logDEBUG, DBG_ARENA_STAT, ChName(),
+                aStat.nCycles, aStat.nAlloc, aStat.nGiveBack,
+                (unsigned long)aStat.bytesPeak,
+                (unsigned long)aStat.capacity, aStat.nChunks);
+}
 
 const char* LTChannel::ChId2String (dataRefsLT ch)
 {
@@ -143,6 +152,14 @@ const char* LTChannel::ChId2String (dataRefsLT ch)
             return OPSKY_NAME;
         case DR_CHANNEL_OPEN_SKY_AC_MASTERDATA:
             return OPSKY_MD_NAME;
+        case DR_CHANNEL_REPLAY:
+            return REPLAY_NAME;
+        case DR_CHANNEL_SBS_TCP:
+            return SBS_NAME;
+        case DR_CHANNEL_ADSB_EXCHANGE_STREAM:
+            return ADSBEX_STREAM_NAME;
+        case DR_CHANNEL_SYNTHETIC:
+            return SYNTH_NAME;
         default:
             return ERR_CH_UNKNOWN_NAME;
     }
@@ -263,14 +280,12 @@ void LTACMasterdataChannel::CopyGlobalRequestList ()
 //MARK: LTOnlineChannel
 //
 
-// the one (hence static) output file for logging raw network data
-std::ofstream LTOnlineChannel::outRaw;
-
 LTOnlineChannel::LTOnlineChannel () :
 pCurl(NULL),
 netData((char*)malloc(CURL_MAX_WRITE_SIZE)),      // initial buffer allocation
 netDataPos(0), netDataSize(CURL_MAX_WRITE_SIZE),
-curl_errtxt{0}, httpResponse(HTTP_OK)
+curl_errtxt{0}, httpResponse(HTTP_OK),
+tsCapBase(0.0), tsReplayBase(0.0), tsSpeed(1.0)
 {
     // initialize a CURL handle
     SetValid(InitCurl());
@@ -279,7 +294,10 @@ curl_errtxt{0}, httpResponse(HTTP_OK)
 LTOnlineChannel::~LTOnlineChannel ()
 {
     CleanupCurl();
-    if ( netData )
+    // a buffer still shared with the recorder is freed by whoever is last
+    if ( netDataRec )
+        netDataRec.reset();
+    else if ( netData )
         free ( netData );
 }
 
@@ -346,48 +364,15 @@ size_t LTOnlineChannel::ReceiveData(const char *ptr, size_t size, size_t nmemb,
     return realsize;
 }
 
-// debug: log raw network data to a log file
-void LTOnlineChannel::DebugLogRaw(const char *data)
+// debug: hand the response over to the raw data recorder
+// The recorder takes shared ownership of netData, so there is no copy.
+// The next request gets a fresh buffer, see FetchAllData.
+void LTOnlineChannel::RecordRawResponse ()
 {
-    // no logging? return (after closing the file if open)
-    if (!dataRefs.GetDebugLogRawFD()) {
-        if (outRaw.is_open()) {
-            outRaw.close();
-            SHOW_MSG(logWARN, DBG_RAW_FD_STOP, PATH_DEBUG_RAW_FD);
-        }
+    if (!RawRecIsActive())
         return;
-    }
-    
-    // logging enabled. Need to open the file first?
-    if (!outRaw.is_open()) {
-        // open the file, append to it
-        std::string sFileName (LTCalcFullPath(PATH_DEBUG_RAW_FD));
-        outRaw.open (sFileName, std::ios_base::out | std::ios_base::app);
-        if (!outRaw) {
-            char sErr[SERR_LEN];
-            strerror_s(sErr, sizeof(sErr), errno);
-            // could not open output file: bail out, decativate logging
-            SHOW_MSG(logERR, DBG_RAW_FD_ERR_OPEN_OUT,
-                     sFileName.c_str(), sErr);
-            dataRefs.SetDebugLogRawFD(false);
-            return;
-        }
-        SHOW_MSG(logWARN, DBG_RAW_FD_START, PATH_DEBUG_RAW_FD);
-    }
-    
-    // timestamp (numerical and human readable)
-    outRaw
-    << std::fixed << dataRefs.GetSimTime()
-    << " - "
-    << dataRefs.GetSimTimeString()
-    << " - "
-    // Channel's name
-    << ChName()
-    << "\n"
-    // the actual given data
-    << data
-    // 2 newlines + flush
-    << "\n" << std::endl;
+    netDataRec = std::shared_ptr<char>(netData, free);
+    RawRecResponse(channel, httpResponse, netDataRec, netDataPos);
 }
 
 // fetch flight data from internet (takes time!)
@@ -405,6 +390,15 @@ bool LTOnlineChannel::FetchAllData (const positionTy& pos)
     if (url.empty())
         return false;
     
+    // last response buffer still with the recorder? Then start a new one
+    if (netDataRec) {
+        netDataRec.reset();
+        netDataSize = CURL_MAX_WRITE_SIZE;
+        netData = (char*)malloc(netDataSize);
+        if ( !netData )
+        {LOG_MSG(logFATAL,ERR_MALLOC,netDataSize); SetValid(false); return false;}
+    }
+    
     // put together the REST request
     curl_easy_setopt(pCurl, CURLOPT_URL, url.c_str());
     curl_easy_setopt(pCurl, CURLOPT_BUFFERSIZE, netDataSize );
@@ -416,7 +410,8 @@ bool LTOnlineChannel::FetchAllData (const positionTy& pos)
     netDataPos = 0;                 // fill buffer from beginning
     netData[0] = 0;
     LOG_MSG(logDEBUG,DBG_SENDING_HTTP,ChName(),url.c_str());
-    DebugLogRaw(url.c_str());
+    if (RawRecIsActive())
+        RawRecUrl(channel, url);
     if ( (cc=curl_easy_perform(pCurl)) != CURLE_OK )
     {
         // problem with querying revocation list?
@@ -456,13 +451,43 @@ bool LTOnlineChannel::FetchAllData (const positionTy& pos)
             LOG_MSG(logWARN,ERR_CURL_HTTP_RESP,ChName(),httpResponse);
     }
     
-    // if requested log raw data received
-    DebugLogRaw(netData);
+    // if requested record raw data received
+    RecordRawResponse();
     
     // success
     return true;
 }
 
+// processes recorded data as if it had just been received,
+// with all position timestamps mapped by MapTs
+bool LTOnlineChannel::ProcessRecordedData (const std::string& data, long httpStatus,
+                                           double capBase, double replayBase, double speed,
+                                           mapLTFlightDataTy& fdMap)
+{
+    // copy data into the response buffer, extend it if needed
+    const size_t requBufSize = data.length() + 1;
+    if ( requBufSize > netDataSize )
+    {
+        while ( requBufSize > netDataSize ) netDataSize += CURL_MAX_WRITE_SIZE;
+        netData = (char*)realloc(netData, netDataSize);
+        if ( !netData )
+        {LOG_MSG(logFATAL,ERR_MALLOC,netDataSize); SetValid(false); return false;}
+    }
+    memcpy(netData, data.data(), data.length());
+    netDataPos = data.length();
+    netData[netDataPos] = 0;
+    httpResponse = httpStatus;
+    
+    // process it
+    tsCapBase = capBase;
+    tsReplayBase = replayBase;
+    tsSpeed = speed;
+    const bool bRet = ProcessFetchedData(fdMap);
+    tsCapBase = tsReplayBase = 0.0;
+    tsSpeed = 1.0;
+    return bRet;
+}
+
 //
 //MARK: LTFileChannel
 //
@@ -471,6 +496,153 @@ LTFileChannel::LTFileChannel () :
 zuluLastRead(0)
 {}
 
+//
+//MARK: LTStreamChannel
+//
+
+LTStreamChannel::LTStreamChannel () :
+pCurl(NULL), curl_errtxt{0}, bStopStream(false), bStreamRunning(false)
+{}
+
+LTStreamChannel::~LTStreamChannel ()
+{
+    Stop();
+}
+
+// called by the network thread: remember the view position,
+// make sure the stream thread runs
+bool LTStreamChannel::FetchAllData (const positionTy& pos)
+{
+    {
+        std::lock_guard<std::mutex> lock (posViewMutex);
+        posView = pos;
+    }
+    
+    // (re)start the stream thread if it doesn't run (any longer)
+    if ( !bStreamRunning ) {
+        if ( thrStream.joinable() )
+            thrStream.join();
+        bStopStream = false;
+        bStreamRunning = true;
+        thrStream = std::thread (&LTStreamChannel::StreamMain, this);
+    }
+    return true;
+}
+
+// stop the stream thread and wait for it
+void LTStreamChannel::Stop ()
+{
+    if ( thrStream.joinable() ) {
+        bStopStream = true;
+        thrStream.join();
+        thrStream = std::thread();
+    }
+}
+
+// the view position as last passed in by the network thread
+positionTy LTStreamChannel::GetViewPos ()
+{
+    std::lock_guard<std::mutex> lock (posViewMutex);
+    return posView;
+}
+
+// open the TCP connection (CURL connect-only, no protocol on top)
+bool LTStreamChannel::StreamConnect ()
+{
+    StreamDisconnect();
+    streamHost = GetStreamHost();
+    
+    pCurl = curl_easy_init();
+    if ( !pCurl ) {
+        LOG_MSG(logERR,ERR_CURL_EASY_INIT);
+        return false;
+    }
+    curl_easy_setopt(pCurl, CURLOPT_ERRORBUFFER, curl_errtxt);
+    curl_easy_setopt(pCurl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(pCurl, CURLOPT_CONNECT_ONLY, 1L);
+    curl_easy_setopt(pCurl, CURLOPT_CONNECTTIMEOUT, STREAM_CONNECT_TIMEOUT);
+    curl_easy_setopt(pCurl, CURLOPT_URL, ("http://" + streamHost).c_str());
+    curl_errtxt[0] = 0;
+    if ( curl_easy_perform(pCurl) != CURLE_OK ) {
+        SHOW_MSG(logERR, ERR_STREAM_CONNECT, ChName(), streamHost.c_str(), curl_errtxt);
+        StreamDisconnect();
+        return false;
+    }
+    
+    SHOW_MSG(logINFO, STREAM_CONNECTED, ChName(), streamHost.c_str());
+    streamBuf.clear();
+    StreamReset();
+    return true;
+}
+
+void LTStreamChannel::StreamDisconnect ()
+{
+    if ( pCurl ) {
+        curl_easy_cleanup(pCurl);
+        pCurl = NULL;
+    }
+}
+
+// the receiving thread: (re)connects, receives, and has data processed
+// until stopped, the network thread stops, or the channel gets disabled
+void LTStreamChannel::StreamMain ()
+{
+    char buf[CURL_MAX_WRITE_SIZE];
+    while ( !bStopStream && !bFDMainStop && IsEnabled() )
+    {
+        // LiveTraffic Top Level Exception Handling
+        try {
+            // need to (re)connect?
+            if ( !pCurl && !StreamConnect() ) {
+                if ( !IncErrCnt() )
+                    break;
+                // wait a bit before trying again
+                for ( int i = 0;
+                      i < STREAM_RECONNECT_INTVL * 1000 / STREAM_POLL_MS &&
+                      !bStopStream && !bFDMainStop;
+                      i++ )
+                    std::this_thread::sleep_for(std::chrono::milliseconds(STREAM_POLL_MS));
+                continue;
+            }
+            
+            // receive whatever is there
+            size_t n = 0;
+            const CURLcode cc = curl_easy_recv(pCurl, buf, sizeof(buf), &n);
+            if ( cc == CURLE_AGAIN ) {
+                // nothing there: give processing a chance anyway, then wait
+                ProcessStreamData(mapFd);
+                std::this_thread::sleep_for(std::chrono::milliseconds(STREAM_POLL_MS));
+                continue;
+            }
+            if ( cc != CURLE_OK || n == 0 ) {
+                // connection closed or broken: reconnect next time
+                SHOW_MSG(logWARN, ERR_STREAM_CLOSED, ChName(), streamHost.c_str(),
+                         cc == CURLE_OK ? "closed by peer" : curl_easy_strerror(cc));
+                StreamDisconnect();
+                IncErrCnt();
+                continue;
+            }
+            
+            // process what we received
+            streamBuf.append(buf, n);
+            if ( ProcessStreamData(mapFd) )
+                DecErrCnt();
+            else
+                IncErrCnt();
+        } catch (const std::exception& e) {
+            LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+            // in case of any exception disable this channel
+            SetValid(false, true);
+        } catch (...) {
+            // in case of any exception disable this channel
+            SetValid(false, true);
+        }
+    }
+    
+    StreamDisconnect();
+    bStreamRunning = false;
+}
+
 //
 //MARK: OpenSky
 //
@@ -499,41 +671,25 @@ bool OpenSkyConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
     // short-cut if there is nothing
     if ( !netDataPos ) return true;
     
-    // now try to interpret it as JSON
-    JSON_Value* pRoot = json_parse_string(netData);
-    if (!pRoot) { LOG_MSG(logERR,ERR_JSON_PARSE); IncErrCnt(); return false; }
-    
-    // let's cycle the aircrafts
-    // first get the structre's main object, then its aircraft array
-    JSON_Object* pObj = json_object(pRoot);
-    if (!pObj) { LOG_MSG(logERR,ERR_JSON_MAIN_OBJECT); IncErrCnt(); return false; }
-    JSON_Array* pJAcList = json_object_get_array(pObj, OPSKY_AIRCRAFT_ARR);
-    if (!pJAcList) {
-        // a/c array not found: can just mean it is 'null' as in
-        // the empty result set: {"time":1541978120,"states":null}
-        JSON_Value* pJSONVal = json_object_get_value(pObj, OPSKY_AIRCRAFT_ARR);
-        if (!pJSONVal || json_type(pJSONVal) != JSONNull) {
-            // well...it is something else, so it is malformed, bail out
+    // decode all state vectors in one pass straight into vStates
+    // (see LTJsonScan.cpp, no DOM is built),
+    // "states":null, the empty result set, is fine
+    OpenSkyDecoder dec (netData, netDataPos);
+    if (!dec.DecodeStates(vStates)) {
+        if (dec.IsError()) {
+            LOG_MSG(logERR,ERR_JSON_PARSE);
+        } else {
             LOG_MSG(logERR,ERR_JSON_ACLIST,OPSKY_AIRCRAFT_ARR);
-            IncErrCnt();
-            return false;
         }
+        IncErrCnt();
+        return false;
     }
+    
     // iterate all aircrafts in the received flight data (can be 0)
-    else for ( int i=0; i < json_array_get_count(pJAcList); i++ )
+    for (const OpenSkyStateTy& st: vStates)
     {
-        // get the aircraft (which is just an array of values)
-        JSON_Array* pJAc = json_array_get_array(pJAcList,i);
-        if (!pJAc) {
-            LOG_MSG(logERR,ERR_JSON_AC,i+1,OPSKY_AIRCRAFT_ARR);
-            if (IncErrCnt())
-                continue;
-            else
-                return false;
-        }
-        
         // the key: transponder Icao code
-        std::string transpIcao (jag_s(pJAc, OPSKY_TRANSP_ICAO) );
+        std::string transpIcao (st.transpIcao);
         str_toupper(transpIcao);
         
         // not matching a/c filter? -> skip it
@@ -542,6 +698,11 @@ bool OpenSkyConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
             continue;
         }
         
+        // redundant, like the same a/c delivered by a higher-priority channel?
+        // -> skip it before creating or updating an fd object
+        if (LTFlightData::IsRedundantUpdate(transpIcao, this, MapTs(st.posTime)))
+            continue;
+        
         try {
             // from here on access to fdMap guarded by a mutex
             // until FD object is inserted and updated
@@ -562,11 +723,9 @@ bool OpenSkyConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
             // fill static data
             {
                 LTFlightData::FDStaticData stat;
-                stat.country =    jag_s(pJAc, OPSKY_COUNTRY);
+                stat.country =    st.country;
                 stat.trt     =    trt_ADS_B_unknown;
-                stat.call    =    jag_s(pJAc, OPSKY_CALL);
-                while (!stat.call.empty() && stat.call.back() == ' ')      // trim trailing spaces
-                    stat.call.pop_back();
+                stat.call    =    st.call;      // trailing spaces already trimmed
                 fd.UpdateData(std::move(stat));
             }
             
@@ -575,21 +734,21 @@ bool OpenSkyConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
                 LTFlightData::FDDynamicData dyn;
                 
                 // position time
-                double posTime = jag_n(pJAc, OPSKY_POS_TIME);
+                double posTime = MapTs(st.posTime);
                 
                 // non-positional dynamic data
-                dyn.radar.code =  (long)jag_sn(pJAc, OPSKY_RADAR_CODE);
-                dyn.gnd =               jag_b(pJAc, OPSKY_GND);
-                dyn.heading =           jag_n_nan(pJAc, OPSKY_HEADING);
-                dyn.spd =               jag_n(pJAc, OPSKY_SPD);
-                dyn.vsi =               jag_n(pJAc, OPSKY_VSI);
+                dyn.radar.code =  (long)st.radarCode;
+                dyn.gnd =               st.gnd;
+                dyn.heading =           st.heading;
+                dyn.spd =               st.spd;
+                dyn.vsi =               st.vsi;
                 dyn.ts =                posTime;
                 dyn.pChannel =          this;
                 
                 // position
-                positionTy pos (jag_n_nan(pJAc, OPSKY_LAT),
-                                jag_n_nan(pJAc, OPSKY_LON),
-                                jag_n_nan(pJAc, OPSKY_ELEVATION),
+                positionTy pos (st.lat,
+                                st.lon,
+                                st.alt,
                                 posTime);
                 pos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
                 
@@ -605,9 +764,6 @@ bool OpenSkyConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
         }
     }
     
-    // cleanup JSON
-    json_value_free (pRoot);
-    
     // success
     return true;
 }
@@ -635,38 +791,26 @@ bool ADSBExchangeConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
     // short-cut if there is nothing
     if ( !netDataPos ) return true;
     
-    // now try to interpret it as JSON
-    JSON_Value* pRoot = json_parse_string(netData);
-    if (!pRoot) { LOG_MSG(logERR,ERR_JSON_PARSE); IncErrCnt(); return false; }
-    
-    // let's cycle the aircrafts
-    // first get the structre's main object, then its aircraft array
-    JSON_Object* pObj = json_object(pRoot);
-    if (!pObj) { LOG_MSG(logERR,ERR_JSON_MAIN_OBJECT); IncErrCnt(); return false; }
-    JSON_Array* pJAcList = json_object_get_array(pObj, ADSBEX_AIRCRAFT_ARR);
-    if (!pJAcList) { LOG_MSG(logERR,ERR_JSON_ACLIST,ADSBEX_AIRCRAFT_ARR); IncErrCnt(); return false; }
+    // walk the JSON text once, decoding each aircraft straight into ac
+    // (see LTJsonScan.cpp, no DOM is built)
+    ADSBExDecoder dec (netData, netDataPos);
+    if (!dec.FindAcList()) { LOG_MSG(logERR,ERR_JSON_ACLIST,ADSBEX_AIRCRAFT_ARR); IncErrCnt(); return false; }
     
     // iterate all aircrafts in the received flight data (can be 0)
-    for ( int i=0; i < json_array_get_count(pJAcList); i++ )
+    ADSBExAcTy ac;
+    while (dec.NextAc(ac))
     {
-        // get the aircraft
-        JSON_Object* pJAc = json_array_get_object(pJAcList,i);
-        if (!pJAc) {
-            LOG_MSG(logERR,ERR_JSON_AC,i+1,ADSBEX_AIRCRAFT_ARR);
-            if (IncErrCnt())
-                continue;
-            else
-                return false;
-        }
-        
         // the key: transponder Icao code
-        std::string transpIcao ( jog_s(pJAc, ADSBEX_TRANSP_ICAO) );
+        std::string transpIcao ( ac.transpIcao );
         str_toupper(transpIcao);
         
         // data already stale? -> skip it
-        if ( jog_b(pJAc, ADSBEX_POS_STALE) ||
+        if ( ac.posStale ||
             // not matching a/c filter? -> skip it
-            (!acFilter.empty() && (acFilter != transpIcao)) )
+            (!acFilter.empty() && (acFilter != transpIcao)) ||
+            // redundant, like the same a/c delivered by a higher-priority channel?
+            // -> skip it before creating or updating an fd object
+            LTFlightData::IsRedundantUpdate(transpIcao, this, MapTs(ac.posTime / 1000.0)))
         {
             continue;
         }
@@ -691,38 +835,38 @@ bool ADSBExchangeConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
             // fill static data
             {
                 LTFlightData::FDStaticData stat;
-                stat.reg =        jog_s(pJAc, ADSBEX_REG);
-                stat.country =    jog_s(pJAc, ADSBEX_COUNTRY);
-                stat.acTypeIcao = jog_s(pJAc, ADSBEX_AC_TYPE_ICAO);
-                stat.man =        jog_s(pJAc, ADSBEX_MAN);
-                stat.mdl =        jog_s(pJAc, ADSBEX_MDL);
-                stat.year =  (int)jog_sn(pJAc, ADSBEX_YEAR);
-                stat.mil =        jog_b(pJAc, ADSBEX_MIL);
-                stat.trt          = transpTy(int(jog_n(pJAc,ADSBEX_TRT)));
-                stat.op =         jog_s(pJAc, ADSBEX_OP);
-                stat.opIcao =     jog_s(pJAc, ADSBEX_OP_ICAO);
-                stat.call =       jog_s(pJAc, ADSBEX_CALL);
+                stat.reg =        ac.reg;
+                stat.country =    ac.country;
+                stat.acTypeIcao = ac.acTypeIcao;
+                stat.man =        ac.man;
+                stat.mdl =        ac.mdl;
+                stat.year =  (int)ac.year;
+                stat.mil =        ac.mil;
+                stat.trt          = transpTy(int(ac.trt));
+                stat.op =         ac.op;
+                stat.opIcao =     ac.opIcao;
+                stat.call =       ac.call;
 
                 // try getting origin/destination
                 // FROM
-                std::string s = jog_s(pJAc, ADSBEX_ORIGIN);
-                if (s.length() == 4 ||          // extract 4 letter airport code from beginning
-                    (s.length() > 4 && s[4] == ' '))
-                    stat.originAp = s.substr(0,4);
+                const std::string& from = ac.origin;
+                if (from.length() == 4 ||       // extract 4 letter airport code from beginning
+                    (from.length() > 4 && from[4] == ' '))
+                    stat.originAp = from.substr(0,4);
                 // TO
-                s = jog_s(pJAc, ADSBEX_DESTINATION);
-                if (s.length() == 4 ||          // extract 4 letter airport code from beginning
-                    (s.length() > 4 && s[4] == ' '))
-                    stat.destAp = s.substr(0,4);
+                const std::string& to = ac.dest;
+                if (to.length() == 4 ||         // extract 4 letter airport code from beginning
+                    (to.length() > 4 && to[4] == ' '))
+                    stat.destAp = to.substr(0,4);
                 
                 // no type code?
                 if ( stat.acTypeIcao.empty() ) {
                     // could be a surface vehicle
                     // ADSBEx doesn't send a clear indicator, but data anyslsis
                     // suggests that EngType/Mount == 0 is a good indicator
-                    if (jog_b(pJAc, ADSBEX_GND)         == true &&
-                        jog_n(pJAc, ADSBEX_ENG_TYPE)    == 0    &&
-                        jog_n(pJAc, ADSBEX_ENG_MOUNT)    == 0)
+                    if (ac.gnd                  == true &&
+                        long(ac.engType)        == 0    &&
+                        long(ac.engMount)       == 0)
                         // assume surface vehicle
                         stat.acTypeIcao = dataRefs.GetDefaultCarIcaoType();
                     else
@@ -741,33 +885,33 @@ bool ADSBExchangeConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
                 LTFlightData::FDDynamicData dyn;
                 
                 // ADS-B returns Java tics, that is milliseconds, we use seconds
-                double posTime = jog_n(pJAc, ADSBEX_POS_TIME) / 1000.0;
+                double posTime = MapTs(ac.posTime / 1000.0);
                 
                 // non-positional dynamic data
-                dyn.radar.code =  (long)jog_sn(pJAc, ADSBEX_RADAR_CODE);
-                dyn.gnd =               jog_b(pJAc, ADSBEX_GND);
-                dyn.heading =           jog_n_nan(pJAc, ADSBEX_HEADING);
-                dyn.inHg =              jog_n(pJAc, ADSBEX_IN_HG);
-                dyn.brng =              jog_n(pJAc, ADSBEX_BRNG);
-                dyn.dst =               jog_n(pJAc, ADSBEX_DST);
-                dyn.spd =               jog_n(pJAc, ADSBEX_SPD);
-                dyn.vsi =               jog_n(pJAc, ADSBEX_VSI);
+                dyn.radar.code =  (long)ac.radarCode;
+                dyn.gnd =               ac.gnd;
+                dyn.heading =           ac.heading;
+                dyn.inHg =              ac.inHg;
+                dyn.brng =              ac.brng;
+                dyn.dst =               ac.dst;
+                dyn.spd =               ac.spd;
+                dyn.vsi =               ac.vsi;
                 dyn.ts =                posTime;
                 dyn.pChannel =          this;
                 
                 // position and its ground status
-                positionTy pos (jog_n_nan(pJAc, ADSBEX_LAT),
-                                jog_n_nan(pJAc, ADSBEX_LON),
+                positionTy pos (ac.lat,
+                                ac.lon,
                                 // ADSB data is feet, positionTy expects meter
-                                jog_n_nan(pJAc, ADSBEX_ELEVATION) * M_per_FT,
+                                ac.alt * M_per_FT,
                                 posTime);
                 pos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
                 
                 // position is rather important, we check for validity
                 if ( pos.isNormal(true) )
                     fd.AddDynData(dyn,
-                                  (int)jog_n(pJAc, ADSBEX_RCVR),
-                                  (int)jog_n(pJAc, ADSBEX_SIG),
+                                  (int)ac.rcvr,
+                                  (int)ac.sig,
                                   &pos);
                 else
                     LOG_MSG(logWARN,ERR_POS_UNNORMAL,transpIcao.c_str(),pos.dbgTxt().c_str());
@@ -777,13 +921,228 @@ bool ADSBExchangeConnection::ProcessFetchedData (mapLTFlightDataTy& fdMap)
         }
     }
     
-    // cleanup JSON
-    json_value_free (pRoot);
+    // text broken somewhere after the aircraft processed so far?
+    if (dec.IsError()) { LOG_MSG(logERR,ERR_JSON_PARSE); IncErrCnt(); return false; }
     
     // success
     return true;
 }
 
+//
+//MARK: ADS-B Exchange Stream
+//
+
+// host:port of the streaming feed
+std::string ADSBExchangeStream::GetStreamHost () const
+{
+    return dataRefs.GetAdsbexStreamHost();
+}
+
+// new connection: start scanning from scratch
+void ADSBExchangeStream::StreamReset ()
+{
+    scanPos = objStart = 0;
+    scanDepth = 0;
+    bScanInStr = bScanEsc = false;
+}
+
+// finds complete JSON objects in the data received so far and processes them,
+// keeps an incomplete last object for next time
+bool ADSBExchangeStream::ProcessStreamData (mapLTFlightDataTy& fdMap)
+{
+    using namespace std::chrono;
+    const double now = duration<double>(system_clock::now().time_since_epoch()).count();
+    bool bRet = true;
+    
+    // parson allocates from our arena, reset when done
+    LTArenaScope arenaScope (jsonArena);
+    
+    // continue scanning where we stopped last time
+    for (; scanPos < streamBuf.size(); scanPos++)
+    {
+        const char c = streamBuf[scanPos];
+        if (bScanInStr) {
+            if (bScanEsc)           bScanEsc = false;
+            else if (c == '\\')     bScanEsc = true;
+            else if (c == '"')      bScanInStr = false;
+            continue;
+        }
+        switch (c) {
+            case '"':
+                bScanInStr = true;
+                break;
+            case '{':
+                if (scanDepth++ == 0)
+                    objStart = scanPos;
+                break;
+            case '}':
+                if (scanDepth > 0 && --scanDepth == 0) {
+                    // complete object: terminate it in place for parsing
+                    // (the char after it is restored right afterwards)
+                    const char cNext = streamBuf[scanPos+1];
+                    streamBuf[scanPos+1] = '\0';
+                    bRet = ProcessObject(fdMap, streamBuf.data() + objStart, now) && bRet;
+                    streamBuf[scanPos+1] = cNext;
+                    objStart = scanPos+1;
+                }
+                break;
+        }
+    }
+    
+    // remove what's processed (or garbage outside of any object)
+    if (scanDepth == 0) {
+        streamBuf.clear();
+        scanPos = objStart = 0;
+    } else {
+        streamBuf.erase(0, objStart);
+        scanPos -= objStart;
+        objStart = 0;
+    }
+    
+    // forget aircraft we didn't hear of for long
+    for (auto iter = mapStreamAc.begin(); iter != mapStreamAc.end(); )
+        if (now - iter->second.lastMsg > dataRefs.GetAcOutdatedIntvl())
+            iter = mapStreamAc.erase(iter);
+        else
+            iter++;
+    
+    return bRet;
+}
+
+// processes one object of the stream, which is a list of changes
+bool ADSBExchangeStream::ProcessObject (mapLTFlightDataTy& fdMap, const char* sObj, double now)
+{
+    JSON_Value* pRoot = json_parse_string(sObj);
+    if (!pRoot) { LOG_MSG(logERR,ERR_JSON_PARSE); return false; }
+    JSON_Object* pObj = json_object(pRoot);
+    JSON_Array* pJAcList = pObj ? json_object_get_array(pObj, ADSBEX_AIRCRAFT_ARR) : nullptr;
+    if (!pJAcList) {
+        LOG_MSG(logERR,ERR_JSON_ACLIST,ADSBEX_AIRCRAFT_ARR);
+        json_value_free (pRoot);
+        return false;
+    }
+    
+    const positionTy viewPos = GetViewPos();
+    for ( size_t i=0; i < json_array_get_count(pJAcList); i++ )
+    {
+        const JSON_Object* pJAc = json_array_get_object(pJAcList,i);
+        if (pJAc)
+            ProcessAc(fdMap, pJAc, viewPos, now);
+    }
+    
+    json_value_free (pRoot);
+    return true;
+}
+
+// applies the changes of one aircraft
+void ADSBExchangeStream::ProcessAc (mapLTFlightDataTy& fdMap, const JSON_Object* pJAc,
+                                    const positionTy& viewPos, double now)
+{
+    // any a/c filter defined for debugging purposes?
+    std::string acFilter ( dataRefs.GetDebugAcFilter() );
+    
+    // the key: transponder Icao code
+    std::string transpIcao ( jog_s(pJAc, ADSBEX_TRANSP_ICAO) );
+    str_toupper(transpIcao);
+    if (transpIcao.empty() ||
+        (!acFilter.empty() && (acFilter != transpIcao)))
+        return;
+    
+    // merge changed dynamic fields into what we know
+    StreamAcTy& ac = mapStreamAc[transpIcao];
+    ac.lastMsg = now;
+    bool bNewPos = false;
+    JSON_Value* pVal = nullptr;
+    auto has = [pJAc,&pVal](const char* name)
+    { return !jog_is_null(pJAc, name, &pVal); };
+    if (has(ADSBEX_LAT))        { ac.lat = json_value_get_number(pVal); bNewPos = true; }
+    if (has(ADSBEX_LON))        { ac.lon = json_value_get_number(pVal); bNewPos = true; }
+    if (has(ADSBEX_ELEVATION))  { ac.alt_ft = json_value_get_number(pVal); bNewPos = true; }
+    else if (has(ADSBEX_ALT))   { ac.alt_ft = json_value_get_number(pVal); bNewPos = true; }
+    if (has(ADSBEX_HEADING))    ac.trk = json_value_get_number(pVal);
+    if (has(ADSBEX_SPD))        ac.spd = json_value_get_number(pVal);
+    if (has(ADSBEX_VSI))        ac.vsi = json_value_get_number(pVal);
+    if (has(ADSBEX_IN_HG))      ac.inHg = json_value_get_number(pVal);
+    if (has(ADSBEX_GND))        ac.gnd = json_value_get_boolean(pVal) > 0;
+    if (has(ADSBEX_RADAR_CODE)) ac.squawk = (long)jog_sn(pJAc, ADSBEX_RADAR_CODE);
+    // the position's own time if sent (Java tics, that is milliseconds),
+    // the changes-only stream often doesn't, then it's when we received it
+    const double posTime = has(ADSBEX_POS_TIME) ? json_value_get_number(pVal) / 1000.0 : now;
+    
+    // changed static fields (only filled fields are merged by UpdateData)
+    LTFlightData::FDStaticData stat;
+    stat.reg =        jog_s(pJAc, ADSBEX_REG);
+    stat.country =    jog_s(pJAc, ADSBEX_COUNTRY);
+    stat.acTypeIcao = jog_s(pJAc, ADSBEX_AC_TYPE_ICAO);
+    stat.man =        jog_s(pJAc, ADSBEX_MAN);
+    stat.mdl =        jog_s(pJAc, ADSBEX_MDL);
+    stat.year =  (int)jog_sn(pJAc, ADSBEX_YEAR);
+    stat.mil =        jog_b(pJAc, ADSBEX_MIL);
+    stat.trt          = transpTy(int(jog_n(pJAc,ADSBEX_TRT)));
+    stat.op =         jog_s(pJAc, ADSBEX_OP);
+    stat.opIcao =     jog_s(pJAc, ADSBEX_OP_ICAO);
+    stat.call =       jog_s(pJAc, ADSBEX_CALL);
+    const bool bNewStat =
+    !stat.reg.empty() || !stat.country.empty() || !stat.acTypeIcao.empty() ||
+    !stat.man.empty() || !stat.mdl.empty() || stat.year || stat.mil || stat.trt ||
+    !stat.op.empty() || !stat.opIcao.empty() || !stat.call.empty();
+    
+    // not (yet) a complete position? Already stale? Or redundant, like the
+    // same a/c delivered by a higher-priority channel?
+    positionTy pos (ac.lat, ac.lon, ac.alt_ft * M_per_FT, posTime);
+    if (bNewPos &&
+        (std::isnan(ac.lat) || std::isnan(ac.lon) || std::isnan(ac.alt_ft) ||
+         jog_b(pJAc, ADSBEX_POS_STALE) ||
+         pos.dist(viewPos) > dataRefs.GetFdStdDistance_m() ||
+         LTFlightData::IsRedundantUpdate(transpIcao, this, posTime)))
+        bNewPos = false;
+    // nothing to hand over? (then we don't even look into mapFd)
+    if (!bNewStat && !bNewPos)
+        return;
+    
+    try {
+        // from here on access to fdMap guarded by a mutex
+        // until FD object is inserted and updated
+        std::lock_guard<std::mutex> mapFdLock (mapFdMutex);
+        
+        // static data alone doesn't create an fd object
+        if (!bNewPos && fdMap.find(transpIcao) == fdMap.end())
+            return;
+        LTFlightData& fd = fdMap[transpIcao];
+        std::lock_guard<std::recursive_mutex> fdLock (fd.dataAccessMutex);
+        
+        // completely new? fill key fields
+        if ( fd.empty() )
+            fd.SetKey(transpIcao);
+        
+        if (bNewStat)
+            fd.UpdateData(std::move(stat));
+        
+        if (bNewPos) {
+            LTFlightData::FDDynamicData dyn;
+            dyn.radar.code  = ac.squawk;
+            dyn.gnd         = ac.gnd;
+            dyn.heading     = ac.trk;
+            dyn.inHg        = ac.inHg;
+            dyn.spd         = ac.spd;
+            dyn.vsi         = ac.vsi;
+            dyn.ts          = posTime;
+            dyn.pChannel    = this;
+            
+            pos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
+            if ( pos.isNormal(true) )
+                fd.AddDynData(dyn,
+                              (int)jog_n(pJAc, ADSBEX_RCVR),
+                              (int)jog_n(pJAc, ADSBEX_SIG),
+                              &pos);
+            else
+                LOG_MSG(logWARN,ERR_POS_UNNORMAL,transpIcao.c_str(),pos.dbgTxt().c_str());
+        }
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
+    }
+}
+
 //
 //MARK: ADS-B Exchange Historical Data
 //
@@ -1026,6 +1385,10 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
             // the line as read from the historic file
             std::string& ln = *lnIter;
             
+            // parson allocates from our arena, reset after each line
+            // (all lines of a file would add up to quite some memory)
+            LTArenaScope arenaScope (jsonArena);
+            
             // each individual line should work as a JSON object
             JSON_Value* pRoot = json_parse_string(ln.c_str());
             if (!pRoot) { LOG_MSG(logERR,ERR_JSON_PARSE); IncErrCnt(); return false; }
@@ -1092,6 +1455,9 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
         // add flight data to our processing
         for ( mapFDSelectionTy::value_type selVal: selMap )
         {
+            // parson allocates from our arena, reset after each line
+            LTArenaScope arenaScope (jsonArena);
+            
             // each individual line should work as a JSON object
             JSON_Value* pRoot = json_parse_string(selVal.second.ln.c_str());
             if (!pRoot) { LOG_MSG(logERR,ERR_JSON_PARSE); IncErrCnt(); return false; }
@@ -1201,10 +1567,9 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
                     // for later landing detection
                     mainPos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
                     
-                    // FIXME: Called from outside main thread,
-                    //        can produce wrong terrain alt (2 cases here)
-                    //        Probably: Just add positions and let updated
-                    //                  AppendNewPos / CalcNewPos do the job of landing detection
+                    // Called from outside main thread, so this only requests
+                    // a terrain probe (2 cases here), the actual ground status
+                    // is determined in AppendNewPos once the probe is done
                     fd.TryDeriveGrndStatus(mainPos);
                     
                     // Short Trails ("Cos" array), if available
@@ -1236,6 +1601,11 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
                             }
                         else
                             LOG_MSG(logERR,ADSBEX_HIST_TRAIL_ERR,transpIcao.c_str(),posTime);
+                        
+                        // trails are handed over as one batch, which must be sorted
+                        // (should already be, but we rely on it)
+                        if (!std::is_sorted(trails.cbegin(), trails.cend()))
+                            std::sort(trails.begin(), trails.end());
                     }
                     
                     // if we did find enough trails work on them
@@ -1303,6 +1673,7 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
                                 if (vsiBef < -(mdl.VSI_STABLE * Ms_per_FTm) && vsiBef < vsiDirectMain)
                                 {
                                     // reasonable negative VSI, which is less (steeper) than direct way down to mainPos
+                                    dequePositionTy batch;
                                     for(positionTy& posIter: trails) {
                                         // calc altitude based on vsiBef, as soon as we touch ground it will be normalized to terrain altitude
                                         posIter.alt_m() = refPos.alt_m() + vsiBef * (posIter.ts()-refPos.ts());
@@ -1311,8 +1682,9 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
                                         // only add pos if not off ground
                                         // (see above: airborne we don't want too many positions)
                                         if (posIter.onGrnd != positionTy::GND_OFF)
-                                            fd.AddNewPos(posIter);
+                                            batch.push_back(posIter);
                                     }
+                                    fd.AddNewPosBatch(batch);
                                     
                                     // we added trails, don't add any more
                                     bAddedTrails = true;
@@ -1337,8 +1709,8 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
                                     for(positionTy& posIter: trails) {
                                         posIter.alt_m() = refPos.alt_m() + altDiff * (posIter.ts()-refPos.ts()) / tsDiff;
                                         posIter.onGrnd = positionTy::GND_UNKNOWN;
-                                        fd.AddNewPos(posIter);
                                     }
+                                    fd.AddNewPosBatch(trails);
                                     bAddedTrails = true;
                                 }
                             }
@@ -1372,6 +1744,453 @@ bool ADSBExchangeHistorical::ProcessFetchedData (mapLTFlightDataTy& fdMap)
     return true;
 }
 
+//
+//MARK: SBS-1 BaseStation
+//
+
+// host:port of the local receiver's BaseStation output
+std::string SBSConnection::GetStreamHost () const
+{
+    return dataRefs.GetSbsHost();
+}
+
+// processes all complete lines received so far,
+// hands over merged updates every SBS_FLUSH_INTVL
+bool SBSConnection::ProcessStreamData (mapLTFlightDataTy& fdMap)
+{
+    // current time as epoch seconds, this is when we received the data
+    using namespace std::chrono;
+    const double now = duration<double>(system_clock::now().time_since_epoch()).count();
+    
+    // process all complete lines, keep the incomplete rest
+    size_t b = 0;
+    for (size_t e = streamBuf.find('\n');
+         e != std::string::npos;
+         b = e+1, e = streamBuf.find('\n', b))
+    {
+        std::string ln (streamBuf, b, e-b);
+        if (!ln.empty() && ln.back() == '\r')
+            ln.pop_back();
+        ProcessMsg(ln, now);
+    }
+    streamBuf.erase(0, b);
+    
+    // time to hand over?
+    if (now - lastFlush >= SBS_FLUSH_INTVL) {
+        Flush(fdMap, now);
+        lastFlush = now;
+    }
+    return true;
+}
+
+// merges one BaseStation message into what we know about the aircraft
+void SBSConnection::ProcessMsg (const std::string& ln, double now)
+{
+    std::vector<std::string> tok = str_tokenize(ln, ",", false);
+    if (tok.size() <= SBS_LON || tok[0] != SBS_MSG)
+        return;
+    
+    // the key: transponder Icao code
+    std::string transpIcao (tok[SBS_HEX_IDENT]);
+    str_toupper(transpIcao);
+    if (transpIcao.empty())
+        return;
+    
+    // fields are filled only if the message type carries them
+    auto num = [&tok](int i)
+    { return i < (int)tok.size() && !tok[i].empty() ? std::strtod(tok[i].c_str(), nullptr) : NAN; };
+    
+    SBSAcTy& ac = mapSbsAc[transpIcao];
+    ac.lastMsg = now;
+    if ((int)tok.size() > SBS_CALL && !tok[SBS_CALL].empty()) {
+        std::string call (tok[SBS_CALL]);
+        while (!call.empty() && call.back() == ' ')     // trim trailing spaces
+            call.pop_back();
+        if (call != ac.call) {
+            ac.call = call;
+            ac.bNewStat = true;
+        }
+    }
+    double d;
+    if (!std::isnan(d = num(SBS_ALT)))      ac.alt_ft = d;
+    if (!std::isnan(d = num(SBS_SPD)))      ac.spd = d;
+    if (!std::isnan(d = num(SBS_TRACK)))    ac.trk = d;
+    if (!std::isnan(d = num(SBS_VSI)))      ac.vsi = d;
+    if (!std::isnan(d = num(SBS_SQUAWK)))   ac.squawk = long(d);
+    if (!std::isnan(d = num(SBS_GND)))      ac.gnd = long(d) != 0;
+    
+    // a new position?
+    const double lat = num(SBS_LAT);
+    const double lon = num(SBS_LON);
+    if (!std::isnan(lat) && !std::isnan(lon)) {
+        ac.lat = lat;
+        ac.lon = lon;
+        ac.posTs = now;
+        ac.bNewPos = true;
+    }
+}
+
+// hands over the latest position of each aircraft with news
+void SBSConnection::Flush (mapLTFlightDataTy& fdMap, double now)
+{
+    // any a/c filter defined for debugging purposes?
+    std::string acFilter ( dataRefs.GetDebugAcFilter() );
+    const positionTy viewPos = GetViewPos();
+    
+    for (auto iter = mapSbsAc.begin(); iter != mapSbsAc.end(); )
+    {
+        const std::string& transpIcao = iter->first;
+        SBSAcTy& ac = iter->second;
+        
+        // not heard of for a long time? forget it
+        if (now - ac.lastMsg > dataRefs.GetAcOutdatedIntvl()) {
+            iter = mapSbsAc.erase(iter);
+            continue;
+        }
+        
+        // nothing new, or no altitude yet, or filtered out,
+        // or redundant, like the same a/c delivered by a higher-priority channel? -> skip it
+        positionTy pos (ac.lat, ac.lon, ac.alt_ft * M_per_FT, ac.posTs);
+        if (!ac.bNewPos || std::isnan(ac.alt_ft) ||
+            (!acFilter.empty() && acFilter != transpIcao) ||
+            pos.dist(viewPos) > dataRefs.GetFdStdDistance_m() ||
+            LTFlightData::IsRedundantUpdate(transpIcao, this, ac.posTs))
+        {
+            iter++;
+            continue;
+        }
+        ac.bNewPos = false;
+        
+        try {
+            // from here on access to fdMap guarded by a mutex
+            // until FD object is inserted and updated
+            std::lock_guard<std::mutex> mapFdLock (mapFdMutex);
+            LTFlightData& fd = fdMap[transpIcao];
+            std::lock_guard<std::recursive_mutex> fdLock (fd.dataAccessMutex);
+            
+            // completely new? fill key fields
+            if ( fd.empty() )
+                fd.SetKey(transpIcao);
+            
+            // static data
+            if (ac.bNewStat) {
+                LTFlightData::FDStaticData stat;
+                stat.trt    = trt_ADS_B_unknown;
+                stat.call   = ac.call;
+                fd.UpdateData(std::move(stat));
+                ac.bNewStat = false;
+            }
+            
+            // dynamic data
+            LTFlightData::FDDynamicData dyn;
+            dyn.radar.code  = ac.squawk;
+            dyn.gnd         = ac.gnd;
+            dyn.heading     = ac.trk;
+            dyn.spd         = std::isnan(ac.spd) ? 0.0 : ac.spd;
+            dyn.vsi         = std::isnan(ac.vsi) ? 0.0 : ac.vsi;
+            dyn.ts          = ac.posTs;
+            dyn.pChannel    = this;
+            
+            pos.onGrnd = dyn.gnd ? positionTy::GND_ON : positionTy::GND_OFF;
+            if ( pos.isNormal(true) )
+                fd.AddDynData(dyn, 0, 0, &pos);
+            else
+                LOG_MSG(logWARN,ERR_POS_UNNORMAL,transpIcao.c_str(),pos.dbgTxt().c_str());
+        } catch(const std::system_error& e) {
+            LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
+        }
+        iter++;
+    }
+}
+
+//
+//MARK: Replay of recorded raw data
+//
+
+ReplayChannel::ReplayChannel (std::string path, std::string fallback) :
+LTChannel(DR_CHANNEL_REPLAY),
+LTFlightDataChannel(),
+pFile(NULL), bBinary(false), recHeadSize(sizeof(rawRecHeadTy)),
+bHaveRec(false), nextHead(), bRebase(true),
+capBase(0.0), replayBase(0.0), lastSpeed(-1), cntReplayed(0)
+{
+    // try the capture first, then the fallback
+    pathCapture = LTCalcFullPath(path);
+    if ( !OpenCapture() && !fallback.empty() ) {
+        pathCapture = LTCalcFullPath(fallback);
+        OpenCapture();
+    }
+    
+    if ( pFile ) {
+        SetValid(true);
+        char szSpeed[50];
+        if (dataRefs.GetReplaySpeed() > 0)
+            snprintf(szSpeed, sizeof(szSpeed), REPLAY_SPEED_X, dataRefs.GetReplaySpeed());
+        else
+            strcpy_s(szSpeed, sizeof(szSpeed), REPLAY_SPEED_AFAP);
+        SHOW_MSG(logINFO, REPLAY_STARTING, pathCapture.c_str(), szSpeed);
+    } else {
+        SetValid(false,false);
+        SHOW_MSG(logERR, REPLAY_NOT_FOUND, pathCapture.c_str());
+    }
+}
+
+ReplayChannel::~ReplayChannel ()
+{
+    CloseCapture();
+}
+
+// opens the capture and determines its format
+bool ReplayChannel::OpenCapture ()
+{
+    CloseCapture();
+    
+    // gzread reads uncompressed files just as well
+    pFile = gzopen(pathCapture.c_str(), "rb");
+    if ( !pFile )
+        return false;
+    
+    // binary captures start with a file header, anything else is a text log
+    char magic[sizeof(RAW_FILE_MAGIC)];
+    bBinary = gzread(pFile, magic, sizeof(magic)) == int(sizeof(magic)) &&
+              memcmp(magic, RAW_FILE_MAGIC, sizeof(magic)) == 0;
+    gzrewind(pFile);
+    bHaveRec = false;
+    bRebase = true;
+    return true;
+}
+
+void ReplayChannel::CloseCapture ()
+{
+    if ( pFile ) {
+        gzclose(pFile);
+        pFile = NULL;
+    }
+    bHaveRec = false;
+}
+
+// logs the error, closes the capture, returns false
+bool ReplayChannel::FormatError ()
+{
+    SHOW_MSG(logERR, REPLAY_ERR_FORMAT, pathCapture.c_str(), cntReplayed);
+    CloseCapture();
+    return false;
+}
+
+// reads one line from a text log, no matter how long it is
+bool ReplayChannel::ReadLine (std::string& ln)
+{
+    char buf[REPLAY_LN_CHUNK];
+    ln.clear();
+    while ( gzgets(pFile, buf, sizeof(buf)) )
+    {
+        ln += buf;
+        if ( !ln.empty() && ln.back() == '\n' ) {
+            ln.pop_back();
+            if ( !ln.empty() && ln.back() == '\r' )
+                ln.pop_back();
+            return true;
+        }
+    }
+    // last line might lack the newline
+    return !ln.empty();
+}
+
+// reads the next response record into nextHead/nextData,
+// returns false and closes the capture at its end
+bool ReplayChannel::ReadNextRec ()
+{
+    bHaveRec = false;
+    if ( !pFile )
+        return false;
+    
+    if ( bBinary ) for (;;)
+    {
+        // a record header...or the file header of the next recording session
+        char buf[256];
+        if ( gzread(pFile, buf, sizeof(RAW_FILE_MAGIC)) != int(sizeof(RAW_FILE_MAGIC)) )
+            break;                          // end of capture
+        if ( memcmp(buf, RAW_FILE_MAGIC, sizeof(RAW_FILE_MAGIC)) == 0 ) {
+            rawFileHeadTy fh;
+            memcpy(fh.magic, buf, sizeof(fh.magic));
+            const int rest = int(sizeof(fh) - sizeof(fh.magic));
+            if ( gzread(pFile, reinterpret_cast<char*>(&fh) + sizeof(fh.magic), rest) != rest ||
+                 fh.recHeadSize < sizeof(rawRecHeadTy) || fh.recHeadSize > sizeof(buf) )
+                return FormatError();
+            recHeadSize = fh.recHeadSize;
+            bRebase = true;
+            continue;
+        }
+        const int rest = int(recHeadSize - sizeof(RAW_FILE_MAGIC));
+        if ( gzread(pFile, buf + sizeof(RAW_FILE_MAGIC), rest) != rest )
+            return FormatError();
+        memcpy(&nextHead, buf, sizeof(nextHead));
+        nextData.resize(nextHead.len);
+        if ( nextHead.len && gzread(pFile, &nextData[0], nextHead.len) != int(nextHead.len) )
+            return FormatError();
+        
+        // only responses are replayed
+        if ( nextHead.type == RAW_REC_RESPONSE ) {
+            bHaveRec = true;
+            return true;
+        }
+    }
+    else for (;;)
+    {
+        // header line: "<sim time> - <sim time as text> - <channel name>"
+        std::string ln;
+        do {
+            if ( !ReadLine(ln) ) {
+                ln.clear();
+                break;
+            }
+        } while ( ln.empty() );
+        if ( ln.empty() )
+            break;                          // end of capture
+        const size_t posCh = ln.rfind(" - ");
+        if ( posCh == std::string::npos )
+            return FormatError();
+        nextHead = rawRecHeadTy();
+        nextHead.simTime    = std::strtod(ln.c_str(), nullptr);
+        nextHead.httpStatus = uint16_t(HTTP_OK);      // not logged in text logs
+        nextHead.chId       = UINT8_MAX;
+        for ( dataRefsLT ch: { DR_CHANNEL_OPEN_SKY_ONLINE, DR_CHANNEL_ADSB_EXCHANGE_ONLINE } )
+            if ( ln.compare(posCh + 3, std::string::npos, ChId2String(ch)) == 0 )
+                nextHead.chId = uint8_t(ch - DR_CHANNEL_FIRST);
+        
+        // data: all lines up to the next empty one
+        nextData.clear();
+        while ( ReadLine(ln) && !ln.empty() ) {
+            if ( !nextData.empty() )
+                nextData += '\n';
+            nextData += ln;
+        }
+        nextHead.len = uint32_t(nextData.length());
+        
+        // URLs had been logged the same way, only responses are replayed
+        if ( nextData.compare(0, 4, "http") != 0 ) {
+            nextHead.type = RAW_REC_RESPONSE;
+            bHaveRec = true;
+            return true;
+        }
+    }
+    
+    // end of capture
+    SHOW_MSG(logINFO, REPLAY_FINISHED, cntReplayed);
+    CloseCapture();
+    return false;
+}
+
+// anything left to replay?
+bool ReplayChannel::FetchAllData (const positionTy& /*pos*/)
+{
+    return pFile != NULL;
+}
+
+// feeds all responses through OpenSky/ADS-B Exchange processing,
+// which are due by now
+bool ReplayChannel::ProcessFetchedData (mapLTFlightDataTy& fdMap)
+{
+    const double simNow = dataRefs.GetSimTime();
+    const int speed = dataRefs.GetReplaySpeed();
+    if ( speed != lastSpeed ) {
+        // continue the mapping from the capture time reached by now
+        if ( !bRebase && lastSpeed >= 0 ) {
+            capBase += (simNow - replayBase) * (lastSpeed > 0 ? lastSpeed : 1);
+            replayBase = simNow;
+        }
+        lastSpeed = speed;
+    }
+    
+    while ( !bFDMainStop && (bHaveRec || ReadNextRec()) )
+    {
+        // (re)start the mapping of capture time to replay time
+        if ( bRebase ) {
+            capBase = nextHead.simTime;
+            replayBase = simNow;
+            bRebase = false;
+        }
+        
+        // one mapping of capture time to replay time for the whole session,
+        // applied to the responses as well as to all position timestamps:
+        // ts' = replayBase + (ts - capBase) / speed
+        if ( speed > 0 ) {
+            const double due = replayBase + (nextHead.simTime - capBase) / speed;
+            if ( due > simNow )
+                break;                      // not yet due, wait for next cycle
+        }
+        // as fast as possible: keep the original spacing, with positions
+        // lying in the future to be picked up as time passes
+        
+        // which channel would have processed this response?
+        LTOnlineChannel* pCh = nullptr;
+        switch ( DR_CHANNEL_FIRST + nextHead.chId ) {
+            case DR_CHANNEL_OPEN_SKY_ONLINE:        pCh = &opSky;   break;
+            case DR_CHANNEL_ADSB_EXCHANGE_ONLINE:   pCh = &adsbEx;  break;
+            default: break;                 // others can't be replayed
+        }
+        if ( pCh && nextHead.httpStatus == HTTP_OK ) {
+            pCh->ProcessRecordedData(nextData, nextHead.httpStatus,
+                                     capBase, replayBase, speed > 0 ? double(speed) : 1.0,
+                                     fdMap);
+            cntReplayed++;
+        }
+        bHaveRec = false;
+    }
+    
+    return true;
+}
+
+//
+//MARK: Synthetic traffic
+//
+
+SyntheticChannel::SyntheticChannel () :
+LTChannel(DR_CHANNEL_SYNTHETIC),
+LTFlightDataChannel()
+{
+    SetValid(true,false);
+}
+
+// advances the synthetic traffic to 'now' and formats the reports
+// sent on the way like an ADS-B Exchange response
+bool SyntheticChannel::FetchAllData (const positionTy& pos)
+{
+    // positions are generated up to 'now', i.e. ahead of sim time
+    // by the buffering period, just like live data
+    const double simNow = dataRefs.GetSimTime();
+    const double now = simNow + dataRefs.GetFdBufPeriod();
+    
+    // first call: create the traffic, starting a bit before sim time
+    // so that the aircraft have a few positions to start with
+    if ( !pTraffic ) {
+        vecSynthAreaTy vAreas;
+        SynthReadDensityMap(LTCalcFullPluginPath(SYNTH_DENSITY_PATH), vAreas);
+        pTraffic.reset(new SynthTraffic((unsigned)dataRefs.GetSynthSeed(),
+                                        dataRefs.GetSynthNumAc(),
+                                        vAreas, pos,
+                                        simNow - SYNTH_REPORT_INTVL));
+        SHOW_MSG(logINFO, SYNTH_STARTING,
+                 (int)pTraffic->GetNumFlights(), (int)pTraffic->GetNumAirports(),
+                 dataRefs.GetSynthSeed());
+    }
+    
+    vRpt.clear();
+    pTraffic->Advance(now, vRpt);
+    SynthWriteADSBEx(response, vRpt);
+    return true;
+}
+
+// feeds the generated response through ADS-B Exchange processing
+bool SyntheticChannel::ProcessFetchedData (mapLTFlightDataTy& fdMap)
+{
+    if ( response.empty() )
+        return true;
+    const bool bRet = adsbEx.ProcessRecordedData(response, HTTP_OK, 0.0, 0.0, 1.0, fdMap);
+    response.clear();
+    return bRet;
+}
+
 //
 //MARK: OpenSkyAcMasterdata
 //
@@ -1548,6 +2367,9 @@ std::string OpenSkyAcMasterdata::GetURL (const positionTy& pos)
 // process each master data line read from OpenSky
 bool OpenSkyAcMasterdata::ProcessFetchedData (mapLTFlightDataTy& /*fdMap*/)
 {
+    // parson allocates from our arena, reset when done
+    LTArenaScope arenaScope (jsonArena);
+    
     // loop all previously collected master data records
     for ( const std::string& ln: listMd) {
         // here we collect the master data
@@ -1656,6 +2478,9 @@ bool LTFlightDataInit()
         return false;
     }
     
+    // parson shall use the channels' arenas
+    ArenaInit();
+    
     // Success
     return true;
 }
@@ -1664,7 +2489,13 @@ bool LTFlightDataEnable()
 {
     // create list of flight and master data connections
     listFDC.clear();
-    if ( dataRefs.GetUseHistData() ) {
+    if ( dataRefs.IsChannelEnabled(DR_CHANNEL_REPLAY) ) {
+        // replay recorded data instead of any other source
+        listFDC.emplace_back(new ReplayChannel);
+    } else if ( dataRefs.IsChannelEnabled(DR_CHANNEL_SYNTHETIC) ) {
+        // generated traffic instead of any other source
+        listFDC.emplace_back(new SyntheticChannel);
+    } else if ( dataRefs.GetUseHistData() ) {
         // load historic data readers
         listFDC.emplace_back(new ADSBExchangeHistorical);
         // TODO: master data readers for historic data, like reading CSV file
@@ -1672,6 +2503,8 @@ bool LTFlightDataEnable()
         // load live feed readers (in order of priority)
         listFDC.emplace_back(new OpenSkyConnection);
         listFDC.emplace_back(new ADSBExchangeConnection);
+        listFDC.emplace_back(new SBSConnection);
+        listFDC.emplace_back(new ADSBExchangeStream);
         // load online master data connections
         listFDC.emplace_back(new OpenSkyAcMasterdata);
     }
@@ -1695,6 +2528,9 @@ void LTFlightDataDisable()
 
 void LTFlightDataStop()
 {
+    // write outstanding raw data records
+    RawRecStop();
+    
     // cleanup global CURL stuff
     curl_global_cleanup();
 }
@@ -1702,6 +2538,57 @@ void LTFlightDataStop()
 //
 //MARK: Show/Select Aircrafts / Thread Control
 //
+// one cycle of fetching and processing data of all channels,
+// called every fdRefreshIntvl by LTFlightDataSelectAc
+// (or by a headless driver directly, see bFDSynchronous)
+void LTFlightDataSelectAcCycle ()
+{
+    // LiveTraffic Top Level Exception Handling
+    try {
+        // where are we right now?
+        positionTy pos (dataRefs.GetViewPos());
+        
+        // reset list of a/c needing master data updates
+        LTACMasterdataChannel::ClearMasterDataRequests();
+        
+        // cycle all flight data connections
+        for ( ptrLTChannelTy& p: listFDC )
+        {
+            // LiveTraffic Top Level Exception Handling
+            try {
+                // fetch all aicrafts
+                if ( p->IsEnabled() ) {
+                    
+                    if ( p->FetchAllData(pos) && !bFDMainStop ) {
+                        if (p->ProcessFetchedData(mapFd))
+                            // reduce error count if processed successfully
+                            // as a chance to appear OK in the long run
+                            p->DecErrCnt();
+                    }
+                }
+            } catch (const std::exception& e) {
+                LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+                // in case of any exception disable this channel
+                p->SetValid(false, true);
+            } catch (...) {
+                // in case of any exception disable this channel
+                p->SetValid(false, true);
+            }
+            
+            // exit early if asked to do so
+            if ( bFDMainStop )
+                break;
+        }
+    } catch (const std::exception& e) {
+        LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+        // in case of any exception here completely re-init
+        dataRefs.SetReInitAll(true);
+    } catch (...) {
+        // in case of any exception here completely re-init
+        dataRefs.SetReInitAll(true);
+    }
+}
+
 // this function is spawned as a separate thread in LTFlightDataShowAircraft
 // and it runs in a loop until LTFlightDataHideAircraft stops it
 void LTFlightDataSelectAc ()
@@ -1714,50 +2601,7 @@ void LTFlightDataSelectAc ()
         auto nextWakeup = std::chrono::system_clock::now();
         nextWakeup += std::chrono::seconds(dataRefs.GetFdRefreshIntvl());
         
-        // LiveTraffic Top Level Exception Handling
-        try {
-            // where are we right now?
-            positionTy pos (dataRefs.GetViewPos());
-            
-            // reset list of a/c needing master data updates
-            LTACMasterdataChannel::ClearMasterDataRequests();
-            
-            // cycle all flight data connections
-            for ( ptrLTChannelTy& p: listFDC )
-            {
-                // LiveTraffic Top Level Exception Handling
-                try {
-                    // fetch all aicrafts
-                    if ( p->IsEnabled() ) {
-                        
-                        if ( p->FetchAllData(pos) && !bFDMainStop ) {
-                            if (p->ProcessFetchedData(mapFd))
-                                // reduce error count if processed successfully
-                                // as a chance to appear OK in the long run
-                                p->DecErrCnt();
-                        }
-                    }
-                } catch (const std::exception& e) {
-                    LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
-                    // in case of any exception disable this channel
-                    p->SetValid(false, true);
-                } catch (...) {
-                    // in case of any exception disable this channel
-                    p->SetValid(false, true);
-                }
-                
-                // exit early if asked to do so
-                if ( bFDMainStop )
-                    break;
-            }
-        } catch (const std::exception& e) {
-            LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
-            // in case of any exception here completely re-init
-            dataRefs.SetReInitAll(true);
-        } catch (...) {
-            // in case of any exception here completely re-init
-            dataRefs.SetReInitAll(true);
-        }
+        LTFlightDataSelectAcCycle();
         
         // sleep for FD_REFRESH_INTVL or if woken up for termination
         // by condition variable trigger
@@ -1775,12 +2619,16 @@ bool LTFlightDataShowAircraft()
 {
     // is there a main thread running already? -> just return
     if ( FDMainThread.joinable() ) return true;
+    // or are we driven synchronously and running already?
+    if ( bFDSynchronous && !bFDMainStop ) return true;
     
     // create a new thread that receives flight data / creates aircrafts
     bFDMainStop = false;
-    FDMainThread = std::thread ( LTFlightDataSelectAc );
-    // and one for position calculation
-    CalcPosThread = std::thread ( LTFlightData::CalcNextPosMain );
+    if ( !bFDSynchronous ) {
+        FDMainThread = std::thread ( LTFlightDataSelectAc );
+        // and one for position calculation
+        CalcPosThread = std::thread ( LTFlightData::CalcNextPosMain );
+    }
     
     // tell the user we do something in the background
     SHOW_MSG(logINFO,
@@ -1807,6 +2655,17 @@ void LTFlightDataHideAircraft()
         
         CalcPosThread = std::thread();
         FDMainThread = std::thread();
+        
+        // stop channels' own threads, too
+        for ( ptrLTChannelTy& p: listFDC )
+            p->Stop();
+    }
+    // driven synchronously? -> just stop
+    else if ( bFDSynchronous && !bFDMainStop )
+    {
+        bFDMainStop = true;
+        for ( ptrLTChannelTy& p: listFDC )
+            p->Stop();
     }
     
     // Remove all flight data info including displayed aircrafts
@@ -1828,41 +2687,105 @@ void LTFlightDataHideAircraft()
 //      (called from flight loop callback!)
 //
 
-void LTFlightDataAcMaintenance()
+// Incremental maintenance: Each call handles just a slice of mapFd,
+// continuing where the previous call stopped. The slice size is
+// proportional to the time passed so that every fd object is
+// maintained once per AC_MAINT_INTVL, but a call stops when its
+// time budget AC_MAINT_BUDGET_US is used up.
+
+// key of the fd object to maintain next (a key instead of an iterator
+// as iterators don't survive erasing elements)
+mapLTFlightDataTy::key_type acMaintCursor;
+// time passed since the slice size was last calculated
+float acMaintElapsed = 0.0f;
+// number of fd objects due for maintenance, accumulates over calls
+double acMaintDue = 0.0;
+// number of aircraft at the time of the last UI message update
+int acMaintNumAcBefore = 0;
+// number of fd objects, taken under mapFdMutex, for the UI messages
+int acMaintNumFd = 0;
+
+void LTFlightDataAcMaintenance(float inElapsedSinceLastCall)
 {
-    int numAcBefore = dataRefs.GetNumAircrafts();
-    
     try {
-        // access guarded by the fd mutex
-        std::lock_guard<std::mutex> lock (mapFdMutex);
+        // access guarded by the fd mutex, but don't block the main thread:
+        // if the mutex is taken we just do more next time
+        acMaintElapsed += inElapsedSinceLastCall;
+        std::unique_lock<std::mutex> lock (mapFdMutex, std::try_to_lock);
+        if (!lock)
+            return;
+        acMaintNumFd = int(mapFd.size());
+        
+        // share of all fd objects due by now, never more than one full round
+        acMaintDue += double(mapFd.size()) * acMaintElapsed / AC_MAINT_INTVL;
+        acMaintElapsed = 0.0f;
+        if (acMaintDue > double(mapFd.size()))
+            acMaintDue = double(mapFd.size());
+        if (acMaintDue < 1.0)
+            return;
+        
+        // the frame-time governor might defer us, we'll do more next time then
+        if (!GovernorAllow(GOV_AC_MAINT))
+            return;
+        
+        const std::chrono::steady_clock::time_point tStop =
+            std::chrono::steady_clock::now() + std::chrono::microseconds(AC_MAINT_BUDGET_US);
         double simTime = dataRefs.GetSimTime();
         
-        // iterate all flight data and remove outdated aircraft along with their fd data
+        // iterate a slice of flight data and remove outdated aircraft along with their fd data
         // (although c++ doc says map iterators won't be affected by erase it actually crashes...
         //  so we do it the old-fashioned way and store a vector of to-be-deleted keys
         //  and do the actual delete in a second round)
         std::vector<mapLTFlightDataTy::key_type> vFdKeysToErase;
-        for ( mapLTFlightDataTy::value_type& fdPair: mapFd )
+        mapLTFlightDataTy::iterator fdIter = mapFd.lower_bound(acMaintCursor);
+        while (acMaintDue >= 1.0)
         {
+            // wrap around at the end of the map
+            if (fdIter == mapFd.end())
+                fdIter = mapFd.begin();
+            
             // do the maintenance, remember a/c to be deleted
-            if ( fdPair.second.AircraftMaintenance(simTime) )
-                vFdKeysToErase.push_back(fdPair.first);
+            if ( fdIter->second.AircraftMaintenance(simTime) )
+                vFdKeysToErase.push_back(fdIter->first);
+            ++fdIter;
+            acMaintDue -= 1.0;
+            
+            // time's up? Continue with next call
+            // (not when driven synchronously: runs shall be reproducible)
+            if (!bFDSynchronous && std::chrono::steady_clock::now() >= tStop)
+                break;
         }
+        
+        // remember where to continue next time
+        if (fdIter == mapFd.end())
+            acMaintCursor.clear();
+        else
+            acMaintCursor = fdIter->first;
+        
         // now remove all outdated fd objects remembered for deletion
         for ( const mapLTFlightDataTy::key_type& key: vFdKeysToErase )
             mapFd.erase(key);
+        acMaintNumFd = int(mapFd.size());
         
     } catch(const std::system_error& e) {
         LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFd", e.what());
     }
+}
+
+// UI messages about the number of aircraft, called every AC_MAINT_INTVL
+// (doesn't access mapFd, channel threads might insert concurrently)
+void LTFlightDataAcMaintenanceMsgs()
+{
+    const int numAcBefore = acMaintNumAcBefore;
     
     /*** UI messages about filling up the buffer ***/
     int numAcAfter = dataRefs.GetNumAircrafts();
+    acMaintNumAcBefore = numAcAfter;
     
     // initially: we might see some a/c but don't have enough data yet
     if ( initTimeBufFilled < 0 ) {
         // did we see any aircraft yet?
-        if ( mapFd.size() > 0 )
+        if ( acMaintNumFd > 0 )
             // show messages for FD_BUF_PERIOD time
             initTimeBufFilled = dataRefs.GetSimTime() + dataRefs.GetFdBufPeriod();
     }
@@ -1870,7 +2793,7 @@ void LTFlightDataAcMaintenance()
     // if buffer-fill countdown is (still) running, update the figures in UI
     if ( initTimeBufFilled > 0 ) {
         CreateMsgWindow(float(AC_MAINT_INTVL - .05), logMSG, MSG_BUF_FILL_COUNTDOWN,
-                        int(mapFd.size()),
+                        acMaintNumFd,
                         numAcAfter,
                         int(initTimeBufFilled - dataRefs.GetSimTime()));
         // buffer fill-up time's up
@@ -38,10 +38,14 @@ mapLTFlightDataTy mapFd;
 //  to avoid deadlocks, mapFdMutex is considered a higher-level lock)
 std::mutex      mapFdMutex;
 
-// flag to indicate that there is no new positional data
-// to analyse for terrain altitude and subsequently
-// add to posDeque, i.e. if true AppendAllNewPos returns immediately
-std::atomic_flag flagNoNewPosToAdd = ATOMIC_FLAG_INIT;
+// keys of flight data objects with new positional data
+// to analyse for terrain altitude and subsequently add to posDeque,
+// i.e. if empty AppendAllNewPos returns immediately
+LTMpscQueue<mapLTFlightDataTy::key_type> qFdWithNewPos;
+
+// bit of a channel in FDOwnerTy::chSeen
+inline uint32_t ChBit (dataRefsLT ch)
+{ return 1u << (ch - DR_CHANNEL_FIRST); }
 
 //
 //MARK: Flight Data Subclasses
@@ -154,7 +158,7 @@ transpIcaoInt(0),
 rcvr(0),sig(0),
 rotateTS(NAN),
 youngestTS(0),
-pAc(nullptr), probeRef(NULL),
+pAc(nullptr),
 bValid(true)
 {}
 
@@ -173,9 +177,8 @@ LTFlightData::~LTFlightData()
         std::lock_guard<std::recursive_mutex> lock (dataAccessMutex);
         // make sure aircraft is removed, too
         DestroyAircraft();
-        // Release probe handle
-        if (probeRef)
-            XPLMDestroyProbe(probeRef);
+        // no more terrain probes for us
+        TerrainProbeCancel(this);
     } catch(const std::system_error& e) {
         LOG_MSG(logERR, ERR_LOCK_ERROR, key().c_str(), e.what());
     }
@@ -196,12 +199,15 @@ LTFlightData& LTFlightData::operator=(const LTFlightData& fd)
         labelCfg            = fd.labelCfg;
         posDeque            = fd.posDeque;          // dynamic data
         posToAdd            = fd.posToAdd;
+        posGen              = fd.posGen.load();
+        posGenAppended      = fd.posGenAppended;
         dynDataDeque        = fd.dynDataDeque;
         rotateTS            = fd.rotateTS;
         youngestTS          = fd.youngestTS;
         statData            = fd.statData;          // static data
         pAc                 = fd.pAc;
-        probeRef            = fd.probeRef;
+        mapTerrainAlt       = fd.mapTerrainAlt;
+        owner               = fd.owner;
         bValid              = fd.bValid;
     } catch(const std::system_error& e) {
         LOG_MSG(logERR, ERR_LOCK_ERROR, key().c_str(), e.what());
@@ -443,6 +449,7 @@ void LTFlightData::DataCleansing (bool& bChanged)
                                             keyDbg().c_str(),
                                             iter->dbgTxt().c_str());
                                 }
+                                TraceEvent(TRC_CLEANSE, keyInt(), *iter);
                                 posDeque.erase(iter);               // now all iterators are invalid!
                                 bChanged = true;
                                 iter = posDeque.begin();
@@ -814,49 +821,58 @@ std::mutex calcNextPosListMutex;
 typedef std::deque<std::pair<std::string,double>> dequeStrDoubleTy;
 dequeStrDoubleTy dequeKeyPosCalc;
 
-// The main function for the position calculation thread
-// It receives keys to work on in the dequeKeyPosCalc list and calls
-// the CalcNextPos function on the respective flight data objects
-void LTFlightData::CalcNextPosMain ()
+// Takes one key from the dequeKeyPosCalc list and calls
+// the CalcNextPos function on the respective flight data object,
+// returns false if the list was empty
+bool LTFlightData::CalcNextPosFromList ()
 {
-    // loop till said to stop
-    while ( !bFDMainStop ) {
-        std::pair<std::string,double> pair (std::string(),0);
+    std::pair<std::string,double> pair (std::string(),0);
+    
+    // thread-safely access the list of keys to fetch one for processing
+    try {
+        std::lock_guard<std::mutex> lock (calcNextPosListMutex);
+        if ( !dequeKeyPosCalc.empty() ) {   // something's in the list, take it
+            pair = dequeKeyPosCalc.front();
+            dequeKeyPosCalc.pop_front();
+        }
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, "CalcNextPosMain", e.what());
+        pair = std::pair<std::string,double> (std::string(),0);
+    }
+    
+    // there was nothing in the list to process
+    if (pair.first.empty())
+        return false;
+    
+    try {
+        // find the flight data object in the map and calc position
+        LTFlightData& fd = mapFd.at(pair.first);
         
-        // thread-safely access the list of keys to fetch one for processing
+        // LiveTraffic Top Level Exception Handling:
+        // CalcNextPos can cause exceptions. If so make fd object invalid and ignore it
         try {
-            std::lock_guard<std::mutex> lock (calcNextPosListMutex);
-            if ( !dequeKeyPosCalc.empty() ) {   // something's in the list, take it
-                pair = dequeKeyPosCalc.front();
-                dequeKeyPosCalc.pop_front();
-            }
-        } catch(const std::system_error& e) {
-            LOG_MSG(logERR, ERR_LOCK_ERROR, "CalcNextPosMain", e.what());
-            pair = std::pair<std::string,double> (std::string(),0);
+            if (fd.IsValid())
+                fd.CalcNextPos(pair.second);
+        } catch (const std::exception& e) {
+            LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+            fd.bValid = false;
+        } catch (...) {
+            fd.bValid = false;
         }
         
-        // there was something in the list to process? Do so!
-        if (!pair.first.empty()) {
-            try {
-                // find the flight data object in the map and calc position
-                LTFlightData& fd = mapFd.at(pair.first);
-                
-                // LiveTraffic Top Level Exception Handling:
-                // CalcNextPos can cause exceptions. If so make fd object invalid and ignore it
-                try {
-                    if (fd.IsValid())
-                        fd.CalcNextPos(pair.second);
-                } catch (const std::exception& e) {
-                    LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
-                    fd.bValid = false;
-                } catch (...) {
-                    fd.bValid = false;
-                }
-                
-            } catch(const std::out_of_range&) {
-                // just ignore exception...fd object might have gone in the meantime
-            }
-        }
+    } catch(const std::out_of_range&) {
+        // just ignore exception...fd object might have gone in the meantime
+    }
+    return true;
+}
+
+// The main function for the position calculation thread
+// It receives keys to work on in the dequeKeyPosCalc list
+void LTFlightData::CalcNextPosMain ()
+{
+    // loop till said to stop
+    while ( !bFDMainStop ) {
+        CalcNextPosFromList();
             
         // sleep till woken up for processing or stopping
         {
@@ -867,6 +883,14 @@ void LTFlightData::CalcNextPosMain ()
     }
 }
 
+// Processes all keys in the list right away,
+// for headless drivers running without threads (bFDSynchronous)
+void LTFlightData::CalcNextPosPending ()
+{
+    while ( !bFDMainStop && CalcNextPosFromList() )
+        ;
+}
+
 // Add a new key to the list of positions to calculate
 // and wake up the calculation thread
 void LTFlightData::TriggerCalcNewPos ( double simTime )
@@ -1026,36 +1050,77 @@ bool LTFlightData::IsPosOK (const positionTy& lastPos,
 }
 
 // adds a new position to the queue of positions to analyse
+// (hand-over to the main thread, which does all checks in AppendNewPos)
+// Needs no lock: qPosToAdd takes any number of producers, so several
+// network threads can feed the same flight.
 void LTFlightData::AddNewPos ( positionTy& pos )
 {
-    try {
-        // access guarded by a mutex
-        std::lock_guard<std::recursive_mutex> lock (dataAccessMutex);
+    TraceEvent(TRC_INGEST, keyInt(), pos);
+    PushNewPos(pos);
+    QueueNewPos();
+}
 
-        // if there is an a/c then we shall no longer add positions
-        // before the current 'to' position of the a/c
-        if (pAc && pos <= pAc->GetToPos()) {
-            // pos is before or close to 'to'-position: don't add!
-            if (dataRefs.GetDebugAcPos(key()))
-                LOG_MSG(logDEBUG,DBG_SKIP_NEW_POS,pos.dbgTxt().c_str());
-            return;
-        }
+// adds a batch of new positions, which must be sorted by timestamp,
+// like trails: handed over like AddNewPos, but announced just once,
+// AppendNewPos then merges them in one pass
+void LTFlightData::AddNewPosBatch (const dequePositionTy& batch)
+{
+    LOG_ASSERT(std::is_sorted(batch.cbegin(), batch.cend()));
+    for (const positionTy& pos: batch) {
+        TraceEvent(TRC_INGEST, keyInt(), pos);
+        PushNewPos(pos);
+    }
+    if (!batch.empty())
+        QueueNewPos();
+}
 
-        // add pos to the queue of data to be added
-        // (we shall not do Y probes but need accurate GND info...)
-        posToAdd.emplace_back(pos);
-        flagNoNewPosToAdd.clear();
-    } catch(const std::system_error& e) {
-        LOG_MSG(logERR, ERR_LOCK_ERROR, key().c_str(), e.what());
+// queues our key for AppendAllNewPos, but only if not queued already,
+// so that a busy flight doesn't cost a queue node per position or frame
+void LTFlightData::QueueNewPos()
+{
+    if (!bQueuedNewPos.exchange(true))
+        qFdWithNewPos.Push(key());
+}
+
+// hands over one position, tagged with the current channel switch generation:
+// into a preallocated slot of qPosToAdd, only if that is full
+// (like for long trails) it takes the allocating qPosOverflow
+void LTFlightData::PushNewPos (const positionTy& pos)
+{
+    const unsigned gen = posGen.load();
+    if (!qPosToAdd.Push([&](newPosTy& np){ np.pos = pos; np.gen = gen; }))
+        qPosOverflow.Push(newPosTy { pos, gen });
+}
+
+// takes over one handed-over position into posToAdd
+// (main thread, with dataAccessMutex locked as posDeque is touched)
+void LTFlightData::TakeOverNewPos (const newPosTy& np)
+{
+    // Overflow and ring aren't in order with each other,
+    // so compare generations instead of relying on the order
+    const int genDiff = int(np.gen - posGenAppended);
+    if (genDiff < 0) {
+        // from a channel we switched away from
+        TraceEvent(TRC_DROP, keyInt(), np.pos, TRC_DROP_CH_SWITCH);
+        return;
+    }
+    if (genDiff > 0) {
+        // first position after a channel switch:
+        // throw away what we had from the previous channel
+        posDeque.clear();
+        posToAdd.clear();
+        posGenAppended = np.gen;
     }
+    posToAdd.push_back(np.pos);
 }
 
-// walks all flight data objects and works the posToAdd queue
+// works the posToAdd queue of those flight data objects,
+// which reported new positions
 // called from flight loop callback, i.e. from the main thread
 void LTFlightData::AppendAllNewPos()
 {
     // short-cut if nothing to do
-    if (flagNoNewPosToAdd.test_and_set())
+    if (qFdWithNewPos.empty())
         return;
 
     // somewhere there is something to do
@@ -1065,16 +1130,28 @@ void LTFlightData::AppendAllNewPos()
         if (!lock) {
             // couldn't get the lock right away
             // -> return, we don't want to hinder rendering
-            flagNoNewPosToAdd.clear();      // but need to try again
+            // (queue stays filled, so we try again next time)
             return;
         }
         
-        // look all flight data objects and check for new data to analyse
-        for (mapLTFlightDataTy::value_type& fdPair: mapFd)
-            fdPair.second.AppendNewPos();
+        // fetch the keys of all flight data objects with new data
+        // (QueueNewPos queues each object just once until we get here)
+        std::vector<mapLTFlightDataTy::key_type> vKeys;
+        qFdWithNewPos.PopAll(vKeys);
+        
+        // analyse their new data
+        // (the fd object might have been removed in the meantime)
+        for (const mapLTFlightDataTy::key_type& key: vKeys) {
+            mapLTFlightDataTy::iterator fdIter = mapFd.find(key);
+            if (fdIter != mapFd.end()) {
+                // reset before taking over positions: whatever is added
+                // from now on queues the object again
+                fdIter->second.bQueuedNewPos.exchange(false);
+                fdIter->second.AppendNewPos();
+            }
+        }
     } catch(const std::system_error& e) {
         LOG_MSG(logERR, ERR_LOCK_ERROR, "mapFdMutex", e.what());
-        flagNoNewPosToAdd.clear();
     }
 }
 
@@ -1082,61 +1159,103 @@ void LTFlightData::AppendAllNewPos()
 // called from AppendAllNewPos, i.e. from within flight loop callback
 void LTFlightData::AppendNewPos()
 {
-    // short-cut if nothing to do...we dare doing that without lock
-    if (posToAdd.empty())
-        return;
-    
     try {
-        // access guarded by a mutex, but we don't wait (inside the flight loop)
-        std::unique_lock<std::recursive_mutex> lock (dataAccessMutex, std::try_to_lock);
-        if (!lock) {
-            flagNoNewPosToAdd.clear();          // need to try it again
-            return;
+        // posDeque is shared with the calc thread. Network threads no longer
+        // take this lock for handing over positions, and the calc thread
+        // holds it only briefly, so we wait instead of trying again next frame.
+        std::lock_guard<std::recursive_mutex> lock (dataAccessMutex);
+        
+        // take over the positions handed over by the network threads
+        newPosTy np;
+        while (qPosToAdd.Pop(np))
+            TakeOverNewPos(np);
+        if (!qPosOverflow.empty()) {
+            std::vector<newPosTy> vOverflow;
+            qPosOverflow.PopAll(vOverflow);
+            for (const newPosTy& o: vOverflow)
+                TakeOverNewPos(o);
         }
         
+        // short-cut if nothing to do
+        if (posToAdd.empty())
+            return;
+        
+        // posToAdd is merged into posDeque in one pass, which requires it
+        // to be sorted (batches are, single positions mostly arrive in order)
+        if (!std::is_sorted(posToAdd.cbegin(), posToAdd.cend()))
+            std::stable_sort(posToAdd.begin(), posToAdd.end());
+        
+        // cursor into posDeque: first position not definitely before the
+        // position to add; only ever moves forward as posToAdd is sorted
+        size_t idx = 0;
+        // timestamp range of changed positions, for the heading recalc
+        double tsChgFirst = NAN, tsChgLast = NAN;
+        
         // loop the positions to add
         while (!posToAdd.empty())
         {
-            // take next pos from queue
-            positionTy pos = posToAdd.front();
-            posToAdd.pop_front();
+            // if there is an a/c then we shall no longer add positions
+            // before the current 'to' position of the a/c
+            if (pAc && posToAdd.front() <= pAc->GetToPos()) {
+                // pos is before or close to 'to'-position: don't add!
+                if (dataRefs.GetDebugAcPos(key()))
+                    LOG_MSG(logDEBUG,DBG_SKIP_NEW_POS,posToAdd.front().dbgTxt().c_str());
+                TraceEvent(TRC_DROP, keyInt(), posToAdd.front(), TRC_DROP_BEFORE_TO);
+                posToAdd.pop_front();
+                continue;
+            }
             
             // *** ground status *** (plays a role in merge determination)
             // will set ground altitude if on ground
-            TryDeriveGrndStatus(pos);
+            if (TryDeriveGrndStatus(posToAdd.front()) == TRY_NO_DATA) {
+                // terrain altitude not yet known, a probe has been requested.
+                // Positions need to be added in order, so we stop here,
+                // but request probes for all the others, too, and try again
+                // once a probe is delivered (TerrainAltDelivered queues us)
+                for (positionTy& p: posToAdd)
+                    TryDeriveGrndStatus(p);
+                break;
+            }
+            
+            // take next pos from queue
+            positionTy pos = posToAdd.front();
+            posToAdd.pop_front();
             
             // *** insert/merge position ***
             
+            // skip all positions definitely before pos
+            while (idx < posDeque.size() && posDeque[idx] << pos)
+                idx++;
+            
             // based on timestamp find possible "similar" position
             // or insert position.
             // and if so merge with that position to avoid too many position in
             // a very short time frame, as that leads to zick-zack courses in a
             // matter of meters only as can happen when merging different data streams
-            dequePositionTy::iterator i =   // first: find a merge partner
-            std::find_if(posDeque.begin(), posDeque.end(),
-                         [&pos](const positionTy& p){return p.canBeMergedWith(pos);});
-            if (i != posDeque.end()) {      // found merge partner!
+            // (posDeque is sorted, so only the position at idx can be the merge partner)
+            if (idx < posDeque.size() && posDeque[idx].canBeMergedWith(pos)) {
                 // make sure we don't overlap with predecessor/successor position
-                if (((i == posDeque.begin()) || (*std::prev(i) < pos)) &&
-                    ((std::next(i) == posDeque.end()) || (*std::next(i) > pos)))
+                if (((idx == 0) || (posDeque[idx-1] < pos)) &&
+                    ((idx+1 == posDeque.size()) || (posDeque[idx+1] > pos)))
                 {
-                    *i |= pos;                  // merge them (if pos.heading is nan then i.heading prevails)
+                    positionTy& m = posDeque[idx];
+                    m |= pos;                   // merge them (if pos.heading is nan then m.heading prevails)
+                    TraceEvent(TRC_MERGE, keyInt(), m);
                     if (dataRefs.GetDebugAcPos(key()))
-                        LOG_MSG(logDEBUG,DBG_MERGED_POS,pos.dbgTxt().c_str(),i->ts());
+                        LOG_MSG(logDEBUG,DBG_MERGED_POS,pos.dbgTxt().c_str(),m.ts());
                 }
                 else
                 {
                     // pos would overlap with surrounding positions
                     if (dataRefs.GetDebugAcPos(key()))
                         LOG_MSG(logDEBUG,DBG_SKIP_NEW_POS,pos.dbgTxt().c_str());
+                    TraceEvent(TRC_DROP, keyInt(), pos, TRC_DROP_OVERLAP);
                     continue;                   // skip
                 }
             }
             else
             {
-                // second: find insert-before position
-                i = std::find_if(posDeque.begin(), posDeque.end(),
-                                 [&pos](const positionTy& p){return p > pos;});
+                // no merge partner: pos is to be inserted right before idx
                 
                 // *** Sanity Check if we have valid vectors already ***
                 if (pAc || !posDeque.empty())
@@ -1146,7 +1265,6 @@ void LTFlightData::AppendNewPos()
                     // and for that we need 2 positions before insert
                     const positionTy* pBefore = nullptr;
                     double heading = NAN;
-                    size_t idx = std::distance(posDeque.begin(), i);
                     if (idx >= 2) {
                         pBefore = &(posDeque[idx-1]);
                         heading = posDeque[idx-2].between(*pBefore).angle;
@@ -1163,33 +1281,24 @@ void LTFlightData::AppendNewPos()
                     if (pBefore && !IsPosOK(*pBefore, pos, &heading)) {
                         if (dataRefs.GetDebugAcPos(key()))
                             LOG_MSG(logDEBUG,ERR_IGNORE_POS,keyDbg().c_str(),pos.dbgTxt().c_str());
+                        TraceEvent(TRC_DROP, keyInt(), pos, TRC_DROP_NOT_OK);
                         continue;                   // skip
                     }
                 }
                 
                 // pos is OK, add/insert it
-                if (i == posDeque.end()) {      // new pos is to be added at end
-                    posDeque.emplace_back(pos);
-                    i = std::prev(posDeque.end());
-                }
-                else {                          // found real insert position: before i
-                    i = posDeque.emplace(i, pos);
-                }
+                posDeque.emplace(posDeque.begin() + idx, pos);
+                TraceEvent(TRC_APPEND, keyInt(), pos);
             }
             
-            // i now points to the inserted/merged element
-            positionTy& p = *i;
-            
-            // *** heading ***
+            // idx now points to the inserted/merged element
+            positionTy& p = posDeque[idx];
             
-            // Recalc heading of adjacent positions: before p, p itself, and after p
-            if (i != posDeque.begin())              // is there anything before i?
-                CalcHeading(std::prev(i));
-            
-            CalcHeading(i);                         // i itself, latest here a nan heading is rectified
-            
-            if (std::next(i) != posDeque.end())     // is there anything after i?
-                CalcHeading(std::next(i));
+            // remember what changed, headings are recalculated after the loop
+            if (std::isnan(tsChgFirst) || p.ts() < tsChgFirst)
+                tsChgFirst = p.ts();
+            if (std::isnan(tsChgLast) || p.ts() > tsChgLast)
+                tsChgLast = p.ts();
             
             // *** pitch ***
             // just a rough value, LTAircraft::CalcPPos takes care of the details
@@ -1201,11 +1310,33 @@ void LTFlightData::AppendNewPos()
             // *** roll ***
             // TODO: Calc roll
             p.roll() = 0;
-            
-            // *** last checks ***
-            
-            // should be fully valid position now
-            LOG_ASSERT_FD(*this, p.isFullyValid());
+        }
+        
+        // *** heading ***
+        
+        // Recalc heading once over the changed range plus one position on each
+        // side (a heading only depends on the adjacent positions)
+        if (!std::isnan(tsChgFirst)) {
+            dequePositionTy::iterator first =
+            std::lower_bound(posDeque.begin(), posDeque.end(), tsChgFirst,
+                             [](const positionTy& p, double ts){return p.ts() < ts;});
+            dequePositionTy::iterator last =
+            std::upper_bound(first, posDeque.end(), tsChgLast,
+                             [](double ts, const positionTy& p){return ts < p.ts();});
+            if (first != posDeque.begin())
+                --first;
+            if (last != posDeque.end())
+                ++last;
+            for (dequePositionTy::iterator i = first; i != last; ++i) {
+                CalcHeading(i);                 // latest here a nan heading is rectified
+                
+                // *** last checks ***
+                // should be fully valid position now, except for take-off/touch-down
+                // positions added by CalcNextPos, which still wait for TryFetchNewPos
+                // to set their terrain altitude
+                LOG_ASSERT_FD(*this, i->isFullyValid() ||
+                                     (i->IsOnGnd() && std::isnan(i->alt_m())));
+            }
         }
         
         // posDeque should be sorted, i.e. no two adjacent positions a,b should be a > b
@@ -1245,11 +1376,15 @@ LTFlightData::tryResult LTFlightData::TryFetchNewPos (dequePositionTy& acPosList
         
         // we are called from X-Plane's main thread,
         // so we take our chance to determine proper terrain altitudes
+        auto needsGrndStatus = [](const positionTy& pos)
+        {
+            return
+            (pos.IsOnGnd() && std::isnan(pos.alt_m())) ||  // GND_ON but alt unknown
+            pos.onGrnd == positionTy::GND_UNKNOWN;          // GND_UNKNOWN
+        };
         for (positionTy& pos: posDeque) {
-            if ((pos.IsOnGnd() && std::isnan(pos.alt_m())) ||    // GND_ON but alt unknown
-                pos.onGrnd == positionTy::GND_UNKNOWN) {    // GND_UNKNOWN
+            if (needsGrndStatus(pos))
                 TryDeriveGrndStatus(pos);
-            }
         }
         
         // the very first call (i.e. FD doesn't even know the a/c's ptr yet)?
@@ -1257,24 +1392,33 @@ LTFlightData::tryResult LTFlightData::TryFetchNewPos (dequePositionTy& acPosList
             // there must be two positions, one in the past, one in the future!
             LOG_ASSERT_FD(*this, validForAcCreate());
             // copy the first two positions, so that the a/c can start flying from/to
-            acPosList.emplace_back(posDeque[0]);
-            acPosList.emplace_back(posDeque[1]);
+            // (a/c needs to know their ground status now, can't wait for the probe service)
+            for (size_t idx = 0; idx < 2; idx++) {
+                positionTy& pos = posDeque[idx];
+                if (needsGrndStatus(pos))
+                    TryDeriveGrndStatus(pos, true);
+                acPosList.emplace_back(pos);
+                TraceEvent(TRC_FETCH, keyInt(), pos);
+            }
         } else {
             // there is an a/c...only copy stuff past current 'to'-pos
             const positionTy& to = pAc->GetToPos();
             LOG_ASSERT_FD(*this, !std::isnan(to.ts()));
             
             // find the first position beyond current 'to' (is usually right away the first one!)
-            dequePositionTy::const_iterator i =
-            std::find_if(posDeque.cbegin(), posDeque.cend(),
+            dequePositionTy::iterator i =
+            std::find_if(posDeque.begin(), posDeque.end(),
                          [&to](const positionTy& p){return to < p;});
             
             // nothing???
-            if (i == posDeque.cend())
+            if (i == posDeque.end())
                 return TRY_NO_DATA;
             
             // add that next position to the a/c
+            if (needsGrndStatus(*i))
+                TryDeriveGrndStatus(*i, true);
             acPosList.emplace_back(*i);
+            TraceEvent(TRC_FETCH, keyInt(), *i);
         }
         
         // store rotate timestamp if there is one (never overwrite with NAN!)
@@ -1299,16 +1443,35 @@ LTFlightData::tryResult LTFlightData::TryFetchNewPos (dequePositionTy& acPosList
 // determine ground-status based on comparing altitude to terrain
 // Note: If pos.onGnd == GND_ON then this will not change, but the altitude will be set to terrain altitude
 //       If pos.onGnd != GND_ON then onGnd will be decided based on comparing altitude to terrain altitude
-bool LTFlightData::TryDeriveGrndStatus (positionTy& pos)
+// Terrain altitude comes from the terrain probe service: If not yet known for
+// this position (identified by its timestamp) a probe is requested and TRY_NO_DATA
+// returned, so call again later. Only with bSync (main thread only) we probe right away.
+LTFlightData::tryResult LTFlightData::TryDeriveGrndStatus (positionTy& pos, bool bSync)
 {
     try {
         std::unique_lock<std::recursive_mutex> lock (dataAccessMutex, std::try_to_lock );
         if ( lock )
         {
             // what's the terrain altitude at that pos?
-            double terrainAlt = YProbe_at_m(pos);
+            double terrainAlt = NAN;
+            std::map<double,double>::const_iterator it = mapTerrainAlt.find(pos.ts());
+            if (it != mapTerrainAlt.cend())
+                terrainAlt = it->second;
+            else if (bSync)
+                terrainAlt = TerrainProbeSync(pos);
+            else {
+                // request a probe, result will be available in a later call
+                // (unless served from the terrain cache right away)
+                const double ts = pos.ts();
+                terrainAlt = TerrainProbeRequest(this, ts, pos,
+                                                 pos.onGrnd != positionTy::GND_OFF,
+                                                 [this,ts](double alt_m){ TerrainAltDelivered(ts, alt_m); });
+                if (std::isnan(terrainAlt))
+                    return TRY_NO_DATA;
+                mapTerrainAlt[ts] = terrainAlt;
+            }
             if (std::isnan(terrainAlt))
-                return false;
+                return TRY_TECH_ERROR;
             
             // Now 2 options:
             // If position already says itself: I'm on the ground, then keep it like that
@@ -1327,20 +1490,31 @@ bool LTFlightData::TryDeriveGrndStatus (positionTy& pos)
                 pos.onGrnd = positionTy::GND_OFF;
 
             // successfully determined a status
-            return true;
+            return TRY_SUCCESS;
         }
+        return TRY_NO_LOCK;
     } catch(const std::system_error& e) {
         LOG_MSG(logERR, ERR_LOCK_ERROR, key().c_str(), e.what());
     }
     
-    // Either didn't get the lock or some caught error
-    return false;
+    // Caught some error
+    return TRY_TECH_ERROR;
 }
 
-// determine terrain alt at pos
-double LTFlightData::YProbe_at_m (const positionTy& pos)
+// receives terrain altitude from the terrain probe service (main thread)
+void LTFlightData::TerrainAltDelivered (double ts, double terrainAlt_m)
 {
-    return ::YProbe_at_m(pos, probeRef);
+    try {
+        // if we don't get the lock the result is lost,
+        // TryDeriveGrndStatus will just request it again
+        std::unique_lock<std::recursive_mutex> lock (dataAccessMutex, std::try_to_lock );
+        if ( lock )
+            mapTerrainAlt[ts] = terrainAlt_m;
+        // AppendNewPos might be waiting for it (or needs to request again)
+        QueueNewPos();
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, key().c_str(), e.what());
+    }
 }
 
 // returns vector at timestamp (which has speed, direction and the like)
@@ -1455,9 +1629,10 @@ void LTFlightData::AddDynData (const FDDynamicData& inDyn,
                         return;
                     
                     // so we throw away the lower prio channel's data
+                    // (positions are thrown away by AppendNewPos once it sees the new generation)
                     const LTChannel* pLstChn = last.pChannel;           // last is going to become invalid, save the ptr for the log message
                     dynDataDeque.clear();
-                    posDeque.clear();
+                    posGen++;
                     LOG_MSG(logDEBUG, DBG_AC_CHANNEL_SWITCH,
                             keyDbg().c_str(),
                             pLstChn ? pLstChn->ChName() : "<null>",
@@ -1465,21 +1640,17 @@ void LTFlightData::AddDynData (const FDDynamicData& inDyn,
                 }
                 else
                 {
-                    // We compare timestamps of the actual positions and as a safeguard
-                    // accept positions only pointing roughly in the same direction
-                    // as we don't want a/c to turn back and forth due to channel switch.
+                    // We compare timestamps of the actual positions.
+                    // posDeque belongs to the main thread and the calc thread,
+                    // youngestTS is the last position AppendNewPos added to it.
+                    // As a safeguard against a/c turning back and forth due to
+                    // channel switch AppendNewPos accepts the position only
+                    // if IsPosOK after its predecessor, as any other position.
                     if (!pos) return;
-                    const positionTy& lastPos = (posDeque.empty() ?
-                                                 pAc->GetToPos() :
-                                                 posDeque.back());
                     if (pos->ts() + dataRefs.GetFdRefreshIntvl() <=
-                        lastPos.ts() + dataRefs.GetAcOutdatedIntvl())
+                        youngestTS + dataRefs.GetAcOutdatedIntvl())
                         // not big enough a difference in timestamps yet
                         return;
-                    
-                    // check for weird heading changes, wrong speed etc.);
-                    if (!IsPosOK(lastPos, *pos))
-                        return;
 
                     // accept channel switch!
                     LOG_MSG(logDEBUG, DBG_AC_CHANNEL_SWITCH,
@@ -1506,8 +1677,17 @@ void LTFlightData::AddDynData (const FDDynamicData& inDyn,
             rcvr = _rcvr;
             sig = _sig;
         }
+        
+        // remember who feeds us now (for IsRedundantUpdate)
+        if (inDyn.pChannel) {
+            if (owner.ch != inDyn.pChannel->GetChannel() || std::isnan(owner.ts) ||
+                owner.ts < inDyn.ts)
+                owner.ts = inDyn.ts;
+            owner.ch  = inDyn.pChannel->GetChannel();
+            owner.chSeen |= ChBit(owner.ch);
+        }
             
-        // also store the pos (lock is held recursively)
+        // also hand over the pos
         if (pos)
             AddNewPos(*pos);
         
@@ -1516,6 +1696,51 @@ void LTFlightData::AddDynData (const FDDynamicData& inDyn,
     }
 }
 
+// Would AddDynData throw this update away anyway? Checked by the channels
+// right after parsing, so redundant updates, like the same aircraft
+// delivered by a lower-priority channel, never create an fd object
+// nor go through AddDynData's checks.
+// Mirrors the channel rules of AddDynData: no channel switch as long as
+// the a/c isn't created and the new channel has no higher priority,
+// or once the a/c exists, as long as the current channel is alive.
+// Within the same channel only exact duplicates are dropped: AddDynData
+// still forwards late or out-of-order positions to AddNewPos.
+// The first update of each channel always gets through, so that its
+// static data (type, registration...) is merged into the fd object.
+bool LTFlightData::IsRedundantUpdate (const std::string& key,
+                                      const LTChannel* pChannel,
+                                      double ts)
+{
+    if (!pChannel || std::isnan(ts))
+        return false;
+    
+    try {
+        // just a look-up, no insert
+        std::lock_guard<std::mutex> mapFdLock (mapFdMutex);
+        mapLTFlightDataTy::iterator fdIter = mapFd.find(key);
+        if (fdIter == mapFd.end())
+            return false;
+        LTFlightData& fd = fdIter->second;
+        std::lock_guard<std::recursive_mutex> fdLock (fd.dataAccessMutex);
+        
+        FDOwnerTy& own = fd.owner;
+        const uint32_t bit = ChBit(pChannel->GetChannel());
+        if (!(own.chSeen & bit)) {
+            own.chSeen |= bit;
+            return false;
+        }
+        
+        if (own.ch == pChannel->GetChannel())
+            return !std::isnan(own.ts) && dequal(ts, own.ts);
+        if (!fd.pAc)
+            return pChannel->GetChannel() <= own.ch;
+        return ts + dataRefs.GetFdRefreshIntvl() <= own.ts + dataRefs.GetAcOutdatedIntvl();
+    } catch(const std::system_error& e) {
+        LOG_MSG(logERR, ERR_LOCK_ERROR, key.c_str(), e.what());
+    }
+    return false;
+}
+
 // tries to lock, then copies, returns true if copy took place
 bool LTFlightData::TryGetSafeCopy ( FDDynamicData& outDyn ) const
 {
@@ -1690,16 +1915,24 @@ bool LTFlightData::AircraftMaintenance ( double simTime )
         if ( outdated(simTime) )
             return true;
         
+        // terrain altitudes of past positions are no longer needed
+        mapTerrainAlt.erase(mapTerrainAlt.begin(),
+                            mapTerrainAlt.lower_bound(simTime));
+        
         // do we need to recalc the static part of the a/c label due to config change?
-        if (dataRefs.GetLabelCfg().i != labelCfg.i)
+        // (unless deferred by the frame-time governor, then we'll do it next time)
+        if (dataRefs.GetLabelCfg().i != labelCfg.i && GovernorAllow(GOV_LABELS))
             UpdateStaticLabel();
         
         // doesn't yet have an associated aircraft but two positions?
         if ( !hasAc() && posDeque.size() >= 2 ) {
             // is already valid for a/c creation?
-            if ( validForAcCreate(simTime) )
+            if ( validForAcCreate(simTime) ) {
                 // then do create the aircraft
-                CreateAircraft(simTime);
+                // (unless deferred by the frame-time governor, then we'll do it next time)
+                if (GovernorAllow(GOV_CREATE_AC))
+                    CreateAircraft(simTime);
+            }
             else // not yet valid
                 // but the oldest position is at or before current simTime?
                 // then chances are good that we can calculate positions
@@ -0,0 +1,131 @@
+//
+//  LTGovernor.cpp
+//  LiveTraffic
+
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "LiveTraffic.h"
+
+#include <chrono>
+
+//
+//MARK: Global
+//
+
+int         govCycleNum         = -1;   // frame currently measured
+int         govScopeDepth       = 0;    // nesting depth of GovFrameCostTy scopes
+std::chrono::steady_clock::time_point govScopeStart;    // start of outermost open scope
+double      govFrameCost_us     = 0.0;  // cost of closed scopes in the current frame
+float       govFrameCostAvg_us  = 0.0f; // smoothed cost per frame
+double      govBudget_us        = -1.0; // current frame's budget for deferrable work, negative: unlimited
+int         govDeferCnt[GOV_CNT_WORK];  // deferrals per kind of work
+int         govDeferSeq[GOV_CNT_WORK];  // consecutive deferrals per kind of work
+
+// A new frame began? Then finish the previous one's statistics
+// and determine the new frame's budget
+void GovCheckNewFrame ()
+{
+    const int cycle = XPLMGetCycleNumber();
+    if (cycle == govCycleNum)
+        return;
+    govCycleNum = cycle;
+    
+    // smoothed cost per frame
+    govFrameCostAvg_us += float(GOV_COST_SMOOTH * (govFrameCost_us - govFrameCostAvg_us));
+    govFrameCost_us = 0.0;
+    
+    // fast enough (or governor switched off)? Then no limit
+    const int targetFps = dataRefs.GetGovTargetFPS();
+    const float period = dataRefs.GetFrameRatePeriod();
+    if (targetFps <= 0 || period <= 0.0f || period * targetFps <= 1.0f)
+        govBudget_us = -1.0;
+    else {
+        // below target: a share of the target frame time,
+        // reduced by the ratio of actual to target frame rate
+        const double targetPeriod = 1.0 / targetFps;
+        govBudget_us = GOV_FRAME_SHARE * targetPeriod * (targetPeriod / period) * 1000000.0;
+    }
+}
+
+// LiveTraffic's cost in the current frame so far [µs]
+double GovCurrFrameCost ()
+{
+    double cost = govFrameCost_us;
+    if (govScopeDepth > 0)
+        cost += std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - govScopeStart).count();
+    return cost;
+}
+
+//
+//MARK: Frame cost measurement
+//
+
+GovFrameCostTy::GovFrameCostTy()
+{
+    if (govScopeDepth++ == 0) {
+        GovCheckNewFrame();
+        govScopeStart = std::chrono::steady_clock::now();
+    }
+}
+
+GovFrameCostTy::~GovFrameCostTy()
+{
+    if (--govScopeDepth == 0)
+        govFrameCost_us += std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now() - govScopeStart).count();
+}
+
+//
+//MARK: Governor
+//
+
+// may deferrable work be done now?
+bool GovernorAllow (govWorkTy work)
+{
+    GovCheckNewFrame();
+    
+    // no limit, budget not yet used up, or deferred too often already?
+    if (govBudget_us < 0.0 ||
+        GovCurrFrameCost() < govBudget_us ||
+        govDeferSeq[work] >= GOV_MAX_DEFER_SEQ)
+    {
+        govDeferSeq[work] = 0;
+        return true;
+    }
+    
+    // defer
+    govDeferSeq[work]++;
+    govDeferCnt[work]++;
+    return false;
+}
+
+// LiveTraffic's main-thread time per frame [µs], smoothed
+float GovernorFrameCost ()
+{
+    return govFrameCostAvg_us;
+}
+
+// number of deferrals of the given kind of work so far
+int GovernorDeferred (govWorkTy work)
+{
+    return govDeferCnt[work];
+}
@@ -0,0 +1,605 @@
+//
+//  LTJsonScan.cpp
+//  LiveTraffic
+
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Standalone: also compiled into Tools/LTJsonBench, so only LTJsonScan.h
+#include "LTJsonScan.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <charconv>
+
+//
+//MARK: JsonScanner
+//
+
+#ifndef __cpp_lib_to_chars
+// exact powers of 10 for the fast path of ParseNumber
+constexpr double JSON_POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+constexpr int JSON_POW10_MAX = int(std::size(JSON_POW10)) - 1;
+constexpr uint64_t JSON_MANT_MAX = 1ull << 53;  // exactly representable in a double
+#endif
+
+bool JsonScanner::SkipWs ()
+{
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        p++;
+    return p < end && *p;
+}
+
+bool JsonScanner::Next (char c)
+{
+    if (SkipWs() && *p == c) {
+        p++;
+        return true;
+    }
+    return false;
+}
+
+bool JsonScanner::Expect (char c)
+{
+    if (Next(c))
+        return true;
+    bErr = true;
+    return false;
+}
+
+bool JsonScanner::ScanKey (uint32_t& hash, const char*& key, size_t& keyLen)
+{
+    if (!Expect('"'))
+        return false;
+    
+    // hash the raw key up to the closing quote, escapes are hashed as they
+    // are, which makes escaped keys not match any field table, as intended
+    key = p;
+    hash = JSON_HASH_INIT;
+    for (; p < end && *p != '"'; p++) {
+        if (*p == '\\' && p+1 < end)
+            hash = JsonHashAdd(hash, *p++);
+        hash = JsonHashAdd(hash, *p);
+    }
+    if (p >= end) { bErr = true; return false; }
+    keyLen = size_t(p - key);
+    p++;                            // closing quote
+    return Expect(':');
+}
+
+bool JsonScanner::NextMember (char close)
+{
+    if (Next(','))
+        return true;
+    Expect(close);
+    return false;
+}
+
+bool JsonScanner::ReadNull ()
+{
+    if (SkipWs() && end-p >= 4 && !memcmp(p, "null", 4)) {
+        p += 4;
+        return true;
+    }
+    return false;
+}
+
+bool JsonScanner::ReadBool (bool& b)
+{
+    if (!SkipWs())
+        return false;
+    if (end-p >= 4 && !memcmp(p, "true", 4)) {
+        b = true;
+        p += 4;
+        return true;
+    }
+    if (end-p >= 5 && !memcmp(p, "false", 5)) {
+        b = false;
+        p += 5;
+        return true;
+    }
+    return false;
+}
+
+// UTF-8 encodes code point 'cp' into 'out', returns number of bytes
+size_t JsonUtf8 (unsigned long cp, char out[4])
+{
+    if (cp < 0x80) {
+        out[0] = char(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = char(0xC0 | (cp >> 6));
+        out[1] = char(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = char(0xE0 | (cp >> 12));
+        out[1] = char(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = char(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = char(0xF0 | (cp >> 18));
+    out[1] = char(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = char(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = char(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// reads 4 hex digits of a \u escape
+bool JsonHex4 (const char* h, const char* end, unsigned long& cp)
+{
+    if (end - h < 4)
+        return false;
+    char buf[5] = { h[0], h[1], h[2], h[3], 0 };
+    char* pEnd = nullptr;
+    cp = strtoul(buf, &pEnd, 16);
+    return pEnd == buf+4;
+}
+
+template <class AppendFn>
+bool JsonScanner::ReadStringPieces (AppendFn append)
+{
+    if (!SkipWs() || *p != '"')
+        return false;
+    p++;
+    
+    for (;;) {
+        // pass on a run of plain characters in one go
+        const char* run = p;
+        while (p < end && *p != '"' && *p != '\\')
+            p++;
+        if (p > run)
+            append(run, size_t(p - run));
+        if (p >= end) { bErr = true; return false; }
+        if (*p++ == '"')
+            return true;
+        
+        // escape sequence
+        if (p >= end) { bErr = true; return false; }
+        char c = 0;
+        switch (*p++) {
+            case '"':  c = '"';  break;
+            case '\\': c = '\\'; break;
+            case '/':  c = '/';  break;
+            case 'b':  c = '\b'; break;
+            case 'f':  c = '\f'; break;
+            case 'n':  c = '\n'; break;
+            case 'r':  c = '\r'; break;
+            case 't':  c = '\t'; break;
+            case 'u': {
+                unsigned long cp = 0, lo = 0;
+                if (!JsonHex4(p, end, cp)) { bErr = true; return false; }
+                p += 4;
+                // surrogate pair?
+                if (cp >= 0xD800 && cp < 0xDC00 &&
+                    end-p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                    JsonHex4(p+2, end, lo) && lo >= 0xDC00 && lo < 0xE000)
+                {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    p += 6;
+                }
+                char utf8[4];
+                append(utf8, JsonUtf8(cp, utf8));
+                continue;
+            }
+            default:
+                bErr = true;
+                return false;
+        }
+        append(&c, 1);
+    }
+}
+
+bool JsonScanner::ReadString (std::string& s)
+{
+    if (!SkipWs() || *p != '"')
+        return false;
+    s.clear();
+    return ReadStringPieces([&s](const char* piece, size_t len)
+                            { s.append(piece, len); });
+}
+
+bool JsonScanner::ReadString (char* buf, size_t bufSize)
+{
+    if (!SkipWs() || *p != '"')
+        return false;
+    size_t n = 0;
+    const bool bRet =
+    ReadStringPieces([buf, bufSize, &n](const char* piece, size_t len)
+                     {
+                         if (n + len >= bufSize)        // truncate
+                             len = bufSize - 1 - n;
+                         memcpy(buf + n, piece, len);
+                         n += len;
+                     });
+    buf[n] = 0;
+    return bRet;
+}
+
+bool JsonScanner::ParseNumber (const char* b, const char* e, double& d)
+{
+#ifdef __cpp_lib_to_chars
+    // the standard library can do it: exact, locale-independent, no allocation
+    if (b < e && *b == '+')
+        b++;
+    const std::from_chars_result res = std::from_chars(b, e, d);
+    if (res.ec == std::errc::result_out_of_range) {
+        // valid, but beyond double: strtod returns inf/0 for it
+        d = strtod(std::string(b, size_t(res.ptr - b)).c_str(), nullptr);
+        return true;
+    }
+    return res.ec == std::errc();
+#else
+    const char* s = b;
+    bool bNeg = false;
+    if (s < e && (*s == '-' || *s == '+'))
+        bNeg = (*s++ == '-');
+    
+    // mantissa as integer, decimal point moves the exponent
+    uint64_t m = 0;
+    int nDig = 0, exp10 = 0;
+    for (; s < e && *s >= '0' && *s <= '9'; s++, nDig++)
+        m = m * 10 + uint64_t(*s - '0');
+    if (s < e && *s == '.')
+        for (s++; s < e && *s >= '0' && *s <= '9'; s++, nDig++, exp10--)
+            m = m * 10 + uint64_t(*s - '0');
+    if (!nDig)
+        return false;
+    
+    if (s < e && (*s == 'e' || *s == 'E')) {
+        s++;
+        bool bExpNeg = false;
+        if (s < e && (*s == '-' || *s == '+'))
+            bExpNeg = (*s++ == '-');
+        int ex = 0;
+        for (; s < e && *s >= '0' && *s <= '9'; s++)
+            if (ex < 10000) ex = ex * 10 + (*s - '0');
+        exp10 += bExpNeg ? -ex : ex;
+    }
+    
+    // fast path is exact only if mantissa and power of 10 are exact doubles
+    if (nDig <= 19 && m <= JSON_MANT_MAX &&
+        exp10 >= -JSON_POW10_MAX && exp10 <= JSON_POW10_MAX)
+    {
+        d = exp10 < 0 ? double(m) / JSON_POW10[-exp10] :
+                        double(m) * JSON_POW10[exp10];
+        if (bNeg) d = -d;
+        return true;
+    }
+    
+    // slow path: let strtod do it right
+    d = strtod(std::string(b, size_t(s - b)).c_str(), nullptr);
+    return true;
+#endif
+}
+
+bool JsonScanner::ReadNumber (double& d)
+{
+    if (!SkipWs())
+        return false;
+    
+    // number encapsulated as string: like strtod, 0 if there is no number
+    if (*p == '"') {
+        const char* b = ++p;
+        while (p < end && *p != '"')
+            p += (*p == '\\') ? 2 : 1;
+        if (p >= end) { bErr = true; return false; }
+        if (!ParseNumber(b, p, d))
+            d = 0.0;
+        p++;
+        return true;
+    }
+    
+    if (*p != '-' && (*p < '0' || *p > '9'))
+        return false;
+    const char* b = p;
+    while (p < end && ((*p >= '0' && *p <= '9') ||
+                       *p == '-' || *p == '+' || *p == '.' ||
+                       *p == 'e' || *p == 'E'))
+        p++;
+    return ParseNumber(b, p, d);
+}
+
+bool JsonScanner::SkipValue ()
+{
+    if (!SkipWs()) { bErr = true; return false; }
+    
+    switch (*p) {
+        case '"': {
+            for (p++; p < end && *p != '"'; p += (*p == '\\') ? 2 : 1);
+            if (p >= end) { bErr = true; return false; }
+            p++;
+            return true;
+        }
+        case '{':
+        case '[': {
+            // skip nested structure, only strings need attention
+            int depth = 0;
+            do {
+                const char c = *p++;
+                if (c == '"') {
+                    for (; p < end && *p != '"'; p += (*p == '\\') ? 2 : 1);
+                    if (p < end) p++;
+                }
+                else if (c == '{' || c == '[') depth++;
+                else if (c == '}' || c == ']') depth--;
+            } while (depth > 0 && p < end);
+            if (depth > 0) { bErr = true; return false; }
+            return true;
+        }
+        default: {
+            bool b = false;
+            double d = 0.0;
+            if (ReadNull() || ReadBool(b) || ReadNumber(d))
+                return true;
+            bErr = true;
+            return false;
+        }
+    }
+}
+
+bool JsonScanner::FindKey (const char* key)
+{
+    const uint32_t keyHash = JsonKeyHash(key);
+    const size_t   keySize = strlen(key);
+    
+    if (!Expect('{') || Next('}'))
+        return false;
+    do {
+        uint32_t h = 0;
+        const char* k = nullptr;
+        size_t len = 0;
+        if (!ScanKey(h, k, len))
+            return false;
+        if (h == keyHash && len == keySize && !memcmp(k, key, len))
+            return true;
+        if (!SkipValue())
+            return false;
+    } while (NextMember('}'));
+    return false;
+}
+
+//
+//MARK: ADS-B Exchange aircraft list
+//
+
+void ADSBExAcTy::Reset ()
+{
+    for (std::string* s: { &transpIcao, &reg, &country, &acTypeIcao, &man, &mdl,
+                           &op, &opIcao, &call, &origin, &dest })
+        s->clear();
+    year = trt = posTime = radarCode = 0.0;
+    inHg = brng = dst = spd = vsi = 0.0;
+    engType = engMount = rcvr = sig = 0.0;
+    heading = lat = lon = alt = NAN;
+    posStale = gnd = mil = false;
+}
+
+// maps a JSON key to exactly one member of ADSBExAcTy
+struct adsbexFieldTy {
+    const char*                 key;
+    std::string ADSBExAcTy::*   pStr;
+    double      ADSBExAcTy::*   pNum;
+    bool        ADSBExAcTy::*   pBool;
+};
+
+constexpr adsbexFieldTy FldS (const char* k, std::string ADSBExAcTy::* m)
+{ return { k, m, nullptr, nullptr }; }
+constexpr adsbexFieldTy FldN (const char* k, double ADSBExAcTy::* m)
+{ return { k, nullptr, m, nullptr }; }
+constexpr adsbexFieldTy FldB (const char* k, bool ADSBExAcTy::* m)
+{ return { k, nullptr, nullptr, m }; }
+
+constexpr adsbexFieldTy ADSBEX_FIELDS[] = {
+    FldS(ADSBEX_TRANSP_ICAO,    &ADSBExAcTy::transpIcao),
+    FldS(ADSBEX_REG,            &ADSBExAcTy::reg),
+    FldS(ADSBEX_COUNTRY,        &ADSBExAcTy::country),
+    FldS(ADSBEX_AC_TYPE_ICAO,   &ADSBExAcTy::acTypeIcao),
+    FldS(ADSBEX_MAN,            &ADSBExAcTy::man),
+    FldS(ADSBEX_MDL,            &ADSBExAcTy::mdl),
+    FldS(ADSBEX_OP,             &ADSBExAcTy::op),
+    FldS(ADSBEX_OP_ICAO,        &ADSBExAcTy::opIcao),
+    FldS(ADSBEX_CALL,           &ADSBExAcTy::call),
+    FldS(ADSBEX_ORIGIN,         &ADSBExAcTy::origin),
+    FldS(ADSBEX_DESTINATION,    &ADSBExAcTy::dest),
+    FldN(ADSBEX_YEAR,           &ADSBExAcTy::year),
+    FldN(ADSBEX_TRT,            &ADSBExAcTy::trt),
+    FldN(ADSBEX_POS_TIME,       &ADSBExAcTy::posTime),
+    FldN(ADSBEX_RADAR_CODE,     &ADSBExAcTy::radarCode),
+    FldN(ADSBEX_HEADING,        &ADSBExAcTy::heading),
+    FldN(ADSBEX_IN_HG,          &ADSBExAcTy::inHg),
+    FldN(ADSBEX_BRNG,           &ADSBExAcTy::brng),
+    FldN(ADSBEX_DST,            &ADSBExAcTy::dst),
+    FldN(ADSBEX_SPD,            &ADSBExAcTy::spd),
+    FldN(ADSBEX_VSI,            &ADSBExAcTy::vsi),
+    FldN(ADSBEX_LAT,            &ADSBExAcTy::lat),
+    FldN(ADSBEX_LON,            &ADSBExAcTy::lon),
+    FldN(ADSBEX_ELEVATION,      &ADSBExAcTy::alt),
+    FldN(ADSBEX_ENG_TYPE,       &ADSBExAcTy::engType),
+    FldN(ADSBEX_ENG_MOUNT,      &ADSBExAcTy::engMount),
+    FldN(ADSBEX_RCVR,           &ADSBExAcTy::rcvr),
+    FldN(ADSBEX_SIG,            &ADSBExAcTy::sig),
+    FldB(ADSBEX_POS_STALE,      &ADSBExAcTy::posStale),
+    FldB(ADSBEX_GND,            &ADSBExAcTy::gnd),
+    FldB(ADSBEX_MIL,            &ADSBExAcTy::mil),
+};
+
+// open-addressing hash table over ADSBEX_FIELDS, built at compile time
+constexpr size_t ADSBEX_FLD_HASH_SIZE = 64;     // power of 2
+static_assert(std::size(ADSBEX_FIELDS) <= ADSBEX_FLD_HASH_SIZE / 2,
+              "ADSBEX_FLD_HASH_SIZE too small for ADSBEX_FIELDS");
+
+struct adsbexFldHashTy {
+    uint32_t    hash[ADSBEX_FLD_HASH_SIZE] = {};
+    size_t      len [ADSBEX_FLD_HASH_SIZE] = {};
+    int         idx [ADSBEX_FLD_HASH_SIZE] = {};    // into ADSBEX_FIELDS, -1 if slot empty
+};
+
+constexpr adsbexFldHashTy ADSBExBuildFldHash ()
+{
+    adsbexFldHashTy t;
+    for (size_t slot = 0; slot < ADSBEX_FLD_HASH_SIZE; slot++)
+        t.idx[slot] = -1;
+    for (size_t f = 0; f < std::size(ADSBEX_FIELDS); f++) {
+        const uint32_t h = JsonKeyHash(ADSBEX_FIELDS[f].key);
+        size_t slot = h & (ADSBEX_FLD_HASH_SIZE-1);
+        while (t.idx[slot] >= 0)
+            slot = (slot+1) & (ADSBEX_FLD_HASH_SIZE-1);
+        t.hash[slot] = h;
+        t.len[slot]  = std::char_traits<char>::length(ADSBEX_FIELDS[f].key);
+        t.idx[slot]  = int(f);
+    }
+    return t;
+}
+
+constexpr adsbexFldHashTy ADSBEX_FLD_HASH = ADSBExBuildFldHash();
+
+// field table entry for a scanned key, nullptr if we don't need that key
+const adsbexFieldTy* ADSBExFindField (uint32_t h, const char* key, size_t len)
+{
+    for (size_t slot = h & (ADSBEX_FLD_HASH_SIZE-1);
+         ADSBEX_FLD_HASH.idx[slot] >= 0;
+         slot = (slot+1) & (ADSBEX_FLD_HASH_SIZE-1))
+    {
+        if (ADSBEX_FLD_HASH.hash[slot] == h && ADSBEX_FLD_HASH.len[slot] == len) {
+            const adsbexFieldTy& fld = ADSBEX_FIELDS[ADSBEX_FLD_HASH.idx[slot]];
+            if (!memcmp(fld.key, key, len))
+                return &fld;
+        }
+    }
+    return nullptr;
+}
+
+bool ADSBExDecoder::FindAcList ()
+{
+    return FindKey(ADSBEX_AIRCRAFT_ARR) && Expect('[');
+}
+
+bool ADSBExDecoder::NextAc (ADSBExAcTy& ac)
+{
+    if (bErr || bListEnd)
+        return false;
+    
+    // first aircraft, or separator to the next one, or end of list
+    if (bFirstAc) {
+        bFirstAc = false;
+        bListEnd = Next(']');
+    } else
+        bListEnd = !NextMember(']');
+    if (bListEnd || !Expect('{'))
+        return false;
+    
+    ac.Reset();
+    if (Next('}'))
+        return true;
+    do {
+        uint32_t h = 0;
+        const char* key = nullptr;
+        size_t len = 0;
+        if (!ScanKey(h, key, len))
+            return false;
+        
+        // dispatch straight into the member,
+        // unknown keys, 'null', and unexpected types are skipped
+        bool bRead = false;
+        const adsbexFieldTy* pFld = ADSBExFindField(h, key, len);
+        if (pFld) {
+            if (pFld->pStr)
+                bRead = ReadString(ac.*(pFld->pStr));
+            else if (pFld->pNum)
+                bRead = ReadNumber(ac.*(pFld->pNum));
+            else
+                bRead = ReadBool(ac.*(pFld->pBool));
+            if (bErr)
+                return false;
+        }
+        if (!bRead && !SkipValue())
+            return false;
+    } while (NextMember('}'));
+    return !bErr;
+}
+
+//
+//MARK: OpenSky state vectors
+//
+
+bool OpenSkyDecoder::DecodeStates (vecOpenSkyStateTy& vStates)
+{
+    vStates.clear();
+    if (!FindKey(OPSKY_AIRCRAFT_ARR))
+        return false;
+    
+    // empty result set: {"time":1541978120,"states":null}
+    if (ReadNull())
+        return true;
+    if (!Expect('['))
+        return false;
+    if (Next(']'))
+        return true;
+    do {
+        vStates.emplace_back();
+        if (!DecodeState(vStates.back()))
+            return false;
+    } while (NextMember(']'));
+    return !bErr;
+}
+
+bool OpenSkyDecoder::DecodeState (OpenSkyStateTy& st)
+{
+    if (!Expect('['))
+        return false;
+    if (Next(']'))
+        return true;
+    
+    int idx = 0;
+    do {
+        // pick the value by its position, skip what we don't need
+        bool bRead = false;
+        switch (idx++) {
+            case OPSKY_TRANSP_ICAO: bRead = ReadString(st.transpIcao, sizeof(st.transpIcao)); break;
+            case OPSKY_CALL:        bRead = ReadString(st.call, sizeof(st.call));              break;
+            case OPSKY_COUNTRY:     bRead = ReadString(st.country, sizeof(st.country));        break;
+            case OPSKY_POS_TIME:    bRead = ReadNumber(st.posTime);     break;
+            case OPSKY_LON:         bRead = ReadNumber(st.lon);         break;
+            case OPSKY_LAT:         bRead = ReadNumber(st.lat);         break;
+            case OPSKY_GND:         bRead = ReadBool(st.gnd);           break;
+            case OPSKY_SPD:         bRead = ReadNumber(st.spd);         break;
+            case OPSKY_HEADING:     bRead = ReadNumber(st.heading);     break;
+            case OPSKY_VSI:         bRead = ReadNumber(st.vsi);         break;
+            case OPSKY_ELEVATION:   bRead = ReadNumber(st.alt);         break;
+            case OPSKY_RADAR_CODE:  bRead = ReadNumber(st.radarCode);   break;
+        }
+        if (bErr)
+            return false;
+        if (!bRead && !SkipValue())
+            return false;
+    } while (NextMember(']'));
+    
+    // trim trailing spaces of the callsign
+    for (size_t len = strlen(st.call); len > 0 && st.call[len-1] == ' '; len--)
+        st.call[len-1] = 0;
+    return !bErr;
+}
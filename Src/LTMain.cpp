@@ -159,6 +159,7 @@ std::vector<std::string> str_tokenize (const std::string s,
 // creates/destroys aircrafts by looping the flight data map
 float LoopCBAircraftMaintenance (float inElapsedSinceLastCall, float, int, void*)
 {
+    GovFrameCostTy govCost;             // this counts as LiveTraffic's frame time
     static float elapsedSinceLastAcMaint = 0.0f;
     do {
         // *** check for new positons that require terrain altitude (Y Probes) ***
@@ -167,6 +168,9 @@ float LoopCBAircraftMaintenance (float inElapsedSinceLastCall, float, int, void*
             // handle new network data (that func has a short-cut exit if nothing to do)
             LTFlightData::AppendAllNewPos();
             
+            // maintenance (add/remove), a slice of all aircraft per call
+            LTFlightDataAcMaintenance(inElapsedSinceLastCall);
+            
             // all the rest we do only every 2s
             elapsedSinceLastAcMaint += inElapsedSinceLastCall;
             if (elapsedSinceLastAcMaint < AC_MAINT_INTVL)
@@ -203,8 +207,8 @@ float LoopCBAircraftMaintenance (float inElapsedSinceLastCall, float, int, void*
         
         // LiveTraffic Top Level Exception handling: catch all, reinit if something happens
         try {
-            // maintenance (add/remove)
-            LTFlightDataAcMaintenance();
+            // UI messages on number of aircraft
+            LTFlightDataAcMaintenanceMsgs();
         } catch (const std::exception& e) {
             // try re-init...
             LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
@@ -220,6 +224,28 @@ float LoopCBAircraftMaintenance (float inElapsedSinceLastCall, float, int, void*
     return FLIGHT_LOOP_INTVL;
 }
 
+// flight loop callback, will be called every frame if enabled
+// calculates all aircraft's positions for the current frame in one batch,
+// so that the XPMP callbacks later in the frame only copy results
+float LoopCBAircraftUpdate (float, float, int, void*)
+{
+    GovFrameCostTy govCost;             // this counts as LiveTraffic's frame time
+    // LiveTraffic Top Level Exception handling: catch all, reinit if something happens
+    try {
+        LTAircraft::UpdateAll();
+    } catch (const std::exception& e) {
+        // try re-init...
+        LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+        dataRefs.SetReInitAll(true);
+    } catch (...) {
+        // try re-init...
+        dataRefs.SetReInitAll(true);
+    }
+    
+    // keep calling me
+    return AC_UPDATE_INTVL;
+}
+
 // Preferences functions for XPMP API
 int   MPIntPrefsFunc   (const char* section, const char* key, int   iDefault)
 {
@@ -285,6 +311,9 @@ bool LTMainInit ()
 {
     LOG_ASSERT(dataRefs.pluginState == STATE_STOPPED);
 
+    // Init the terrain probe service (we are in the main thread)
+    TerrainProbeInit();
+    
     // Init fetching flight data
     if (!LTFlightDataInit()) return false;
     
@@ -351,8 +380,9 @@ bool LTMainInit ()
         }
     }
     
-    // register flight loop callback, but don't call yet (see enable later)
+    // register flight loop callbacks, but don't call yet (see enable later)
     XPLMRegisterFlightLoopCallback(LoopCBAircraftMaintenance, 0, NULL);
+    XPLMRegisterFlightLoopCallback(LoopCBAircraftUpdate, 0, NULL);
     
     // Success
     dataRefs.pluginState = STATE_INIT;
@@ -399,12 +429,20 @@ bool LTMainShowAircraft ()
     
     // select aircrafts for display
     if ( !LTFlightDataShowAircraft() ) return false;
+    
+    // start the helpers for per-frame aircraft calculation
+    LTAircraft::StartCalcWorkers();
 
     // enable the flight loop callback to maintain aircrafts
     XPLMSetFlightLoopCallbackInterval(LoopCBAircraftMaintenance,
                                       FLIGHT_LOOP_INTVL,    // every 5th frame
                                       1,            // relative to now
                                       NULL);
+    // and the one for the per-frame aircraft update
+    XPLMSetFlightLoopCallbackInterval(LoopCBAircraftUpdate,
+                                      AC_UPDATE_INTVL,      // every frame
+                                      1,            // relative to now
+                                      NULL);
     
     // success
     dataRefs.pluginState = STATE_SHOW_AC;
@@ -421,12 +459,19 @@ void LTMainHideAircraft ()
     
     // hide aircrafts, disconnect internet streams
     LTFlightDataHideAircraft ();
+    
+    // stop the helpers for per-frame aircraft calculation
+    LTAircraft::StopCalcWorkers();
 
-    // disable the flight loop callback
+    // disable the flight loop callbacks
     XPLMSetFlightLoopCallbackInterval(LoopCBAircraftMaintenance,
                                       0,            // disable
                                       1,            // relative to now
                                       NULL);
+    XPLMSetFlightLoopCallbackInterval(LoopCBAircraftUpdate,
+                                      0,            // disable
+                                      1,            // relative to now
+                                      NULL);
     
     // disable aircraft drawing, free up multiplayer planes
     XPMPMultiplayerDisable();
@@ -459,14 +504,21 @@ void LTMainStop ()
 {
     LOG_ASSERT(dataRefs.pluginState == STATE_INIT);
 
-    // unregister flight loop callback
+    // unregister flight loop callbacks
     XPLMUnregisterFlightLoopCallback(LoopCBAircraftMaintenance, NULL);
+    XPLMUnregisterFlightLoopCallback(LoopCBAircraftUpdate, NULL);
     
     // Cleanup Multiplayer API
     XPMPMultiplayerCleanup();
     
     // Flight data
     LTFlightDataStop();
+    
+    // finish writing the position trace
+    TraceStop();
+    
+    // release terrain probe handle
+    TerrainProbeCleanup();
 
     // success
     dataRefs.pluginState = STATE_STOPPED;
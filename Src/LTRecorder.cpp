@@ -0,0 +1,214 @@
+//
+//  LTRecorder.cpp
+//  LiveTraffic
+
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "LiveTraffic.h"
+
+#include <chrono>
+#include <zlib.h>
+
+//
+//MARK: Global
+//
+
+// one record waiting to be written
+struct rawRecTy {
+    rawRecHeadTy            head;
+    std::string             url;        // RAW_REC_URL: the request URL
+    std::shared_ptr<char>   buf;        // RAW_REC_RESPONSE: the channel's response buffer
+};
+
+LTMpscQueue<rawRecTy>   qRawRec;                // records waiting to be written
+std::atomic<int>        rawRecPending(0);       // number of records in qRawRec
+std::atomic<long>       rawRecDropped(0);       // records dropped, not yet reported
+std::mutex              rawRecThreadMutex;      // guards start/stop of the recorder thread
+std::thread             rawRecThread;
+std::atomic<bool>       bRawRecRunning(false);
+std::atomic<bool>       bRawRecStop(false);
+gzFile                  rawRecFile = NULL;      // recorder thread only
+
+//
+//MARK: Writing (recorder thread)
+//
+
+// open the capture file for appending and start a recording session
+bool RawRecOpen ()
+{
+    std::string sFileName (LTCalcFullPath(PATH_RAW_CAPTURE));
+    rawRecFile = gzopen(sFileName.c_str(), "ab1");      // append, fast compression
+    if (!rawRecFile) {
+        char sErr[SERR_LEN];
+        strerror_s(sErr, sizeof(sErr), errno);
+        // could not open output file: bail out, decativate recording
+        LOG_MSG(logERR, DBG_RAW_FD_ERR_OPEN_OUT, sFileName.c_str(), sErr);
+        dataRefs.SetDebugLogRawFD(false);
+        return false;
+    }
+    
+    rawFileHeadTy head;
+    memcpy(head.magic, RAW_FILE_MAGIC, sizeof(head.magic));
+    head.version     = RAW_FILE_VER;
+    head.recHeadSize = sizeof(rawRecHeadTy);
+    gzwrite(rawRecFile, &head, sizeof(head));
+    LOG_MSG(logWARN, DBG_RAW_FD_START, PATH_RAW_CAPTURE);
+    return true;
+}
+
+// close the capture file
+void RawRecClose ()
+{
+    if (rawRecFile) {
+        gzclose(rawRecFile);
+        rawRecFile = NULL;
+        LOG_MSG(logWARN, DBG_RAW_FD_STOP, PATH_RAW_CAPTURE);
+    }
+}
+
+// compress and write all waiting records
+void RawRecDrain ()
+{
+    // report records we had to drop
+    const long nDropped = rawRecDropped.exchange(0);
+    if (nDropped)
+        LOG_MSG(logWARN, DBG_RAW_FD_DROPPED, nDropped);
+    
+    std::vector<rawRecTy> vRec;
+    if (!qRawRec.PopAll(vRec))
+        return;
+    rawRecPending -= int(vRec.size());
+    
+    // need to open the file first?
+    if (!rawRecFile && !RawRecOpen())
+        return;                         // records (and buffers) are released with vRec
+    
+    for (const rawRecTy& rec: vRec)
+    {
+        const char* pData = rec.head.type == RAW_REC_URL ? rec.url.data() : rec.buf.get();
+        if (gzwrite(rawRecFile, &rec.head, sizeof(rec.head)) != int(sizeof(rec.head)) ||
+            (rec.head.len && gzwrite(rawRecFile, pData, rec.head.len) != int(rec.head.len)))
+        {
+            int errnum = 0;
+            LOG_MSG(logERR, DBG_RAW_FD_ERR_WRITE, PATH_RAW_CAPTURE, gzerror(rawRecFile, &errnum));
+            dataRefs.SetDebugLogRawFD(false);
+            RawRecClose();
+            return;
+        }
+    }
+}
+
+// recorder thread's main loop
+void RawRecMain ()
+{
+    while (!bRawRecStop)
+    {
+        RawRecDrain();
+        // recording switched off and all written? then close the file
+        if (!RawRecIsActive() && qRawRec.empty())
+            RawRecClose();
+        std::this_thread::sleep_for(std::chrono::milliseconds(RAW_REC_INTVL_MS));
+    }
+    
+    // write what's left and close
+    RawRecDrain();
+    RawRecClose();
+}
+
+//
+//MARK: Recording (network thread)
+//
+
+// is recording switched on?
+bool RawRecIsActive ()
+{
+    return dataRefs.GetDebugLogRawFD();
+}
+
+// fill a record header
+rawRecHeadTy RawRecHead (dataRefsLT ch, rawRecTypeTy type, size_t len, long httpStatus)
+{
+    rawRecHeadTy head;
+    head.len        = uint32_t(len);
+    head.httpStatus = uint16_t(httpStatus);
+    head.type       = type;
+    head.chId       = uint8_t(ch - DR_CHANNEL_FIRST);
+    head.simTime    = dataRefs.GetSimTime();
+    head.wallTime   = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return head;
+}
+
+// hand a record over to the recorder thread
+void RawRecSubmit (const rawRecTy& rec)
+{
+    // make sure the recorder thread runs
+    if (!bRawRecRunning) {
+        std::lock_guard<std::mutex> lock (rawRecThreadMutex);
+        if (!bRawRecRunning) {
+            bRawRecStop = false;
+            rawRecThread = std::thread(RawRecMain);
+            bRawRecRunning = true;
+        }
+    }
+    
+    // recorder falling behind? Then rather drop than pile up memory
+    if (rawRecPending >= RAW_REC_MAX_PENDING) {
+        rawRecDropped++;
+        return;
+    }
+    rawRecPending++;
+    qRawRec.Push(rec);
+}
+
+// record a request URL
+void RawRecUrl (dataRefsLT ch, const std::string& url)
+{
+    rawRecTy rec;
+    rec.head = RawRecHead(ch, RAW_REC_URL, url.length(), 0);
+    rec.url  = url;
+    RawRecSubmit(rec);
+}
+
+// record a response, the buffer is shared, not copied
+void RawRecResponse (dataRefsLT ch, long httpStatus,
+                     const std::shared_ptr<char>& buf, size_t len)
+{
+    rawRecTy rec;
+    rec.head = RawRecHead(ch, RAW_REC_RESPONSE, len, httpStatus);
+    rec.buf  = buf;
+    RawRecSubmit(rec);
+}
+
+// write everything outstanding and stop the recorder thread
+void RawRecStop ()
+{
+    std::lock_guard<std::mutex> lock (rawRecThreadMutex);
+    if (!bRawRecRunning)
+        return;
+    
+    bRawRecStop = true;
+    if (rawRecThread.joinable())
+        rawRecThread.join();
+    rawRecThread = std::thread();
+    bRawRecRunning = false;
+}
@@ -0,0 +1,639 @@
+//
+//  LTSynthetic.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// All includes are collected in one header
+#include "LiveTraffic.h"
+
+#include <fstream>
+#include <sstream>
+
+//
+//MARK: Aircraft types
+//
+
+// types of synthetic flights, their share, and their operator
+// (no operator: private flight, call sign is the registration)
+struct synthAcTypeTy {
+    const char* acTypeIcao;
+    double      share;
+    const char* opIcao;
+    const char* op;
+};
+
+const synthAcTypeTy SYNTH_AC_TYPES[] = {
+    { "A320", 20, "SYA", "Synthetic Airways" },
+    { "B738", 20, "SYB", "Synthetic Boeing Lines" },
+    { "A21N",  8, "SYA", "Synthetic Airways" },
+    { "E190",  8, "SYR", "Synthetic Regional" },
+    { "CRJ9",  5, "SYR", "Synthetic Regional" },
+    { "DH8D",  6, "SYR", "Synthetic Regional" },
+    { "AT76",  6, "SYR", "Synthetic Regional" },
+    { "B77W",  5, "SYL", "Synthetic Long Haul" },
+    { "A388",  2, "SYL", "Synthetic Long Haul" },
+    { "B744",  2, "SYC", "Synthetic Cargo" },
+    { "C56X",  4, "",    "" },
+    { "C172",  8, "",    "" },
+    { "P28A",  6, "",    "" },
+};
+
+//
+//MARK: Flat earth helpers
+//      Equirectangular approximation: good enough for the legs of
+//      synthetic flights and a lot cheaper than CoordDistance/CoordAngle,
+//      which matters when stepping 20,000 flights every second.
+//
+
+constexpr double SYNTH_M_per_DEG = EARTH_D_M * PI / 360.0;  // meters per degree latitude
+
+inline double SynthHdgNorm (double h)
+{
+    h = std::fmod(h, 360.0);
+    return h < 0.0 ? h + 360.0 : h;
+}
+
+// turn from 'from' to 'to', -180 < diff <= 180
+inline double SynthHdgDiff (double from, double to)
+{
+    const double d = SynthHdgNorm(to - from);
+    return d > 180.0 ? d - 360.0 : d;
+}
+
+// distance [m] and bearing [°] from 1 to 2
+void SynthDistBrg (double lat1, double lon1, double lat2, double lon2,
+                   double& dist, double& brg)
+{
+    const double dy = (lat2 - lat1) * SYNTH_M_per_DEG;
+    const double dx = (lon2 - lon1) * SYNTH_M_per_DEG * std::cos(deg2rad((lat1 + lat2) / 2.0));
+    dist = std::sqrt(dx*dx + dy*dy);
+    brg = SynthHdgNorm(rad2deg(std::atan2(dx, dy)));
+}
+
+inline double SynthDist (double lat1, double lon1, double lat2, double lon2)
+{
+    double dist, brg;
+    SynthDistBrg(lat1, lon1, lat2, lon2, dist, brg);
+    return dist;
+}
+
+// moves lat/lon by dist [m] into direction brg [°]
+void SynthMove (double& lat, double& lon, double brg, double dist)
+{
+    lat += dist * std::cos(deg2rad(brg)) / SYNTH_M_per_DEG;
+    lon += dist * std::sin(deg2rad(brg)) / (SYNTH_M_per_DEG * std::cos(deg2rad(lat)));
+}
+
+//
+//MARK: Density map
+//
+
+bool SynthReadDensityMap (const std::string& path, vecSynthAreaTy& vAreas)
+{
+    vAreas.clear();
+    std::ifstream fIn (path);
+    if (!fIn)
+        return false;
+    
+    std::string ln;
+    for (int lnNr = 1; std::getline(fIn, ln); lnNr++) {
+        // remove comments, skip empty lines
+        const size_t posComment = ln.find('#');
+        if (posComment != std::string::npos)
+            ln.erase(posComment);
+        if (ln.find_first_not_of(WHITESPACE) == std::string::npos)
+            continue;
+        
+        // <lat> <lon> <radius [nm]> <weight> [<elevation [ft]> [<num airports>]]
+        std::istringstream sIn (ln);
+        synthAreaTy area;
+        double radius_nm = 0.0, elev_ft = 0.0;
+        sIn >> area.lat >> area.lon >> radius_nm >> area.weight;
+        bool bOk = !sIn.fail();
+        if (bOk && sIn >> elev_ft)
+            sIn >> area.numAp;
+        area.radius = radius_nm * M_per_NM;
+        area.elev   = elev_ft * M_per_FT;
+        
+        if (!bOk ||
+            area.lat < -90.0 || area.lat > 90.0 ||
+            area.lon < -180.0 || area.lon > 180.0 ||
+            area.radius <= 0.0 || area.weight <= 0.0 ||
+            area.numAp < 1 || area.numAp > 100)
+        {
+            LOG_MSG(logWARN, ERR_SYNTH_DENSITY_LN, path.c_str(), lnNr, ln.c_str());
+            continue;
+        }
+        vAreas.push_back(area);
+    }
+    
+    LOG_MSG(logINFO, SYNTH_DENSITY_READ, path.c_str(), (int)vAreas.size());
+    return true;
+}
+
+//
+//MARK: ADS-B Exchange format
+//
+
+void SynthWriteADSBEx (std::string& out, const vecSynthReportTy& vRpt)
+{
+    out.clear();
+    out.reserve(100 + vRpt.size() * 320);
+    out += "{\"" ADSBEX_AIRCRAFT_ARR "\":[";
+    
+    char buf[512];
+    bool bFirst = true;
+    for (const synthReportTy& r: vRpt) {
+        const synthFlightStatTy& stat = *r.pStat;
+        snprintf(buf, sizeof(buf),
+                 "%s{\"" ADSBEX_TRANSP_ICAO "\":\"%s\",\"" ADSBEX_CALL "\":\"%s\","
+                 "\"" ADSBEX_REG "\":\"%s\",\"" ADSBEX_AC_TYPE_ICAO "\":\"%s\","
+                 "\"" ADSBEX_OP "\":\"%s\",\"" ADSBEX_OP_ICAO "\":\"%s\","
+                 "\"" ADSBEX_ORIGIN "\":\"%s\",\"" ADSBEX_DESTINATION "\":\"%s\","
+                 "\"" ADSBEX_RADAR_CODE "\":\"%04d\",\"" ADSBEX_TRT "\":2,"
+                 "\"" ADSBEX_POS_TIME "\":%.0f,\"" ADSBEX_LAT "\":%.6f,\"" ADSBEX_LON "\":%.6f,"
+                 "\"" ADSBEX_ELEVATION "\":%.0f,\"" ADSBEX_GND "\":%s,\"" ADSBEX_HEADING "\":%.1f,"
+                 "\"" ADSBEX_SPD "\":%.1f,\"" ADSBEX_VSI "\":%.0f}",
+                 bFirst ? "" : ",",
+                 stat.transpIcao.c_str(), stat.call.c_str(),
+                 stat.reg.c_str(), stat.acTypeIcao.c_str(),
+                 stat.op.c_str(), stat.opIcao.c_str(),
+                 stat.origin.c_str(), stat.dest.c_str(),
+                 stat.sqk,
+                 r.ts * 1000.0, r.lat, r.lon,
+                 r.alt_ft, r.gnd ? "true" : "false", r.heading,
+                 r.spd_kn, r.vsi_ft);
+        out += buf;
+        bFirst = false;
+    }
+    out += "]}";
+}
+
+//
+//MARK: SynthTraffic
+//
+
+SynthTraffic::SynthTraffic (unsigned seed, int numFlights,
+                            const vecSynthAreaTy& vAreas,
+                            const positionTy& ctrPos, double startTs) :
+rnd(seed), simTs(startTs)
+{
+    // flight model per aircraft type, matching them once only
+    // (regex matching is too expensive for every new flight)
+    for (const synthAcTypeTy& t: SYNTH_AC_TYPES)
+        vTypeMdl.push_back(&LTAircraft::FlightModel::FindFlightModel(t.acTypeIcao));
+    
+    // no density map: one area around the given position
+    if (vAreas.empty()) {
+        vecSynthAreaTy vDefault(1);
+        vDefault[0].lat     = ctrPos.lat();
+        vDefault[0].lon     = ctrPos.lon();
+        vDefault[0].radius  = dataRefs.GetFdStdDistance_m();
+        vDefault[0].numAp   = SYNTH_DEFAULT_NUM_AP;
+        CreateAirports(vDefault);
+    } else {
+        CreateAirports(vAreas);
+    }
+    
+    // all flights in some random phase
+    vFlights.resize(size_t(std::max(numFlights, 0)));
+    for (flightTy& f: vFlights)
+        NewFlight(f, true);
+}
+
+// number of flights currently in the given phase
+size_t SynthTraffic::CntPhase (synthPhaseTy phase) const
+{
+    return (size_t)std::count_if(vFlights.cbegin(), vFlights.cend(),
+                                 [phase](const flightTy& f){ return f.phase == phase; });
+}
+
+// uniformly distributed in [from; to)
+double SynthTraffic::RndUniform (double from, double to)
+{
+    return from + (to - from) * (double(rnd()) / 4294967296.0);
+}
+
+// normally distributed around 0 (Box-Muller)
+double SynthTraffic::RndNormal (double sigma)
+{
+    const double u1 = RndUniform(1e-12, 1.0);
+    const double u2 = RndUniform(0.0, 1.0);
+    return sigma * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * PI * u2);
+}
+
+// an airport, chosen according to the density map's weights
+size_t SynthTraffic::RndAirport ()
+{
+    const double w = RndUniform(0.0, vApWeight.back());
+    const size_t i = size_t(std::upper_bound(vApWeight.cbegin(), vApWeight.cend(), w)
+                            - vApWeight.cbegin());
+    return std::min(i, vAp.size() - 1);
+}
+
+void SynthTraffic::CreateAirports (const vecSynthAreaTy& vAreas)
+{
+    double sumWeight = 0.0;
+    for (const synthAreaTy& area: vAreas) {
+        for (int i = 0; i < area.numAp; i++) {
+            apTy ap;
+            char szId[10];
+            snprintf(szId, sizeof(szId), "S%03X", unsigned(vAp.size() & 0xFFF));
+            ap.id = szId;
+            ap.lat = area.lat;
+            ap.lon = area.lon;
+            SynthMove(ap.lat, ap.lon, RndUniform(0.0, 360.0),
+                      RndUniform(0.0, area.radius * SYNTH_AP_SPREAD));
+            ap.elev = area.elev;
+            ap.rwyHdg = 10.0 * std::floor(RndUniform(0.0, 36.0));
+            // final approach fix on the extended center line
+            ap.fafLat = ap.lat;
+            ap.fafLon = ap.lon;
+            SynthMove(ap.fafLat, ap.fafLon, SynthHdgNorm(ap.rwyHdg + 180.0), SYNTH_FAF_DIST);
+            vAp.push_back(ap);
+            
+            sumWeight += area.weight / area.numAp;
+            vApWeight.push_back(sumWeight);
+        }
+    }
+}
+
+// (re)initializes a flight slot with a new flight:
+// bInit: in any phase (initial traffic), otherwise: taxiing out
+void SynthTraffic::NewFlight (flightTy& f, bool bInit)
+{
+    const uint32_t n = cntFlights++;
+    stats.flights++;
+    
+    // aircraft type
+    double sumShare = 0.0;
+    for (const synthAcTypeTy& t: SYNTH_AC_TYPES)
+        sumShare += t.share;
+    double share = RndUniform(0.0, sumShare);
+    size_t iType = 0;
+    while (iType + 1 < vTypeMdl.size() && share >= SYNTH_AC_TYPES[iType].share)
+        share -= SYNTH_AC_TYPES[iType++].share;
+    const synthAcTypeTy& acType = SYNTH_AC_TYPES[iType];
+    f.pMdl = vTypeMdl[iType];
+    const LTAircraft::FlightModel& mdl = *f.pMdl;
+    
+    // route
+    f.apFrom = RndAirport();
+    f.apTo   = RndAirport();
+    for (int i = 0; i < 5 && vAp.size() > 1 && f.apTo == f.apFrom; i++)
+        f.apTo = RndAirport();
+    const apTy& from = vAp[f.apFrom];
+    const apTy& to   = vAp[f.apTo];
+    
+    // static data
+    std::shared_ptr<synthFlightStatTy> pStat = std::make_shared<synthFlightStatTy>();
+    char buf[50];
+    snprintf(buf, sizeof(buf), "%06X", (SYNTH_ICAO_BASE + n) & 0xFFFFFF);
+    pStat->transpIcao = buf;
+    snprintf(buf, sizeof(buf), "SY%05u", n % 100000);
+    pStat->reg = buf;
+    if (*acType.opIcao) {
+        snprintf(buf, sizeof(buf), "%s%u", acType.opIcao, 100 + n % 9900);
+        pStat->call = buf;
+    } else
+        pStat->call = pStat->reg;
+    pStat->acTypeIcao = acType.acTypeIcao;
+    pStat->op     = acType.op;
+    pStat->opIcao = acType.opIcao;
+    pStat->origin = from.id + " Synthetic";
+    pStat->dest   = to.id + " Synthetic";
+    for (int i = 0; i < 4; i++)             // squawk: 4 octal digits
+        pStat->sqk = pStat->sqk * 10 + int(RndUniform(0.0, 8.0));
+    f.pStat = pStat;
+    
+    // short trip? then fly via a waypoint
+    const double tripDist = SynthDist(from.lat, from.lon, to.fafLat, to.fafLon);
+    f.bWp = tripDist < 2 * SYNTH_MIN_LEG;
+    double legDist = tripDist;
+    if (f.bWp) {
+        f.wpLat = from.lat;
+        f.wpLon = from.lon;
+        SynthMove(f.wpLat, f.wpLon, RndUniform(0.0, 360.0),
+                  RndUniform(SYNTH_MIN_LEG, 2 * SYNTH_MIN_LEG));
+        legDist = SynthDist(from.lat, from.lon, f.wpLat, f.wpLon) +
+                  SynthDist(f.wpLat, f.wpLon, to.fafLat, to.fafLon);
+    }
+    
+    // cruise: what the model would like, but climb and descend
+    // need to fit into the trip
+    double alt_ft = mdl.CRUISE_HEIGHT * RndUniform(1.0, 2.5);
+    alt_ft = std::min(alt_ft, SYNTH_ALT_MAX);
+    alt_ft = std::min(alt_ft, (from.elev + legDist / 2.0 * std::tan(deg2rad(SYNTH_GLIDE_SLOPE))) / M_per_FT);
+    alt_ft = std::max(alt_ft, from.elev / M_per_FT + SYNTH_ALT_MIN_AGL);
+    f.cruiseAlt = std::round(alt_ft / 500.0) * 500.0 * M_per_FT;
+    f.cruiseSpd = mdl.FLAPS_UP_SPEED / KT_per_M_per_S *
+                  (mdl.CRUISE_HEIGHT < SYNTH_SPD_LIM_ALT ? SYNTH_CRUISE_FACTOR_LOW : SYNTH_CRUISE_FACTOR);
+    
+    // reports of different flights are not in sync
+    f.nextRptTs = simTs + RndUniform(0.0, SYNTH_REPORT_INTVL);
+    f.vsi = 0.0;
+    
+    // where to start
+    double r = bInit ? RndUniform(0.0, 1.0) : 0.0;
+    if ((r -= SYNTH_SHARE_TAXI) < 0.0) {
+        // at a gate, taxiing to the runway
+        f.phase = SYN_TAXI_OUT;
+        f.lat = f.tgtLat = from.lat;
+        f.lon = f.tgtLon = from.lon;
+        SynthMove(f.lat, f.lon, RndUniform(0.0, 360.0),
+                  RndUniform(SYNTH_GATE_DIST_MIN, SYNTH_GATE_DIST_MAX));
+        double dist = 0.0;
+        SynthDistBrg(f.lat, f.lon, from.lat, from.lon, dist, f.hdg);
+        f.alt = from.elev;
+        f.spd = 0.0;
+    }
+    else if ((r -= SYNTH_SHARE_TAKE_OFF) < 0.0) {
+        // lined up on the runway
+        f.phase = SYN_TAKE_OFF;
+        f.lat = from.lat;
+        f.lon = from.lon;
+        f.hdg = from.rwyHdg;
+        f.alt = from.elev;
+        f.spd = 0.0;
+    }
+    else if ((r -= SYNTH_SHARE_CLIMB) < 0.0) {
+        // climbing out on runway heading
+        const double dist = RndUniform(1000.0, 8000.0);
+        f.phase = SYN_CLIMB;
+        f.lat = from.lat;
+        f.lon = from.lon;
+        SynthMove(f.lat, f.lon, from.rwyHdg, SYNTH_RWY_LEN + dist);
+        f.hdg = from.rwyHdg;
+        f.spd = mdl.SPEED_INIT_CLIMB / KT_per_M_per_S;
+        f.vsi = mdl.VSI_INIT_CLIMB * Ms_per_FTm;
+        f.alt = std::min(from.elev + dist * f.vsi / f.spd, f.cruiseAlt);
+    }
+    else if ((r -= SYNTH_SHARE_APPROACH) < 0.0) {
+        // established on final
+        const double dist = RndUniform(1000.0, SYNTH_FAF_DIST);
+        f.phase = SYN_APPROACH;
+        f.lat = to.lat;
+        f.lon = to.lon;
+        SynthMove(f.lat, f.lon, SynthHdgNorm(to.rwyHdg + 180.0), dist);
+        f.hdg = to.rwyHdg;
+        f.alt = to.elev + dist * std::tan(deg2rad(SYNTH_GLIDE_SLOPE));
+        f.spd = mdl.FLAPS_DOWN_SPEED * SYNTH_APPR_FACTOR / KT_per_M_per_S;
+        f.bWp = false;
+    }
+    else {
+        // somewhere on the first leg
+        const double tgtLat = f.bWp ? f.wpLat : to.fafLat;
+        const double tgtLon = f.bWp ? f.wpLon : to.fafLon;
+        const double q = RndUniform(0.2, 0.8);
+        f.phase = SYN_CRUISE;
+        f.lat = from.lat + q * (tgtLat - from.lat);
+        f.lon = from.lon + q * (tgtLon - from.lon);
+        double dist = 0.0;
+        SynthDistBrg(f.lat, f.lon, tgtLat, tgtLon, dist, f.hdg);
+        f.alt = f.cruiseAlt;
+        f.spd = f.cruiseSpd;
+    }
+}
+
+// advances one flight by dt seconds
+void SynthTraffic::Step (flightTy& f, double dt)
+{
+    const LTAircraft::FlightModel& mdl = *f.pMdl;
+    const apTy& from = vAp[f.apFrom];
+    const apTy& to   = vAp[f.apTo];
+    const double tanGS   = std::tan(deg2rad(SYNTH_GLIDE_SLOPE));
+    const double taxiSpd = mdl.MAX_TAXI_SPEED * SYNTH_TAXI_FACTOR / KT_per_M_per_S;
+    const double spdLim  = SYNTH_SPD_LIM / KT_per_M_per_S;
+    const double spdAppr = mdl.FLAPS_DOWN_SPEED * SYNTH_APPR_FACTOR / KT_per_M_per_S;
+    
+    // what we aim for in this step
+    double tgtHdg = f.hdg, tgtSpd = f.spd, tgtAlt = f.alt;
+    double vsi = 0.0;                       // [m/s] rate to approach tgtAlt with
+    double turnRate = SYNTH_TURN_RATE;
+    double accel = SYNTH_ACCEL_AIR, decel = SYNTH_ACCEL_AIR;
+    double dist = 0.0, brg = 0.0;
+    
+    switch (f.phase) {
+        case SYN_TAXI_OUT:
+        case SYN_TAXI_IN:
+            SynthDistBrg(f.lat, f.lon, f.tgtLat, f.tgtLon, dist, brg);
+            if (dist < SYNTH_ARRIVED) {
+                // at the runway: line up; at the gate: done
+                f.phase = f.phase == SYN_TAXI_OUT ? SYN_TAKE_OFF : SYN_DONE;
+                f.spd = 0.0;
+                return;
+            }
+            tgtHdg = brg;
+            turnRate = 360.0 / mdl.TAXI_TURN_TIME;
+            // slow down for turns and when arriving
+            tgtSpd = std::min(taxiSpd, std::max(dist / 10.0, 1.0));
+            if (std::abs(SynthHdgDiff(f.hdg, brg)) > 30.0)
+                tgtSpd /= 4.0;
+            accel = decel = 1.0;
+            break;
+            
+        case SYN_TAKE_OFF:
+            tgtHdg = from.rwyHdg;
+            turnRate = 360.0 / mdl.TAXI_TURN_TIME;
+            // roll once lined up
+            tgtSpd = std::abs(SynthHdgDiff(f.hdg, tgtHdg)) < 5.0 ? f.cruiseSpd : 0.0;
+            accel = SYNTH_ACCEL_GND;
+            if (f.spd >= mdl.SPEED_INIT_CLIMB * SYNTH_LOF_FACTOR / KT_per_M_per_S)
+                f.phase = SYN_CLIMB;
+            break;
+            
+        case SYN_CLIMB:
+        case SYN_CRUISE:
+        {
+            // towards the waypoint first, then to the final approach fix
+            if (f.bWp) {
+                SynthDistBrg(f.lat, f.lon, f.wpLat, f.wpLon, dist, brg);
+                if (dist < SYNTH_WP_REACHED)
+                    f.bWp = false;
+            }
+            if (!f.bWp)
+                SynthDistBrg(f.lat, f.lon, to.fafLat, to.fafLon, dist, brg);
+            
+            const double agl_ft = (f.alt - from.elev) / M_per_FT;
+            if (f.phase == SYN_CLIMB) {
+                tgtHdg = agl_ft < mdl.AGL_GEAR_UP * 10.0 ? from.rwyHdg : brg;
+                tgtSpd = agl_ft < mdl.AGL_GEAR_DOWN ? mdl.SPEED_INIT_CLIMB / KT_per_M_per_S : f.cruiseSpd;
+                tgtAlt = f.cruiseAlt;
+                vsi = mdl.VSI_INIT_CLIMB * Ms_per_FTm;
+                if (f.alt >= f.cruiseAlt)
+                    f.phase = SYN_CRUISE;
+            } else {
+                tgtHdg = brg;
+                tgtSpd = f.cruiseSpd;
+                tgtAlt = f.cruiseAlt;
+            }
+            if (f.alt / M_per_FT < SYNTH_SPD_LIM_ALT)
+                tgtSpd = std::min(tgtSpd, spdLim);
+            
+            // time to descend?
+            const double fafAlt = to.elev + SYNTH_FAF_HEIGHT;
+            if (!f.bWp && f.alt > fafAlt &&
+                dist <= (f.alt - fafAlt) / tanGS + f.spd * dt)
+                f.phase = SYN_DESCEND;
+            break;
+        }
+            
+        case SYN_DESCEND:
+        {
+            SynthDistBrg(f.lat, f.lon, to.fafLat, to.fafLon, dist, brg);
+            if (dist < SYNTH_FAF_REACHED) {
+                f.phase = SYN_APPROACH;
+                return;
+            }
+            tgtHdg = brg;
+            // reach the fix at its altitude
+            tgtAlt = to.elev + SYNTH_FAF_HEIGHT;
+            vsi = (tgtAlt - f.alt) / std::max(dist / std::max(f.spd, 1.0), dt);
+            vsi = std::max(vsi, SYNTH_VSI_DESCEND * Ms_per_FTm);
+            tgtSpd = dist < 2 * SYNTH_FAF_DIST ? mdl.FLAPS_DOWN_SPEED / KT_per_M_per_S : f.cruiseSpd;
+            if (f.alt / M_per_FT < SYNTH_SPD_LIM_ALT)
+                tgtSpd = std::min(tgtSpd, spdLim);
+            break;
+        }
+            
+        case SYN_APPROACH:
+            SynthDistBrg(f.lat, f.lon, to.lat, to.lon, dist, brg);
+            if (dist < std::max(f.spd * dt, SYNTH_ARRIVED)) {
+                // touch down
+                f.phase = SYN_ROLL_OUT;
+                f.alt = to.elev;
+                f.vsi = 0.0;
+                return;
+            }
+            tgtHdg = brg;
+            tgtSpd = spdAppr;
+            // down the glide slope, but not steeper than the model's final descend rate allows
+            tgtAlt = to.elev + std::max(dist - f.spd * dt, 0.0) * tanGS;
+            vsi = std::min((tgtAlt - f.alt) / dt, 0.0);
+            vsi = std::max(vsi, 2.0 * mdl.VSI_FINAL * Ms_per_FTm);
+            break;
+            
+        case SYN_ROLL_OUT:
+            tgtHdg = to.rwyHdg;
+            tgtSpd = taxiSpd;
+            decel = -mdl.ROLL_OUT_DECEL;
+            if (f.spd <= taxiSpd) {
+                // vacate the runway towards a gate on either side
+                f.phase = SYN_TAXI_IN;
+                f.tgtLat = f.lat;
+                f.tgtLon = f.lon;
+                SynthMove(f.tgtLat, f.tgtLon,
+                          SynthHdgNorm(to.rwyHdg + (RndChance(0.5) ? 90.0 : -90.0)),
+                          RndUniform(SYNTH_GATE_DIST_MIN, SYNTH_GATE_DIST_MAX));
+            }
+            break;
+            
+        case SYN_DONE:
+        case SYN_CNT_PHASES:
+            return;
+    }
+    
+    // turn
+    const double maxTurn = turnRate * dt;
+    f.hdg = SynthHdgNorm(f.hdg + std::clamp(SynthHdgDiff(f.hdg, tgtHdg), -maxTurn, maxTurn));
+    
+    // accelerate/decelerate
+    if (f.spd < tgtSpd)
+        f.spd = std::min(tgtSpd, f.spd + accel * dt);
+    else
+        f.spd = std::max(tgtSpd, f.spd - decel * dt);
+    
+    // move
+    SynthMove(f.lat, f.lon, f.hdg, f.spd * dt);
+    
+    // climb/descend
+    const double alt = f.alt;
+    if (vsi > 0.0)
+        f.alt = std::min(tgtAlt, f.alt + vsi * dt);
+    else if (vsi < 0.0)
+        f.alt = std::max(tgtAlt, f.alt + vsi * dt);
+    f.vsi = (f.alt - alt) / dt;
+}
+
+// sends a report of the flight's current position,
+// or not, or twice, or later
+void SynthTraffic::Report (const flightTy& f, vecSynthReportTy& vOut)
+{
+    if (RndChance(SYNTH_P_DROP)) {
+        stats.dropped++;
+        return;
+    }
+    
+    synthReportTy rpt;
+    rpt.pStat = f.pStat;
+    rpt.ts = simTs;
+    rpt.lat = f.lat;
+    rpt.lon = f.lon;
+    SynthMove(rpt.lat, rpt.lon, RndUniform(0.0, 360.0), std::abs(RndNormal(SYNTH_NOISE_POS)));
+    rpt.gnd     = f.IsOnGnd();
+    rpt.alt_ft  = f.alt / M_per_FT + (rpt.gnd ? 0.0 : RndNormal(SYNTH_NOISE_ALT));
+    rpt.heading = SynthHdgNorm(f.hdg + RndNormal(SYNTH_NOISE_HDG));
+    rpt.spd_kn  = std::max(f.spd * KT_per_M_per_S + RndNormal(SYNTH_NOISE_SPD), 0.0);
+    rpt.vsi_ft  = f.vsi / Ms_per_FTm;
+    
+    if (RndChance(SYNTH_P_LATE)) {
+        vLate.push_back(std::move(rpt));
+        stats.late++;
+        return;
+    }
+    
+    vOut.push_back(rpt);
+    stats.reports++;
+    if (RndChance(SYNTH_P_DUPLICATE)) {
+        vOut.push_back(std::move(rpt));
+        stats.reports++;
+        stats.duplicates++;
+    }
+}
+
+// advances all flights to ts, appending the reports sent on the way
+void SynthTraffic::Advance (double ts, vecSynthReportTy& vOut)
+{
+    // the reports held back last time arrive after the new ones
+    vecSynthReportTy vDue;
+    vDue.swap(vLate);
+    
+    while (simTs + SYNTH_STEP <= ts) {
+        simTs += SYNTH_STEP;
+        for (flightTy& f: vFlights) {
+            // parked flights are replaced by new departures
+            if (f.phase == SYN_DONE)
+                NewFlight(f, false);
+            Step(f, SYNTH_STEP);
+            if (simTs >= f.nextRptTs) {
+                Report(f, vOut);
+                f.nextRptTs += SYNTH_REPORT_INTVL * RndUniform(0.7, 1.3);
+            }
+        }
+    }
+    
+    stats.reports += (long)vDue.size();
+    vOut.insert(vOut.end(),
+                std::make_move_iterator(vDue.begin()),
+                std::make_move_iterator(vDue.end()));
+}
@@ -0,0 +1,306 @@
+//
+//  LTTerrain.cpp
+//  LiveTraffic
+
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "LiveTraffic.h"
+
+#include <chrono>
+#include <unordered_map>
+
+//
+//MARK: Terrain probe service
+//
+
+// a queued probe request
+struct probeReqTy {
+    positionTy          pos;            // where to probe
+    bool                bCritical;      // on the ground/on final?
+    double              tsReq;          // [s] sim time when first requested
+    bool                bCacheChecked;  // terrain cache already consulted for pos?
+    probeDeliverFuncTy  deliver;        // receives the result
+};
+
+// requests by owner/key, sorted by owner so we can cancel by owner easily
+typedef std::pair<const void*,double> probeReqKeyTy;
+typedef std::map<probeReqKeyTy,probeReqTy> mapProbeReqTy;
+
+mapProbeReqTy       mapProbeReq;        // all open requests
+std::mutex          probeReqMutex;      // guards mapProbeReq
+XPLMProbeRef        probeRefSvc = NULL; // the one probe handle we use
+int                 probeSyncCnt = 0;   // synchronous probes since last TerrainProbeProcess
+std::thread::id     probeMainThread;    // X-Plane's main thread, set by TerrainProbeInit
+
+inline uint64_t TerrainCacheKey (const positionTy& pos);
+
+// remembers the calling thread as the main thread
+void TerrainProbeInit ()
+{
+    probeMainThread = std::this_thread::get_id();
+}
+
+// queues/updates a probe request,
+// unless the main thread asks for a cached position, which is served right away
+double TerrainProbeRequest (const void* owner, double key,
+                            const positionTy& pos, bool bCritical,
+                            probeDeliverFuncTy&& deliver)
+{
+    // The cache is main thread only, so other threads' requests
+    // are looked up once by the next TerrainProbeProcess
+    const bool bMainThread = std::this_thread::get_id() == probeMainThread;
+    const double cachedAlt = bMainThread ? TerrainCacheGet(pos) : NAN;
+    
+    std::lock_guard<std::mutex> lock (probeReqMutex);
+    mapProbeReqTy::iterator it = mapProbeReq.find(probeReqKeyTy(owner,key));
+    if (!std::isnan(cachedAlt)) {
+        // served from cache, any older request is obsolete
+        if (it != mapProbeReq.end())
+            mapProbeReq.erase(it);
+        return cachedAlt;
+    }
+    
+    if (it == mapProbeReq.end()) {
+        // new request
+        mapProbeReq.emplace(probeReqKeyTy(owner,key),
+                            probeReqTy{pos, bCritical,
+                                       dataRefs.GetSimTime(),
+                                       bMainThread,
+                                       std::move(deliver)});
+    } else {
+        // update existing request, but keep its age,
+        // moved to another cache cell it needs another cache lookup
+        probeReqTy& req = it->second;
+        if (bMainThread)
+            req.bCacheChecked = true;
+        else if (TerrainCacheKey(pos) != TerrainCacheKey(req.pos))
+            req.bCacheChecked = false;
+        req.pos = pos;
+        req.bCritical = bCritical;
+        req.deliver = std::move(deliver);
+    }
+    return NAN;
+}
+
+// removes all requests of the owner
+void TerrainProbeCancel (const void* owner)
+{
+    std::lock_guard<std::mutex> lock (probeReqMutex);
+    mapProbeReq.erase(mapProbeReq.lower_bound(probeReqKeyTy(owner,-INFINITY)),
+                      mapProbeReq.upper_bound(probeReqKeyTy(owner,INFINITY)));
+}
+
+// probes right away (unless cached)
+double TerrainProbeSync (const positionTy& pos)
+{
+    const double cachedAlt = TerrainCacheGet(pos);
+    if (!std::isnan(cachedAlt))
+        return cachedAlt;
+    probeSyncCnt++;
+    return YProbe_at_m(pos, probeRefSvc, false);
+}
+
+// hands the result to the requester
+void TerrainProbeDeliver (probeReqTy& req, double terrainAlt_m)
+{
+    try {
+        req.deliver(terrainAlt_m);
+    } catch (const std::exception& e) {
+        LOG_MSG(logERR, ERR_TOP_LEVEL_EXCEPTION, e.what());
+    }
+}
+
+// Serves requests, which other threads queued and which are found in the
+// terrain cache, right away and then the most urgent other requests,
+// not more than the budget allows.
+// Priority is the distance to the camera [m], plus a penalty for
+// non-critical requests, minus a bonus for the time already waited
+// (so that even far away requests are served eventually).
+void TerrainProbeProcess ()
+{
+    // synchronous probes since last call count against the budget
+    int budget = std::max(dataRefs.GetProbeBudget() - probeSyncCnt, 0);
+    probeSyncCnt = 0;
+    
+    // take cached and the most urgent requests out of the queue
+    std::vector<probeReqTy> vCached;
+    std::vector<double>     vCachedAlt;
+    std::vector<probeReqTy> vDue;
+    {
+        std::lock_guard<std::mutex> lock (probeReqMutex);
+        if (mapProbeReq.empty())
+            return;
+        
+        // the frame-time governor might defer the actual probes (not the cache hits)
+        if (budget > 0 && !GovernorAllow(GOV_PROBES))
+            budget = 0;
+        
+        const positionTy viewPos = DataRefs::GetViewPos();
+        const double now = dataRefs.GetSimTime();
+        
+        typedef std::pair<double,mapProbeReqTy::iterator> prioReqTy;
+        std::vector<prioReqTy> vPrio;
+        vPrio.reserve(mapProbeReq.size());
+        for (mapProbeReqTy::iterator it = mapProbeReq.begin();
+             it != mapProbeReq.end();
+             /* incremented in loop */)
+        {
+            probeReqTy& req = it->second;
+            
+            // not yet looked up in the cache? Cache hits don't need any of the budget
+            if (!req.bCacheChecked) {
+                req.bCacheChecked = true;
+                const double cachedAlt = TerrainCacheGet(req.pos);
+                if (!std::isnan(cachedAlt)) {
+                    vCached.emplace_back(std::move(req));
+                    vCachedAlt.push_back(cachedAlt);
+                    it = mapProbeReq.erase(it);
+                    continue;
+                }
+            }
+            
+            const double waited = now - req.tsReq;
+            vPrio.emplace_back(CoordDistance(viewPos, req.pos) +
+                               (req.bCritical ? 0.0 : PROBE_PRIO_NOT_CRIT) -
+                               waited * PROBE_PRIO_AGING,
+                               it);
+            ++it;
+        }
+        
+        const size_t n = std::min(size_t(budget), vPrio.size());
+        std::partial_sort(vPrio.begin(), vPrio.begin() + n, vPrio.end(),
+                          [](const prioReqTy& a, const prioReqTy& b)
+                          { return a.first < b.first; });
+        
+        vDue.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            vDue.emplace_back(std::move(vPrio[i].second->second));
+            mapProbeReq.erase(vPrio[i].second);
+        }
+    }
+    
+    // probe and deliver outside the lock (receivers might request again)
+    for (size_t i = 0; i < vCached.size(); i++)
+        TerrainProbeDeliver(vCached[i], vCachedAlt[i]);
+    for (probeReqTy& req: vDue)
+        TerrainProbeDeliver(req, YProbe_at_m(req.pos, probeRefSvc, false));
+}
+
+// number of requests waiting to be served
+size_t TerrainProbeNumPending ()
+{
+    std::lock_guard<std::mutex> lock (probeReqMutex);
+    return mapProbeReq.size();
+}
+
+// removes all requests, releases probe handle
+void TerrainProbeCleanup ()
+{
+    {
+        std::lock_guard<std::mutex> lock (probeReqMutex);
+        mapProbeReq.clear();
+    }
+    if (probeRefSvc) {
+        XPLMDestroyProbe(probeRefSvc);
+        probeRefSvc = NULL;
+    }
+    probeSyncCnt = 0;
+    TerrainCacheClear();
+}
+
+//
+//MARK: Terrain elevation cache
+//
+
+// cache cells in order of use, most recently used first
+typedef std::list<std::pair<uint64_t,double> > listTerrainCacheTy;
+// index into that list by cell key
+typedef std::unordered_map<uint64_t,listTerrainCacheTy::iterator> mapTerrainCacheTy;
+
+listTerrainCacheTy  listTerrainCache;
+mapTerrainCacheTy   mapTerrainCache;
+unsigned long       terrainCacheHits = 0;     // lookups served from cache
+unsigned long       terrainCacheProbes = 0;   // actual probes, which filled the cache
+
+// key of the cell pos is in: quantised lat in the upper, lon in the lower 32 bits
+inline uint64_t TerrainCacheKey (const positionTy& pos)
+{
+    const int32_t latIdx = int32_t(std::floor(pos.lat() / TERRAIN_CACHE_RES));
+    const int32_t lonIdx = int32_t(std::floor(pos.lon() / TERRAIN_CACHE_RES));
+    return (uint64_t(uint32_t(latIdx)) << 32) | uint64_t(uint32_t(lonIdx));
+}
+
+// cached terrain altitude [m] at pos, NaN if not cached
+double TerrainCacheGet (const positionTy& pos)
+{
+    mapTerrainCacheTy::iterator it = mapTerrainCache.find(TerrainCacheKey(pos));
+    if (it == mapTerrainCache.end())
+        return NAN;
+    
+    // move to front of the LRU list
+    terrainCacheHits++;
+    listTerrainCache.splice(listTerrainCache.begin(), listTerrainCache, it->second);
+    return it->second->second;
+}
+
+// stores terrain altitude [m] at pos
+void TerrainCachePut (const positionTy& pos, double terrainAlt_m)
+{
+    if (std::isnan(terrainAlt_m))
+        return;
+    terrainCacheProbes++;
+    
+    const uint64_t key = TerrainCacheKey(pos);
+    mapTerrainCacheTy::iterator it = mapTerrainCache.find(key);
+    if (it != mapTerrainCache.end()) {
+        // known already: update and move to front
+        it->second->second = terrainAlt_m;
+        listTerrainCache.splice(listTerrainCache.begin(), listTerrainCache, it->second);
+        return;
+    }
+    
+    // full? Evict least recently used cell
+    if (mapTerrainCache.size() >= TERRAIN_CACHE_SIZE) {
+        mapTerrainCache.erase(listTerrainCache.back().first);
+        listTerrainCache.pop_back();
+    }
+    
+    listTerrainCache.emplace_front(key, terrainAlt_m);
+    mapTerrainCache.emplace(key, listTerrainCache.begin());
+}
+
+// empties the cache, e.g. after scenery reload, and restarts statistics
+void TerrainCacheClear ()
+{
+    listTerrainCache.clear();
+    mapTerrainCache.clear();
+    terrainCacheHits = terrainCacheProbes = 0;
+}
+
+// percentage of terrain altitudes served from the cache
+// (as opposed to actually probing)
+float TerrainCacheHitRate ()
+{
+    const unsigned long total = terrainCacheHits + terrainCacheProbes;
+    return total ? float(terrainCacheHits) * 100.0f / float(total) : 0.0f;
+}
@@ -0,0 +1,178 @@
+//
+//  LTTrace.cpp
+//  LiveTraffic
+
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "LiveTraffic.h"
+
+#include <chrono>
+#include <fstream>
+
+//
+//MARK: Global
+//
+
+// one slot in the ring: seq == index+1 if the record is complete
+struct traceSlotTy {
+    std::atomic<uint64_t>   seq;
+    traceRecTy              rec;
+};
+
+traceSlotTy             traceRing[TRACE_RING_SIZE];
+std::atomic<uint64_t>   traceNext(0);       // index of next record to write
+std::mutex              traceFlushMutex;    // only one flush at a time
+const std::chrono::steady_clock::time_point traceStart = std::chrono::steady_clock::now();
+
+//
+//MARK: Recording
+//
+
+// record an event
+void TraceEvent (traceEvtTy evt, unsigned int acKey, const positionTy& pos, uint16_t info)
+{
+    const uint64_t idx = traceNext.fetch_add(1, std::memory_order_relaxed);
+    traceSlotTy& slot = traceRing[idx & (TRACE_RING_SIZE-1)];
+    
+    // mark slot as being written, then fill and publish it
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    traceRecTy& rec = slot.rec;
+    rec.tWall   = std::chrono::duration<double>(std::chrono::steady_clock::now() - traceStart).count();
+    rec.posTs   = pos.ts();
+    rec.lat     = pos.lat();
+    rec.lon     = pos.lon();
+    rec.alt_m   = float(pos.alt_m());
+    rec.acKey   = acKey;
+    rec.evt     = evt;
+    rec.gnd     = uint8_t(pos.onGrnd);
+    rec.info    = info;
+    slot.seq.store(idx+1, std::memory_order_release);
+}
+
+//
+//MARK: Writing to file
+//      Writing happens in a short-lived background thread, so that
+//      neither the main thread nor any other thread raising LTErrorFD
+//      has to wait for about 3 MB of records to hit the disk.
+//
+
+std::thread             traceWriteThread;
+std::atomic<bool>       bTraceWriting(false);   // write thread busy?
+int                     traceErrFiles = 0;      // number of trace files written on errors
+std::chrono::steady_clock::time_point traceErrLast; // when the last of those was written
+
+// write the memory ring to the given file (write thread only)
+void TraceWrite (const std::string& sFileName)
+{
+    // copy all complete records, oldest first
+    // (records being written right now are skipped)
+    const uint64_t next = traceNext.load(std::memory_order_acquire);
+    const uint64_t first = next > TRACE_RING_SIZE ? next - TRACE_RING_SIZE : 0;
+    std::vector<traceRecTy> vRec;
+    vRec.reserve(size_t(next - first));
+    for (uint64_t idx = first; idx < next; idx++) {
+        const traceSlotTy& slot = traceRing[idx & (TRACE_RING_SIZE-1)];
+        if (slot.seq.load(std::memory_order_acquire) != idx+1)
+            continue;
+        traceRecTy rec = slot.rec;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == idx+1)
+            vRec.push_back(rec);
+    }
+    
+    // write header and records
+    std::ofstream out (sFileName, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!out) {
+        char sErr[SERR_LEN];
+        strerror_s(sErr, sizeof(sErr), errno);
+        LOG_MSG(logERR, DBG_TRACE_ERR_OPEN_OUT, sFileName.c_str(), sErr);
+        bTraceWriting = false;
+        return;
+    }
+    traceFileHeadTy head;
+    memcpy(head.magic, TRACE_FILE_MAGIC, sizeof(head.magic));
+    head.version = TRACE_FILE_VER;
+    head.recSize = sizeof(traceRecTy);
+    head.numRec  = uint32_t(vRec.size());
+    head.numLost = uint32_t(first);
+    out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+    out.write(reinterpret_cast<const char*>(vRec.data()), std::streamsize(vRec.size() * sizeof(traceRecTy)));
+    out.close();
+    
+    LOG_MSG(logINFO, DBG_TRACE_WRITTEN, head.numRec, sFileName.c_str());
+    bTraceWriting = false;
+}
+
+// start the write thread, false if it is still busy with the previous file
+bool TraceWriteStart (const std::string& sFileName)
+{
+    if (bTraceWriting.exchange(true))
+        return false;
+    // previous thread has finished (or is just about to), reap it
+    if (traceWriteThread.joinable())
+        traceWriteThread.join();
+    traceWriteThread = std::thread(TraceWrite, sFileName);
+    return true;
+}
+
+// write the memory ring to PATH_TRACE_FILE
+bool TraceFlush ()
+{
+    std::lock_guard<std::mutex> lock (traceFlushMutex);
+    return TraceWriteStart(LTCalcFullPath(PATH_TRACE_FILE));
+}
+
+// write the memory ring to a time-stamped file after an error,
+// but not too often, so that later errors don't replace
+// the trace of the first one and the disk doesn't fill up
+bool TraceFlushOnError ()
+{
+    std::lock_guard<std::mutex> lock (traceFlushMutex);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (traceErrFiles >= TRACE_ERR_MAX_FILES ||
+        (traceErrFiles > 0 && now - traceErrLast < std::chrono::seconds(TRACE_ERR_MIN_INTVL)))
+        return false;
+    
+    // file name with current local time
+    char szName[100];
+    const std::time_t t = std::time(nullptr);
+    std::tm tm;
+    localtime_s(&tm, &t);
+    std::strftime(szName, sizeof(szName), PATH_TRACE_ERR_FILE, &tm);
+    
+    if (!TraceWriteStart(LTCalcFullPath(szName)))
+        return false;
+    traceErrFiles++;
+    traceErrLast = now;
+    return true;
+}
+
+// wait for a pending write to finish
+void TraceStop ()
+{
+    std::lock_guard<std::mutex> lock (traceFlushMutex);
+    if (traceWriteThread.joinable())
+        traceWriteThread.join();
+    traceWriteThread = std::thread();
+}
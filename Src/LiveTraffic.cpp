@@ -139,8 +139,13 @@ PLUGIN_API int XPluginStart(
 							char *		outSig,
 							char *		outDesc)
 {
+    // write log output asynchronously from now on
+    // (X-Plane doesn't call XPluginStop after a failed start,
+    //  so every failure return below has to stop the writer again)
+    LogWriterStart();
+    
     // init our version number
-    if (!InitFullVersion ()) return 0;
+    if (!InitFullVersion ()) { LogWriterStop(); return 0; }
 
     // init random numbers
      srand((unsigned int)time(NULL));
@@ -158,16 +163,16 @@ PLUGIN_API int XPluginStart(
     XPLMEnableFeature("XPLM_USE_NATIVE_PATHS",1);
 
     // init DataRefs
-    if (!dataRefs.Init()) return 0;
+    if (!dataRefs.Init()) { LogWriterStop(); return 0; }
     
     // read FlightModel.prf file (which we could live without)
     LTAircraft::FlightModel::ReadFlightModelFile();
     
     // init Aircraft handling (including XPMP)
-    if (!LTMainInit()) return 0;
+    if (!LTMainInit()) { LogWriterStop(); return 0; }
     
     // create menu
-    if (!RegisterMenuItem()) return 0;
+    if (!RegisterMenuItem()) { LogWriterStop(); return 0; }
     
     // Success
     return 1;
@@ -191,8 +196,12 @@ PLUGIN_API int  XPluginEnable(void)
     return 1;
 }
 
-PLUGIN_API void XPluginReceiveMessage(XPLMPluginID /*inFrom*/, int /*inMsg*/, void * /*inParam*/)
-{ }
+PLUGIN_API void XPluginReceiveMessage(XPLMPluginID /*inFrom*/, int inMsg, void * /*inParam*/)
+{
+    // new scenery loaded: cached terrain altitudes might no longer be valid
+    if (inMsg == XPLM_MSG_SCENERY_LOADED)
+        TerrainCacheClear();
+}
 
 PLUGIN_API void XPluginDisable(void) {
     // if there still is a message window remove it
@@ -217,5 +226,8 @@ PLUGIN_API void    XPluginStop(void)
     
     // Cleanup dataRef registration
     dataRefs.Stop();
+    
+    // write remaining log output, stop the writer thread
+    LogWriterStop();
 }
 
@@ -41,9 +41,9 @@ std::logic_error(GetLogString(_szFile, _ln, _szFunc, _lvl, _szMsg, NULL))
     msg = GetLogString(_szFile, _ln, _szFunc, _lvl, _szMsg, args);
     va_end (args);
     
-    // write to log (flushed immediately -> expensive!)
+    // write to log
     if (_lvl >= dataRefs.GetLogLevel())
-        XPLMDebugString ( msg.c_str() );
+        LogWrite ( msg.c_str() );
 }
 
 // protected constructor, only called by LTErrorFD
@@ -65,7 +65,6 @@ LTErrorFD::LTErrorFD (LTFlightData& _fd,
                       logLevelTy _lvl,
                       const char* _szMsg, ...) :
 fd(_fd),
-posStr(_fd.Positions2String()),
 LTError(_szFile,_ln,_szFunc,_lvl)
 {
     va_list args;
@@ -73,10 +72,18 @@ LTError(_szFile,_ln,_szFunc,_lvl)
     msg = GetLogString(_szFile, _ln, _szFunc, _lvl, _szMsg, args);
     va_end (args);
     
-    // write to log (flushed immediately -> expensive!)
+    // the position trace tells the history of all aircraft,
+    // the expensive text dump of positions we do for the debug aircraft only
+    TraceEvent(TRC_ERROR, _fd.keyInt(), positionTy());
+    TraceFlushOnError();
+    if (dataRefs.GetDebugAcPos(_fd.key()))
+        posStr = _fd.Positions2String();
+    
+    // write to log
     if (_lvl >= dataRefs.GetLogLevel()) {
-        XPLMDebugString ( msg.c_str() );
-        XPLMDebugString ( posStr.c_str() );
+        LogWrite ( msg.c_str() );
+        if (!posStr.empty())
+            LogWrite ( posStr.c_str() );
     }
 }
 
@@ -283,11 +290,11 @@ const char* LOG_LEVEL[] = {
     "DEBUG", "INFO ", "WARN ", "ERROR", "FATAL", "MSG  "
 };
 
-// returns ptr to static buffer filled with log string
+// returns ptr to thread-local buffer filled with log string
 const char* GetLogString (const char* szPath, int ln, const char* szFunc,
                           logLevelTy lvl, const char* szMsg, va_list args )
 {
-    static char aszMsg[2048];
+    thread_local char aszMsg[LOG_LINE_LEN];
     const double simTime = dataRefs.GetSimTime();
 
     // prepare timestamp
@@ -318,7 +325,7 @@ const char* GetLogString (const char* szPath, int ln, const char* szFunc,
         aszMsg[l+1] = 0;
     }
 
-    // return the static buffer
+    // return the thread-local buffer
     return aszMsg;
 }
 
@@ -327,7 +334,159 @@ void LogMsg ( const char* szPath, int ln, const char* szFunc, logLevelTy lvl, co
     va_list args;
 
     va_start (args, szMsg);
-    // write to log (flushed immediately -> expensive!)
-    XPLMDebugString ( GetLogString(szPath, ln, szFunc, lvl, szMsg, args) );
+    // queue for writing to log
+    LogWrite ( GetLogString(szPath, ln, szFunc, lvl, szMsg, args) );
     va_end (args);
 }
+
+//
+//MARK: Asynchronous Log Writer
+//      Bounded multi-producer ring buffer of log lines (sequence numbers
+//      per slot as in Dmitry Vyukov's bounded queue), any thread queues
+//      without locking, the writer thread is the only consumer.
+//
+
+// one line in the ring buffer
+struct logSlotTy {
+    std::atomic<size_t> seq;            // == pos: free for writing, == pos+1: filled
+    char                szLine[LOG_LINE_LEN];
+};
+
+logSlotTy           logRing[LOG_RING_SIZE];
+std::atomic<size_t> logEnqPos(0);       // next position to fill
+size_t              logDeqPos = 0;      // next position to write (writer thread, or LogWriterStop after join)
+std::atomic<int>    logDropped(0);      // lines dropped because ring buffer was full
+int                 logDroppedReported = 0; // dropped lines already reported (writer thread only)
+
+std::thread         logWriterThread;
+std::atomic<bool>   bLogWriterRunning(false);   // lines are queued only while writer is running
+std::atomic<bool>   bLogWriterStop(false);
+std::atomic<int>    logWritersActive(0);        // LogWrite calls currently queueing lines
+
+// writes all queued lines to X-Plane's log in batches (only one consumer at a time)
+void LogDrain ()
+{
+    std::string batch;
+    for (;;) {
+        logSlotTy& slot = logRing[logDeqPos & (LOG_RING_SIZE-1)];
+        if (slot.seq.load(std::memory_order_acquire) != logDeqPos + 1)
+            break;                      // no more filled slots
+        batch += slot.szLine;
+        slot.seq.store(logDeqPos + LOG_RING_SIZE, std::memory_order_release);
+        logDeqPos++;
+        
+        if (batch.size() >= LOG_BATCH_LEN) {
+            XPLMDebugString(batch.c_str());
+            batch.clear();
+        }
+    }
+    
+    // report dropped lines
+    const int dropped = logDropped.load();
+    if (dropped > logDroppedReported) {
+        char buf[100];
+        snprintf(buf, sizeof(buf), "%s: " ERR_LOG_DROPPED "\n",
+                 LIVE_TRAFFIC, dropped - logDroppedReported);
+        batch += buf;
+        logDroppedReported = dropped;
+    }
+    
+    if (!batch.empty())
+        XPLMDebugString(batch.c_str());
+}
+
+// the writer thread's main function
+void LogWriterMain ()
+{
+    while (!bLogWriterStop)
+    {
+        LogDrain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(LOG_WRITER_INTVL_MS));
+    }
+    LogDrain();
+}
+
+// start the writer thread (before, log lines are written synchronously)
+void LogWriterStart ()
+{
+    if (bLogWriterRunning)
+        return;
+    
+    // reset the ring buffer
+    for (size_t i = 0; i < LOG_RING_SIZE; i++)
+        logRing[i].seq.store(i, std::memory_order_relaxed);
+    logEnqPos = 0;
+    logDeqPos = 0;
+    
+    bLogWriterStop = false;
+    logWriterThread = std::thread(LogWriterMain);
+    bLogWriterRunning = true;
+}
+
+// write all remaining lines, stop the writer thread
+// (after, log lines are written synchronously)
+void LogWriterStop ()
+{
+    if (!bLogWriterRunning)
+        return;
+    bLogWriterRunning = false;
+    bLogWriterStop = true;
+    if (logWriterThread.joinable())
+        logWriterThread.join();
+    logWriterThread = std::thread();
+    
+    // LogWrite calls, which saw the writer still running, might still be
+    // queueing lines: wait for them, then write what they queued
+    while (logWritersActive.load() > 0)
+        std::this_thread::yield();
+    LogDrain();
+}
+
+// queue a line (or several) of text for writing to X-Plane's log
+void LogWrite ( const char* szText )
+{
+    // writer not running: write synchronously
+    // (registering as active writer first lets LogWriterStop wait for us)
+    logWritersActive++;
+    if (!bLogWriterRunning) {
+        logWritersActive--;
+        XPLMDebugString(szText);
+        return;
+    }
+    
+    // long text is split across several slots
+    size_t len = strlen(szText);
+    do {
+        const size_t lnLen = std::min(len, LOG_LINE_LEN-1);
+        size_t pos = logEnqPos.load(std::memory_order_relaxed);
+        for (;;) {
+            logSlotTy& slot = logRing[pos & (LOG_RING_SIZE-1)];
+            const size_t seq = slot.seq.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+            if (diff == 0) {
+                // slot is free, try to claim it
+                if (logEnqPos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) {
+                    memcpy(slot.szLine, szText, lnLen);
+                    slot.szLine[lnLen] = 0;
+                    slot.seq.store(pos+1, std::memory_order_release);
+                    break;
+                }
+            } else if (diff < 0) {
+                // ring buffer full: drop the line
+                logDropped++;
+                break;
+            } else
+                // another thread claimed the slot, try the next one
+                pos = logEnqPos.load(std::memory_order_relaxed);
+        }
+        szText += lnLen;
+        len -= lnLen;
+    } while (len > 0);
+    logWritersActive--;
+}
+
+// number of log lines dropped because the ring buffer was full
+int LogDroppedCount ()
+{
+    return logDropped.load();
+}
@@ -0,0 +1,545 @@
+//
+//  LTBench.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Benchmarks of the ingest and position pipeline, run headless
+// (livetraffic_core with the X-Plane stubs, see Headless/XPStub.h).
+//
+// Micro:  CoordDistance, CoordAngle, CoordPlusVector, positionTy copies,
+//         positionDequeFindAdjacentTS
+// Macro:  OpenSky and ADS-B Exchange ProcessFetchedData on the fixtures,
+//         AppendNewPos, DataCleansing, CalcNextPos, and a full CalcPPos
+//         frame (LTAircraft::UpdateAll plus drawing) across N aircraft
+//
+// Results are written as JSON, so that runs can be compared across changes.
+//
+// Usage: livetraffic_bench [-t <min seconds per benchmark>] [-n <num aircraft>]
+//                          [-a <AircraftList.json>] [-o <states.json>]
+//                          [-f <result file>]
+//        defaults: 1s, 100 aircraft (5..MAX_NUM_AC_HEADLESS, beyond the plugin's limit),
+//                  Data/ADSB/REST/ADSBExchange_20180402_1955_UTC.json,
+//                  Data/OpenSky/OpenSky_20180420_1955_UTC.json,
+//                  results to stdout
+//        Run from LiveTraffic's root folder, which also serves as
+//        plugin folder (Resources/...).
+
+#include "LiveTraffic.h"
+#include "XPStub.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+PLUGIN_API int  XPluginStart (char* outName, char* outSig, char* outDesc);
+PLUGIN_API void XPluginStop (void);
+
+//
+//MARK: Settings
+//
+
+double      benchMinSec     = 1.0;          // min timed duration per benchmark
+int         benchNumAc      = 100;          // aircraft in the macro benchmarks
+std::string benchADSBExFile ("Data/ADSB/REST/ADSBExchange_20180402_1955_UTC.json");
+std::string benchOpSkyFile  ("Data/OpenSky/OpenSky_20180420_1955_UTC.json");
+std::string benchResultFile;                // empty: stdout
+
+// synthetic tracks
+const int    BENCH_TRACK_POS    = 121;      // positions per aircraft
+const double BENCH_TRACK_INTVL  = 10.0;     // [s] between positions
+const double BENCH_TRACK_SPEED  = 140.0;    // [m/s]
+const double BENCH_TRACK_ALT    = 3000.0;   // [m]
+const double BENCH_AREA_DIST    = 20000.0;  // [m] max distance of track starts from camera
+const double BENCH_VIEW_LAT     = 51.4700;  // camera position
+const double BENCH_VIEW_LON     = -0.4543;
+
+// number of elements per call in the micro benchmarks
+const size_t BENCH_MICRO_N      = 1024;
+
+//
+//MARK: Benchmark runner
+//
+
+// one benchmark's result
+struct benchResultTy {
+    std::string name;           // benchmark's name
+    std::string unit;           // what one operation is
+    double      ops = 0;        // number of operations timed
+    double      sec = 0;        // total time [s] of these operations
+    
+    double nsPerOp () const { return ops > 0 ? sec * 1e9 / ops : NAN; }
+};
+
+std::vector<benchResultTy> vBenchResults;
+
+// results of calculations end up here, so that they aren't optimized away
+volatile double benchSink = 0.0;
+
+// Runs 'setup' (not timed) and 'run' (timed, returns number of operations)
+// repeatedly until at least benchMinSec of timed runs are collected
+template <class SetupT, class RunT>
+void Bench (const char* name, const char* unit, SetupT setup, RunT run)
+{
+    benchResultTy res;
+    res.name = name;
+    res.unit = unit;
+    do {
+        setup();
+        const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        res.ops += run();
+        res.sec += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    } while (res.sec < benchMinSec && res.ops > 0);
+    fprintf(stderr, "%-28s %14.1f ns/%s\n", name, res.nsPerOp(), unit);
+    vBenchResults.push_back(res);
+}
+
+// benchmark without setup
+template <class RunT>
+void Bench (const char* name, const char* unit, RunT run)
+{
+    Bench(name, unit, []{}, run);
+}
+
+//
+//MARK: Test data
+//
+
+std::mt19937 benchRnd (4711);          // fixed seed: same data every run
+
+// random position around the camera, in cruise
+positionTy RandomPos (double ts = NAN)
+{
+    std::uniform_real_distribution<double> dAngle (0.0, 360.0);
+    std::uniform_real_distribution<double> dDist  (0.0, BENCH_AREA_DIST);
+    positionTy pos = positionTy(BENCH_VIEW_LAT, BENCH_VIEW_LON, BENCH_TRACK_ALT, ts)
+                     .destPos(vectorTy(dAngle(benchRnd), dDist(benchRnd)));
+    pos.onGrnd = positionTy::GND_OFF;
+    return pos;
+}
+
+// a straight, level track starting at ts0
+dequePositionTy RandomTrack (double ts0)
+{
+    std::uniform_real_distribution<double> dAngle (0.0, 360.0);
+    const vectorTy vec (dAngle(benchRnd), BENCH_TRACK_SPEED * BENCH_TRACK_INTVL,
+                        0.0, BENCH_TRACK_SPEED);
+    dequePositionTy track;
+    positionTy pos = RandomPos(ts0);
+    for (int i = 0; i < BENCH_TRACK_POS; i++) {
+        track.push_back(pos);
+        pos = pos.destPos(vec);
+        pos.ts() += BENCH_TRACK_INTVL;
+        pos.onGrnd = positionTy::GND_OFF;
+    }
+    return track;
+}
+
+// reads a complete file, empty if not readable
+std::string ReadFile (const std::string& path)
+{
+    std::ifstream f (path, std::ios::binary);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+// gives access to a channel's receive buffer,
+// so that we can process a fixture instead of network data
+// (LTChannel is a virtual base, so we need to tell it the channel again)
+template <class ChannelT, dataRefsLT CH>
+class BenchChannel : public ChannelT
+{
+public:
+    BenchChannel () : LTChannel(CH), ChannelT() {}
+    void SetNetData (const std::string& data)
+    {
+        if (data.size() + 1 > this->netDataSize) {
+            this->netDataSize = data.size() + 1;
+            this->netData = (char*)realloc(this->netData, this->netDataSize);
+        }
+        memcpy(this->netData, data.data(), data.size());
+        this->netData[data.size()] = 0;
+        this->netDataPos = data.size();
+    }
+};
+
+// removes all flight data (and with it all aircraft)
+void ClearFlightData ()
+{
+    {
+        std::lock_guard<std::mutex> lock (mapFdMutex);
+        mapFd.clear();
+    }
+    // drops the now stale keys of objects with new positions
+    // (outside the lock, AppendAllNewPos only tries to get it)
+    LTFlightData::AppendAllNewPos();
+}
+
+// key of the i-th synthetic aircraft
+std::string BenchKey (int i)
+{
+    char key[10];
+    snprintf(key, sizeof(key), "%06X", 0xB00000 + i);
+    return key;
+}
+
+// creates the synthetic flight data objects and hands over their tracks
+// (not yet appended, that's what AppendAllNewPos will do)
+void AddTracks (const std::vector<dequePositionTy>& vTracks)
+{
+    ClearFlightData();
+    std::lock_guard<std::mutex> lock (mapFdMutex);
+    for (int i = 0; i < (int)vTracks.size(); i++) {
+        LTFlightData& fd = mapFd[BenchKey(i)];
+        fd.SetKey(BenchKey(i));
+        for (positionTy pos: vTracks[size_t(i)]) {
+            LTFlightData::FDDynamicData dyn;
+            dyn.heading = pos.heading();
+            dyn.spd = BENCH_TRACK_SPEED * KT_per_M_per_S;
+            dyn.vsi = 0.0;
+            dyn.ts = pos.ts();
+            fd.AddDynData(dyn, 0, 0, &pos);
+        }
+    }
+}
+
+// number of positions appended to all flight data objects' posDeque
+size_t NumPosAppended ()
+{
+    std::lock_guard<std::mutex> lock (mapFdMutex);
+    size_t n = 0;
+    for (const mapLTFlightDataTy::value_type& p: mapFd)
+        n += p.second.GetPosDeque().size();
+    return n;
+}
+
+// appends all handed over positions, serving the terrain probes
+void AppendTracks ()
+{
+    // first call requests the probes, then the positions can be appended,
+    // with more tracks than fit into the terrain cache it takes several frames' budget
+    do {
+        LTFlightData::AppendAllNewPos();
+        TerrainProbeProcess();
+    } while (TerrainProbeNumPending() > 0);
+    LTFlightData::AppendAllNewPos();
+}
+
+//
+//MARK: Micro benchmarks
+//
+
+void BenchMicro ()
+{
+    // random positions and vectors
+    std::vector<positionTy> vPos1, vPos2;
+    std::vector<vectorTy> vVec;
+    std::uniform_real_distribution<double> dAngle (0.0, 360.0);
+    std::uniform_real_distribution<double> dDist  (0.0, 10000.0);
+    for (size_t i = 0; i < BENCH_MICRO_N; i++) {
+        vPos1.push_back(RandomPos(double(i)));
+        vPos2.push_back(RandomPos(double(i)));
+        vVec.emplace_back(dAngle(benchRnd), dDist(benchRnd));
+    }
+    
+    Bench("coord_distance", "call", [&]{
+        double d = 0.0;
+        for (size_t i = 0; i < BENCH_MICRO_N; i++)
+            d += CoordDistance(vPos1[i], vPos2[i]);
+        benchSink = benchSink + d;
+        return BENCH_MICRO_N;
+    });
+    
+    Bench("coord_angle", "call", [&]{
+        double d = 0.0;
+        for (size_t i = 0; i < BENCH_MICRO_N; i++)
+            d += CoordAngle(vPos1[i], vPos2[i]);
+        benchSink = benchSink + d;
+        return BENCH_MICRO_N;
+    });
+    
+    Bench("coord_plus_vector", "call", [&]{
+        double d = 0.0;
+        for (size_t i = 0; i < BENCH_MICRO_N; i++)
+            d += CoordPlusVector(vPos1[i], vVec[i]).lat();
+        benchSink = benchSink + d;
+        return BENCH_MICRO_N;
+    });
+    
+    std::vector<positionTy> vDst (BENCH_MICRO_N);
+    Bench("position_copy", "position", [&]{
+        for (size_t i = 0; i < BENCH_MICRO_N; i++)
+            vDst[i] = vPos1[i];
+        benchSink = benchSink + vDst[BENCH_MICRO_N/2].lat();
+        return BENCH_MICRO_N;
+    });
+    
+    const dequePositionTy track = RandomTrack(0.0);
+    Bench("position_deque_copy", "position", [&]{
+        dequePositionTy copy (track);
+        benchSink = benchSink + copy.back().lat();
+        return track.size();
+    });
+    
+    dequePositionTy trackFind (track);
+    std::vector<double> vTs;
+    std::uniform_real_distribution<double> dTs (-BENCH_TRACK_INTVL,
+                                                BENCH_TRACK_POS * BENCH_TRACK_INTVL);
+    for (size_t i = 0; i < BENCH_MICRO_N; i++)
+        vTs.push_back(dTs(benchRnd));
+    Bench("position_deque_find_adj_ts", "call", [&]{
+        positionTy *pBefore = nullptr, *pAfter = nullptr;
+        size_t n = 0;
+        for (double ts: vTs) {
+            positionDequeFindAdjacentTS(ts, trackFind, pBefore, pAfter);
+            n += (pBefore != nullptr) + (pAfter != nullptr);
+        }
+        benchSink = benchSink + double(n);
+        return BENCH_MICRO_N;
+    });
+}
+
+//
+//MARK: Macro benchmarks
+//
+
+// decoding the fixtures and feeding mapFd, per aircraft record
+template <class ChannelT, dataRefsLT CH>
+void BenchProcessFetched (const char* name, const std::string& path, size_t nAc)
+{
+    const std::string data = ReadFile(path);
+    if (data.empty() || !nAc) {
+        fprintf(stderr, "%s: Could not read fixture '%s'\n", name, path.c_str());
+        return;
+    }
+    BenchChannel<ChannelT, CH> chn;
+    chn.SetNetData(data);
+    Bench(name, "aircraft",
+          []{ ClearFlightData(); },
+          [&]{ chn.ProcessFetchedData(mapFd); return nAc; });
+    ClearFlightData();
+}
+
+// counts the records in the fixtures
+size_t CountRecords (const std::string& path, bool bOpenSky)
+{
+    const std::string data = ReadFile(path);
+    size_t n = 0;
+    if (bOpenSky) {
+        vecOpenSkyStateTy vStates;
+        OpenSkyDecoder dec (data.data(), data.size());
+        if (dec.DecodeStates(vStates))
+            n = vStates.size();
+    } else {
+        ADSBExDecoder dec (data.data(), data.size());
+        ADSBExAcTy ac;
+        if (dec.FindAcList())
+            while (dec.NextAc(ac))
+                n++;
+    }
+    return n;
+}
+
+void BenchMacro ()
+{
+    // *** channels processing fixtures ***
+    BenchProcessFetched<OpenSkyConnection, DR_CHANNEL_OPEN_SKY_ONLINE>(
+        "opensky_process_fetched", benchOpSkyFile, CountRecords(benchOpSkyFile, true));
+    BenchProcessFetched<ADSBExchangeConnection, DR_CHANNEL_ADSB_EXCHANGE_ONLINE>(
+        "adsbex_process_fetched", benchADSBExFile, CountRecords(benchADSBExFile, false));
+    
+    // *** synthetic tracks, starting a bit before current sim time ***
+    const double ts0 = dataRefs.GetSimTime() - 2 * BENCH_TRACK_INTVL;
+    std::vector<dequePositionTy> vTracks;
+    for (int i = 0; i < benchNumAc; i++)
+        vTracks.push_back(RandomTrack(ts0));
+    
+    // warm up the terrain cache, so that probes are served right away
+    for (const dequePositionTy& track: vTracks)
+        for (const positionTy& pos: track)
+            TerrainProbeSync(pos);
+    
+    // AppendNewPos: merging the handed over positions into posDeque
+    // (terrain altitudes come from the cache right away,
+    //  what didn't fit into the cache is not counted)
+    Bench("append_new_pos", "position",
+          [&]{ AddTracks(vTracks); },
+          [&]{ LTFlightData::AppendAllNewPos(); return NumPosAppended(); });
+    
+    // the appended flight data, as template for the following benchmarks
+    AddTracks(vTracks);
+    AppendTracks();
+    std::deque<LTFlightData> dequeFdTempl;
+    for (const mapLTFlightDataTy::value_type& p: mapFd)
+        dequeFdTempl.emplace_back(p.second);
+    std::deque<LTFlightData> dequeFd;
+    auto copyFd = [&]{
+        dequeFd.clear();
+        for (const LTFlightData& fd: dequeFdTempl)
+            dequeFd.emplace_back(fd);
+    };
+    
+    // DataCleansing: validation of all buffered positions
+    Bench("data_cleansing", "aircraft", copyFd, [&]{
+        for (LTFlightData& fd: dequeFd) {
+            bool bChanged = false;
+            fd.DataCleansing(bChanged);
+        }
+        return dequeFd.size();
+    });
+    
+    // CalcNextPos: a minute into the track, so there's something to remove
+    Bench("calc_next_pos", "aircraft", copyFd, [&]{
+        for (LTFlightData& fd: dequeFd)
+            fd.CalcNextPos(ts0 + 6 * BENCH_TRACK_INTVL + 1.0);
+        return dequeFd.size();
+    });
+    dequeFd.clear();
+    dequeFdTempl.clear();
+    
+    // *** full frame: create the aircraft, then calculate and draw ***
+    int nAc = 0;
+    const double simTime = dataRefs.GetSimTime();
+    for (mapLTFlightDataTy::value_type& p: mapFd)
+        if (p.second.CreateAircraft(simTime))
+            nAc++;
+    if (nAc != benchNumAc)
+        fprintf(stderr, "Created %d instead of %d aircraft\n", nAc, benchNumAc);
+    
+    LTAircraft::StartCalcWorkers();
+    Bench("calc_ppos_frame", "frame",
+          []{ XPStubRunFrame(1.0f/60.0f, false); },
+          []{
+              LTAircraft::UpdateAll();
+              XPStubDrawPlanes();
+              return 1;
+          });
+    LTAircraft::StopCalcWorkers();
+    
+    ClearFlightData();
+}
+
+//
+//MARK: Output
+//
+
+// JSON string, escaping what could show up in our names
+std::string JsonStr (const std::string& s)
+{
+    std::string ret ("\"");
+    for (char c: s) {
+        if (c == '"' || c == '\\') ret += '\\';
+        ret += c;
+    }
+    return ret + '"';
+}
+
+void WriteResults (FILE* f)
+{
+    char szDate[32] = "";
+    const time_t now = time(nullptr);
+    struct tm tm;
+    gmtime_s(&tm, &now);
+    strftime(szDate, sizeof(szDate), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    
+    fprintf(f, "{\n");
+    fprintf(f, "  \"version\": %s,\n", JsonStr(LT_VERSION_FULL).c_str());
+    fprintf(f, "  \"date\": %s,\n", JsonStr(szDate).c_str());
+    fprintf(f, "  \"config\": { \"min_time_s\": %.3f, \"num_ac\": %d },\n",
+            benchMinSec, benchNumAc);
+    fprintf(f, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < vBenchResults.size(); i++) {
+        const benchResultTy& r = vBenchResults[i];
+        fprintf(f, "    { \"name\": %s, \"unit\": %s, \"ops\": %.0f, \"total_s\": %.6f, \"ns_per_op\": %.3f }%s\n",
+                JsonStr(r.name).c_str(), JsonStr(r.unit).c_str(),
+                r.ops, r.sec, r.nsPerOp(),
+                i+1 < vBenchResults.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+//
+//MARK: main
+//
+
+int main (int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i+1 < argc)       benchMinSec = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i+1 < argc)  benchNumAc = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-a") && i+1 < argc)  benchADSBExFile = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i+1 < argc)  benchOpSkyFile = argv[++i];
+        else if (!strcmp(argv[i], "-f") && i+1 < argc)  benchResultFile = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [-t <min seconds per benchmark>] [-n <num aircraft>] "
+                            "[-a <AircraftList.json>] [-o <states.json>] [-f <result file>]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    // LiveTraffic's limits for the number of aircraft
+    // (headless we may go beyond the plugin's limit)
+    const int reqNumAc = benchNumAc;
+    benchNumAc = std::max(5, std::min(benchNumAc, MAX_NUM_AC_HEADLESS));
+    if (benchNumAc != reqNumAc)
+        fprintf(stderr, "Number of aircraft limited to %d..%d, running with %d\n",
+                5, MAX_NUM_AC_HEADLESS, benchNumAc);
+    
+    // play X-Plane: the current folder is LiveTraffic's folder
+    XPStubSetPluginPath("./64/lin.xpl");
+    XPStubSetCamera(BENCH_VIEW_LAT, BENCH_VIEW_LON, BENCH_TRACK_ALT);
+    char szName[256], szSig[256], szDesc[256];
+    if (!XPluginStart(szName, szSig, szDesc)) {
+        fprintf(stderr, "LiveTraffic failed to start\n");
+        return 1;
+    }
+    // no auto start of the regular aircraft display, no warnings about
+    // the fixtures' incomplete records, and our number of aircraft
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/auto_start"), 0);
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/log_level"), logERR);
+    dataRefs.SetMaxNumAcLimit(MAX_NUM_AC_HEADLESS);
+    dataRefs.SetSaveConfig(false);          // our settings are not the user's
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/max_num_ac"), benchNumAc);
+    XPStubRunFrame(1.0f/60.0f);
+    
+    BenchMicro();
+    BenchMacro();
+    
+    XPluginStop();
+    
+    // output the results
+    FILE* f = benchResultFile.empty() ? stdout : fopen(benchResultFile.c_str(), "w");
+    if (!f) {
+        fprintf(stderr, "Could not create '%s'\n", benchResultFile.c_str());
+        return 1;
+    }
+    WriteResults(f);
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
@@ -0,0 +1,226 @@
+//
+//  LTFeedServer.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Standalone stand-in for a local receiver's TCP feed: replays a recorded
+// feed to each client connecting on localhost, so that the stream channels
+// can be tested offline.
+//  SBS-1 BaseStation (like dump1090 on port 30003):
+//      the file's lines, <rate> lines per second,
+//      e.g. Data/SBS/sample.sbs (3 aircraft near EGLL, 5 minutes,
+//      in real time at -r 6.4)
+//  ADS-B Exchange stream (-j, like port 32001):
+//      the file's top-level JSON objects, <rate> objects per second,
+//      each sent in chunks of at most <chunk> bytes, so that the
+//      receiver has to put objects together across reads,
+//      e.g. "Data/ADSB/TCP Feed/adsbexchange32001 3x.json"
+//
+// Usage: LTFeedServer [-j] [-p <port>] [-r <rate per second>] [-c <chunk bytes>] [-l] <file>
+//        defaults: port 30003, 10 lines per second;
+//                  with -j port 32001, 0.1 objects per second, 64 kB chunks
+//        -l loops the file until the client disconnects
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <csignal>
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <thread>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+//
+//MARK: Settings
+//
+
+bool        srvJson     = false;        // ADS-B Exchange stream? (or SBS)
+int         srvPort     = 0;            // 0: default of the feed type
+double      srvRate     = 0.0;          // units sent per second, 0: default of the feed type
+size_t      srvChunk    = 65536;        // [bytes] max sent at once (JSON only)
+bool        srvLoop     = false;
+std::string srvFile;
+
+//
+//MARK: Feed
+//
+
+// splits JSON text into its top-level objects
+// (the same brace counting the stream channel does)
+void SplitJson (const std::string& s, std::vector<std::string>& vUnits)
+{
+    size_t objStart = 0;
+    int depth = 0;
+    bool bInStr = false, bEsc = false;
+    for (size_t i = 0; i < s.size(); i++) {
+        const char c = s[i];
+        if (bInStr) {
+            if (bEsc)               bEsc = false;
+            else if (c == '\\')     bEsc = true;
+            else if (c == '"')      bInStr = false;
+            continue;
+        }
+        if (c == '"')
+            bInStr = true;
+        else if (c == '{') {
+            if (depth++ == 0)
+                objStart = i;
+        }
+        else if (c == '}' && depth > 0 && --depth == 0)
+            vUnits.push_back(s.substr(objStart, i+1 - objStart));
+    }
+}
+
+// splits the file into the units to send: lines or JSON objects
+bool ReadFeed (const std::string& path, std::vector<std::string>& vUnits)
+{
+    std::ifstream in (path, std::ios_base::in | std::ios_base::binary);
+    if (!in)
+        return false;
+    if (srvJson) {
+        std::string s ((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        SplitJson(s, vUnits);
+        return true;
+    }
+    std::string ln;
+    while (std::getline(in, ln)) {
+        if (!ln.empty() && ln.back() == '\r')
+            ln.pop_back();
+        if (!ln.empty())
+            vUnits.push_back(ln + "\r\n");      // BaseStation lines end with CR LF
+    }
+    return true;
+}
+
+// sends everything (in chunks of srvChunk), false if the client has gone
+bool SendAll (int sock, const std::string& s)
+{
+    for (size_t pos = 0; pos < s.size(); ) {
+        const ssize_t n = send(sock, s.data() + pos, std::min(s.size() - pos, srvChunk), 0);
+        if (n <= 0)
+            return false;
+        pos += size_t(n);
+    }
+    return true;
+}
+
+// replays the feed to one client
+void ServeClient (int sock, const std::vector<std::string>& vUnits)
+{
+    using namespace std::chrono;
+    const duration<double> intvl (1.0 / srvRate);
+    steady_clock::time_point due = steady_clock::now();
+    size_t cnt = 0;
+    do {
+        for (const std::string& u: vUnits) {
+            std::this_thread::sleep_until(due);
+            if (!SendAll(sock, u)) {
+                printf("Client disconnected after %lu units\n", (unsigned long)cnt);
+                return;
+            }
+            cnt++;
+            due += duration_cast<steady_clock::duration>(intvl);
+        }
+    } while (srvLoop);
+    printf("Sent all %lu units\n", (unsigned long)cnt);
+}
+
+//
+//MARK: Main
+//
+
+int main (int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-j"))                     srvJson = true;
+        else if (!strcmp(argv[i], "-p") && i+1 < argc)  srvPort = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-r") && i+1 < argc)  srvRate = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-c") && i+1 < argc)  srvChunk = size_t(atol(argv[++i]));
+        else if (!strcmp(argv[i], "-l"))                srvLoop = true;
+        else if (argv[i][0] != '-' && srvFile.empty())  srvFile = argv[i];
+        else {
+            srvFile.clear();
+            break;
+        }
+    }
+    if (srvPort == 0)       srvPort = srvJson ? 32001 : 30003;
+    if (srvRate <= 0.0)     srvRate = srvJson ? 0.1 : 10.0;
+    if (!srvJson)           srvChunk = SIZE_MAX;
+    if (srvFile.empty() || srvPort < 0 || srvPort > 65535 || srvChunk == 0) {
+        fprintf(stderr, "Usage: %s [-j] [-p <port>] [-r <rate per second>] [-c <chunk bytes>] [-l] <file>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> vUnits;
+    if (!ReadFeed(srvFile, vUnits) || vUnits.empty()) {
+        fprintf(stderr, "Could not read anything from '%s'\n", srvFile.c_str());
+        return 1;
+    }
+
+    // a client going away must not kill us
+    signal(SIGPIPE, SIG_IGN);
+
+    // listen on localhost only
+    const int srv = socket(AF_INET, SOCK_STREAM, 0);
+    if (srv < 0) { perror("socket"); return 1; }
+    const int on = 1;
+    setsockopt(srv, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(uint16_t(srvPort));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(srv, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(srv, 1) < 0)
+    {
+        perror("bind/listen");
+        close(srv);
+        return 1;
+    }
+    printf("Serving %lu units of '%s' on localhost:%d, %.1f per second\n",
+           (unsigned long)vUnits.size(), srvFile.c_str(), srvPort, srvRate);
+    fflush(stdout);
+
+    // one client after the other
+    for (;;) {
+        const int sock = accept(srv, nullptr, nullptr);
+        if (sock < 0) { perror("accept"); break; }
+        printf("Client connected\n");
+        fflush(stdout);
+        ServeClient(sock, vUnits);
+        close(sock);
+        fflush(stdout);
+    }
+
+    close(srv);
+    return 0;
+}
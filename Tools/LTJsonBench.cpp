@@ -0,0 +1,346 @@
+//
+//  LTJsonBench.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Benchmark of decoding the channels' JSON responses: parson DOM with
+// per-field lookups (as the channels did before) vs. the single-pass
+// decoders of LTJsonScan. Also verifies both yield the same values.
+//
+// Usage: LTJsonBench [-n <iterations>] [-a <AircraftList.json>] [-o <states.json>]
+//        defaults: 2000 iterations,
+//                  Data/ADSB/REST/ADSBExchange_20180402_1955_UTC.json,
+//                  Data/OpenSky/OpenSky_20180420_1955_UTC.json
+
+#include "LTJsonScan.h"
+#include "parson.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+const char* BENCH_DEFAULT_ADSBEX  = "Data/ADSB/REST/ADSBExchange_20180402_1955_UTC.json";
+const char* BENCH_DEFAULT_OPENSKY = "Data/OpenSky/OpenSky_20180420_1955_UTC.json";
+constexpr int BENCH_DEFAULT_ITER = 2000;
+
+// same semantics as the jog_* helpers in LTChannel.cpp
+const char* bench_s (const JSON_Object* o, const char* n)
+{ const char* s = json_object_get_string(o, n); return s ? s : ""; }
+double bench_sn (const JSON_Object* o, const char* n)
+{ const char* s = json_object_get_string(o, n); return s ? strtod(s, NULL) : 0.0; }
+double bench_n (const JSON_Object* o, const char* n)
+{ return json_object_get_number(o, n); }
+double bench_n_nan (const JSON_Object* o, const char* n)
+{
+    JSON_Value* v = json_object_get_value(o, n);
+    return (!v || json_type(v) == JSONNull) ? NAN : json_value_get_number(v);
+}
+bool bench_b (const JSON_Object* o, const char* n)
+{ return json_object_get_boolean(o, n) > 0; }
+
+// same semantics as the jag_* helpers in LTChannel.cpp
+const char* bench_s (const JSON_Array* a, size_t i)
+{ const char* s = json_array_get_string(a, i); return s ? s : ""; }
+double bench_sn (const JSON_Array* a, size_t i)
+{ const char* s = json_array_get_string(a, i); return s ? strtod(s, NULL) : 0.0; }
+double bench_n (const JSON_Array* a, size_t i)
+{ return json_array_get_number(a, i); }
+double bench_n_nan (const JSON_Array* a, size_t i)
+{
+    JSON_Value* v = json_array_get_value(a, i);
+    return (!v || json_type(v) == JSONNull) ? NAN : json_value_get_number(v);
+}
+bool bench_b (const JSON_Array* a, size_t i)
+{ return json_array_get_boolean(a, i) > 0; }
+
+// copies into a fixed buffer like OpenSkyDecoder does
+template <size_t N>
+void bench_cpy (char (&buf)[N], const char* s)
+{
+    strncpy(buf, s, N-1);
+    buf[N-1] = 0;
+}
+
+// the DOM way: parse everything, then look up each field by name
+bool DecodeADSBExParson (const std::string& json, std::vector<ADSBExAcTy>& vAc)
+{
+    JSON_Value* pRoot = json_parse_string(json.c_str());
+    if (!pRoot) return false;
+    JSON_Array* pJAcList = json_object_get_array(json_object(pRoot), ADSBEX_AIRCRAFT_ARR);
+    if (!pJAcList) { json_value_free(pRoot); return false; }
+    
+    vAc.resize(json_array_get_count(pJAcList));
+    for (size_t i = 0; i < vAc.size(); i++) {
+        const JSON_Object* pJAc = json_array_get_object(pJAcList, i);
+        ADSBExAcTy& ac = vAc[i];
+        ac.transpIcao = bench_s(pJAc, ADSBEX_TRANSP_ICAO);
+        ac.posStale   = bench_b(pJAc, ADSBEX_POS_STALE);
+        ac.reg        = bench_s(pJAc, ADSBEX_REG);
+        ac.country    = bench_s(pJAc, ADSBEX_COUNTRY);
+        ac.acTypeIcao = bench_s(pJAc, ADSBEX_AC_TYPE_ICAO);
+        ac.man        = bench_s(pJAc, ADSBEX_MAN);
+        ac.mdl        = bench_s(pJAc, ADSBEX_MDL);
+        ac.year       = bench_sn(pJAc, ADSBEX_YEAR);
+        ac.mil        = bench_b(pJAc, ADSBEX_MIL);
+        ac.trt        = bench_n(pJAc, ADSBEX_TRT);
+        ac.op         = bench_s(pJAc, ADSBEX_OP);
+        ac.opIcao     = bench_s(pJAc, ADSBEX_OP_ICAO);
+        ac.call       = bench_s(pJAc, ADSBEX_CALL);
+        ac.origin     = bench_s(pJAc, ADSBEX_ORIGIN);
+        ac.dest       = bench_s(pJAc, ADSBEX_DESTINATION);
+        ac.gnd        = bench_b(pJAc, ADSBEX_GND);
+        ac.engType    = bench_n(pJAc, ADSBEX_ENG_TYPE);
+        ac.engMount   = bench_n(pJAc, ADSBEX_ENG_MOUNT);
+        ac.posTime    = bench_n(pJAc, ADSBEX_POS_TIME);
+        ac.radarCode  = bench_sn(pJAc, ADSBEX_RADAR_CODE);
+        ac.heading    = bench_n_nan(pJAc, ADSBEX_HEADING);
+        ac.inHg       = bench_n(pJAc, ADSBEX_IN_HG);
+        ac.brng       = bench_n(pJAc, ADSBEX_BRNG);
+        ac.dst        = bench_n(pJAc, ADSBEX_DST);
+        ac.spd        = bench_n(pJAc, ADSBEX_SPD);
+        ac.vsi        = bench_n(pJAc, ADSBEX_VSI);
+        ac.lat        = bench_n_nan(pJAc, ADSBEX_LAT);
+        ac.lon        = bench_n_nan(pJAc, ADSBEX_LON);
+        ac.alt        = bench_n_nan(pJAc, ADSBEX_ELEVATION);
+        ac.rcvr       = bench_n(pJAc, ADSBEX_RCVR);
+        ac.sig        = bench_n(pJAc, ADSBEX_SIG);
+    }
+    json_value_free(pRoot);
+    return true;
+}
+
+// the single-pass way
+bool DecodeADSBExScan (const std::string& json, std::vector<ADSBExAcTy>& vAc)
+{
+    ADSBExDecoder dec (json.c_str(), json.length());
+    if (!dec.FindAcList()) return false;
+    size_t n = 0;
+    for (;; n++) {
+        if (n >= vAc.size()) vAc.resize(n+1);
+        if (!dec.NextAc(vAc[n])) break;
+    }
+    vAc.resize(n);
+    return !dec.IsError();
+}
+
+// equal, NAN counting as equal to NAN (without '==', which -Wfloat-equal flags)
+bool NumEq (double a, double b)
+{ return (std::isnan(a) && std::isnan(b)) || (!(a < b) && !(a > b)); }
+
+// compares both results, prints differences, returns number of differing aircraft
+int CompareADSBEx (const std::vector<ADSBExAcTy>& vA, const std::vector<ADSBExAcTy>& vB)
+{
+    if (vA.size() != vB.size()) {
+        printf("Aircraft count differs: %lu vs %lu\n",
+               (unsigned long)vA.size(), (unsigned long)vB.size());
+        return 1;
+    }
+    int nDiff = 0;
+    for (size_t i = 0; i < vA.size(); i++) {
+        const ADSBExAcTy& a = vA[i];
+        const ADSBExAcTy& b = vB[i];
+        const bool bEq =
+        a.transpIcao == b.transpIcao && a.reg == b.reg && a.country == b.country &&
+        a.acTypeIcao == b.acTypeIcao && a.man == b.man && a.mdl == b.mdl &&
+        a.op == b.op && a.opIcao == b.opIcao && a.call == b.call &&
+        a.origin == b.origin && a.dest == b.dest &&
+        NumEq(a.year, b.year) && NumEq(a.trt, b.trt) && NumEq(a.posTime, b.posTime) &&
+        NumEq(a.radarCode, b.radarCode) && NumEq(a.heading, b.heading) &&
+        NumEq(a.inHg, b.inHg) && NumEq(a.brng, b.brng) && NumEq(a.dst, b.dst) &&
+        NumEq(a.spd, b.spd) && NumEq(a.vsi, b.vsi) && NumEq(a.lat, b.lat) &&
+        NumEq(a.lon, b.lon) && NumEq(a.alt, b.alt) &&
+        NumEq(a.engType, b.engType) && NumEq(a.engMount, b.engMount) &&
+        NumEq(a.rcvr, b.rcvr) && NumEq(a.sig, b.sig) &&
+        a.posStale == b.posStale && a.gnd == b.gnd && a.mil == b.mil;
+        if (!bEq) {
+            printf("Aircraft #%lu (%s) differs\n", (unsigned long)i, a.transpIcao.c_str());
+            nDiff++;
+        }
+    }
+    return nDiff;
+}
+
+// OpenSky the DOM way: parse everything, then access values by index
+bool DecodeOpenSkyParson (const std::string& json, vecOpenSkyStateTy& vStates)
+{
+    vStates.clear();
+    JSON_Value* pRoot = json_parse_string(json.c_str());
+    if (!pRoot) return false;
+    JSON_Array* pJAcList = json_object_get_array(json_object(pRoot), OPSKY_AIRCRAFT_ARR);
+    if (!pJAcList) { json_value_free(pRoot); return false; }
+    
+    vStates.resize(json_array_get_count(pJAcList));
+    for (size_t i = 0; i < vStates.size(); i++) {
+        const JSON_Array* pJAc = json_array_get_array(pJAcList, i);
+        OpenSkyStateTy& st = vStates[i];
+        bench_cpy(st.transpIcao, bench_s(pJAc, OPSKY_TRANSP_ICAO));
+        bench_cpy(st.call,       bench_s(pJAc, OPSKY_CALL));
+        for (size_t len = strlen(st.call); len > 0 && st.call[len-1] == ' '; len--)
+            st.call[len-1] = 0;
+        bench_cpy(st.country,    bench_s(pJAc, OPSKY_COUNTRY));
+        st.posTime   = bench_n(pJAc, OPSKY_POS_TIME);
+        st.radarCode = bench_sn(pJAc, OPSKY_RADAR_CODE);
+        st.gnd       = bench_b(pJAc, OPSKY_GND);
+        st.heading   = bench_n_nan(pJAc, OPSKY_HEADING);
+        st.spd       = bench_n(pJAc, OPSKY_SPD);
+        st.vsi       = bench_n(pJAc, OPSKY_VSI);
+        st.lat       = bench_n_nan(pJAc, OPSKY_LAT);
+        st.lon       = bench_n_nan(pJAc, OPSKY_LON);
+        st.alt       = bench_n_nan(pJAc, OPSKY_ELEVATION);
+    }
+    json_value_free(pRoot);
+    return true;
+}
+
+// OpenSky the single-pass way
+bool DecodeOpenSkyScan (const std::string& json, vecOpenSkyStateTy& vStates)
+{
+    OpenSkyDecoder dec (json.c_str(), json.length());
+    return dec.DecodeStates(vStates);
+}
+
+int CompareOpenSky (const vecOpenSkyStateTy& vA, const vecOpenSkyStateTy& vB)
+{
+    if (vA.size() != vB.size()) {
+        printf("State count differs: %lu vs %lu\n",
+               (unsigned long)vA.size(), (unsigned long)vB.size());
+        return 1;
+    }
+    int nDiff = 0;
+    for (size_t i = 0; i < vA.size(); i++) {
+        const OpenSkyStateTy& a = vA[i];
+        const OpenSkyStateTy& b = vB[i];
+        const bool bEq =
+        !strcmp(a.transpIcao, b.transpIcao) && !strcmp(a.call, b.call) &&
+        !strcmp(a.country, b.country) &&
+        NumEq(a.posTime, b.posTime) && NumEq(a.radarCode, b.radarCode) &&
+        NumEq(a.heading, b.heading) && NumEq(a.spd, b.spd) && NumEq(a.vsi, b.vsi) &&
+        NumEq(a.lat, b.lat) && NumEq(a.lon, b.lon) && NumEq(a.alt, b.alt) &&
+        a.gnd == b.gnd;
+        if (!bEq) {
+            printf("State #%lu (%s) differs\n", (unsigned long)i, a.transpIcao);
+            nDiff++;
+        }
+    }
+    return nDiff;
+}
+
+// runs 'f' 'nIter' times, returns microseconds per aircraft record
+template <class F, class RecT>
+double Measure (F f, const std::string& json, int nIter, std::vector<RecT>& vAc)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nIter; i++)
+        f(json, vAc);
+    const std::chrono::duration<double, std::micro> dur =
+        std::chrono::steady_clock::now() - start;
+    return vAc.empty() ? 0.0 : dur.count() / nIter / double(vAc.size());
+}
+
+// reads a whole file, false if it can't be opened
+bool ReadFile (const char* fileName, std::string& json)
+{
+    std::ifstream in (fileName, std::ios_base::in | std::ios_base::binary);
+    if (!in) {
+        fprintf(stderr, "Could not open %s\n", fileName);
+        return false;
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    json = ss.str();
+    return true;
+}
+
+// decodes 'fileName' both ways, compares, and measures,
+// returns number of differences or -1 on failure
+template <class RecT, class FParson, class FScan, class FCompare>
+int Bench (const char* fileName, const char* arrName, int nIter,
+           FParson fParson, FScan fScan, FCompare fCompare)
+{
+    std::string json;
+    if (!ReadFile(fileName, json))
+        return -1;
+    
+    // correctness first: both ways must agree
+    std::vector<RecT> vParson, vScan;
+    if (!fParson(json, vParson)) {
+        fprintf(stderr, "%s: parson could not decode %s\n", fileName, arrName);
+        return -1;
+    }
+    if (!fScan(json, vScan)) {
+        fprintf(stderr, "%s: single-pass decoder could not decode %s\n", fileName, arrName);
+        return -1;
+    }
+    const int nDiff = fCompare(vParson, vScan);
+    printf("%s: %lu bytes, %lu aircraft, %d differences\n",
+           fileName, (unsigned long)json.length(),
+           (unsigned long)vScan.size(), nDiff);
+    
+    // then speed
+    const double usParson = Measure(fParson, json, nIter, vParson);
+    const double usScan   = Measure(fScan,   json, nIter, vScan);
+    printf("%d iterations, time per aircraft record:\n", nIter);
+    printf("  parson DOM + field lookups: %8.3f us\n", usParson);
+    printf("  single-pass decoder:        %8.3f us\n", usScan);
+    if (usScan > 0.0)
+        printf("  speedup:                    %8.2fx\n", usParson / usScan);
+    printf("\n");
+    return nDiff;
+}
+
+int main (int argc, const char* argv[])
+{
+    int nIter = BENCH_DEFAULT_ITER;
+    const char* fileADSBEx  = BENCH_DEFAULT_ADSBEX;
+    const char* fileOpenSky = BENCH_DEFAULT_OPENSKY;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i+1 < argc)
+            nIter = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-a") && i+1 < argc)
+            fileADSBEx = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i+1 < argc)
+            fileOpenSky = argv[++i];
+        else
+            nIter = 0;
+    }
+    if (nIter <= 0) {
+        fprintf(stderr, "Usage: %s [-n <iterations>] [-a <AircraftList.json>] [-o <states.json>]\n", argv[0]);
+        return 1;
+    }
+    
+    const int nDiffADSBEx =
+    Bench<ADSBExAcTy>(fileADSBEx, ADSBEX_AIRCRAFT_ARR, nIter,
+                      DecodeADSBExParson, DecodeADSBExScan, CompareADSBEx);
+    const int nDiffOpenSky =
+    Bench<OpenSkyStateTy>(fileOpenSky, OPSKY_AIRCRAFT_ARR, nIter,
+                          DecodeOpenSkyParson, DecodeOpenSkyScan, CompareOpenSky);
+    
+    if (nDiffADSBEx < 0 || nDiffOpenSky < 0)
+        return 1;
+    return (nDiffADSBEx || nDiffOpenSky) ? 2 : 0;
+}
@@ -0,0 +1,393 @@
+//
+//  LTSession.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Deterministic session replayer, run headless
+// (livetraffic_core with the X-Plane stubs, see Headless/XPStub.h).
+//
+// Steps a virtual sim clock at a fixed frame rate and drives LiveTraffic
+// synchronously (bFDSynchronous): every fdRefreshIntvl of sim time one
+// LTFlightDataSelectAcCycle, every frame LTFlightData::CalcNextPosPending
+// and one X-Plane frame, i.e. the flight loop callbacks
+// (LoopCBAircraftMaintenance, LoopCBAircraftUpdate) and GetPlanePosition
+// of all planes. The traffic is either synthetic (SyntheticChannel) or a
+// raw data capture (ReplayChannel).
+//
+// Reported as JSON: LiveTraffic's cost per frame as percentiles and
+// histogram, the same for the work the threads would do in the background,
+// and aircraft which had no position or were frozen (moving, but drawn
+// at the very same place as in the previous frame). Frames during the
+// warm-up period are not counted.
+//
+// Same options, same track_hash: all positions drawn were the same.
+// That holds with the frame-time governor off (default) only, as it
+// decides based on measured time.
+//
+// Usage: livetraffic_session [-r <capture.ltc.gz>] [-n <num synthetic flights>] [-s <seed>]
+//                            [-c <lat>,<lon>] [-a <max num aircraft>]
+//                            [-d <duration s>] [-w <warm-up s>] [-p <frames per second>]
+//                            [-g <governor target fps>] [-b <start epoch s>]
+//                            [-f <result file>]
+//        defaults: synthetic traffic, 1000 flights, seed 1, around EGLL,
+//                  100 aircraft, 600s after 60s warm-up at 30 fps,
+//                  governor off, starting 2023-11-14 22:13:20Z,
+//                  results to stdout
+//        Run from LiveTraffic's root folder, which also serves as
+//        plugin folder (Resources/...).
+
+#include "LiveTraffic.h"
+#include "XPStub.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <set>
+
+PLUGIN_API int  XPluginStart (char* outName, char* outSig, char* outDesc);
+PLUGIN_API int  XPluginEnable (void);
+PLUGIN_API void XPluginDisable (void);
+PLUGIN_API void XPluginStop (void);
+
+extern listPtrLTChannelTy listFDC;
+
+//
+//MARK: Settings
+//
+
+std::string sesCapture;                     // empty: synthetic traffic
+int         sesNumFlights   = 1000;
+int         sesSeed         = 1;
+double      sesLat          = 51.4700;      // EGLL
+double      sesLon          = -0.4543;
+int         sesMaxNumAc     = 100;
+double      sesDuration     = 600.0;        // [s] sim time counted
+double      sesWarmUp       = 60.0;         // [s] sim time not counted
+int         sesFps          = 30;
+int         sesGovFps       = 0;            // 0: governor off
+double      sesStartTs      = 1700000000.0;
+std::string sesResultFile;                  // empty: stdout
+
+const double SES_CAM_ALT        = 1000.0;   // [m] camera altitude
+const double SES_FROZEN_SPEED   = 1.0;      // [kt] moving faster than this, but not moved: frozen
+// upper bounds of the frame cost histogram's buckets
+const double SES_HIST_US[] = { 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000 };
+
+//
+//MARK: Statistics
+//
+
+// a series of durations
+struct sesSeriesTy {
+    std::vector<double> v;              // [µs]
+    
+    void Add (double us) { v.push_back(us); }
+    // the q-quantile, sorts v
+    double Pct (double q)
+    {
+        if (v.empty()) return NAN;
+        std::sort(v.begin(), v.end());
+        return v[std::min(v.size() - 1, size_t(q * double(v.size())))];
+    }
+    double Mean () const
+    {
+        if (v.empty()) return NAN;
+        double sum = 0.0;
+        for (double d: v) sum += d;
+        return sum / double(v.size());
+    }
+};
+
+sesSeriesTy sesFrame;                   // one X-Plane frame
+sesSeriesTy sesFetch;                   // one LTFlightDataSelectAcCycle
+sesSeriesTy sesCalcPos;                 // CalcNextPosPending per frame
+
+// aircraft
+long        sesAcFrames     = 0;        // sum of aircraft over all frames
+size_t      sesAcMax        = 0;        // max aircraft in a frame
+long        sesNoPosFrames  = 0;        // aircraft frames without position
+long        sesFrozenFrames = 0;        // aircraft frames frozen
+std::set<std::string> sesNoPosAc;       // aircraft ever without position
+std::set<std::string> sesFrozenAc;      // aircraft ever frozen
+uint64_t    sesTrackHash    = 0;        // of all positions drawn
+
+// position of an aircraft in the previous frame
+struct sesLastPosTy {
+    double lat = NAN, lon = NAN, alt = NAN;
+    
+    // bit for bit the same position?
+    bool identical (const sesLastPosTy& o) const
+    { return !memcmp(&lat, &o.lat, sizeof(lat)) &&
+             !memcmp(&lon, &o.lon, sizeof(lon)) &&
+             !memcmp(&alt, &o.alt, sizeof(alt)); }
+};
+std::map<std::string, sesLastPosTy> mapSesLastPos;
+
+// FNV-1a
+uint64_t SesHash (uint64_t h, const void* p, size_t len)
+{
+    const unsigned char* c = static_cast<const unsigned char*>(p);
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ c[i]) * 0x100000001b3ULL;
+    return h;
+}
+
+// looks at the results of the frame, which the
+// GetPlanePosition calls during drawing returned
+void SesCheckFrame (long frame, bool bCount)
+{
+    std::map<std::string, sesLastPosTy> mapPos;
+    for (size_t i = 0; i < acFrameData.size(); i++) {
+        const LTAircraft& ac = *acFrameData.vAc[i];
+        const std::string& key = ac.key();
+        if (acFrameData.vPosRes[i] == xpmpData_Unavailable) {
+            if (bCount) {
+                sesNoPosFrames++;
+                sesNoPosAc.insert(key);
+            }
+            continue;
+        }
+        sesLastPosTy& pos = mapPos[key];
+        pos.lat = acFrameData.vLat[i];
+        pos.lon = acFrameData.vLon[i];
+        pos.alt = acFrameData.vAlt_ft[i];
+        
+        // moving, but same position as last frame?
+        auto iter = mapSesLastPos.find(key);
+        if (bCount && iter != mapSesLastPos.end() &&
+            ac.GetSpeed_kt() > SES_FROZEN_SPEED &&
+            iter->second.identical(pos))
+        {
+            sesFrozenFrames++;
+            sesFrozenAc.insert(key);
+        }
+        
+        // order of aircraft doesn't matter, their positions do
+        // (rounded to ~1cm, the last bits would reflect the compiler)
+        const long long rnd[3] = {
+            llround(pos.lat * 1e7), llround(pos.lon * 1e7), llround(pos.alt * 30.0) };
+        uint64_t h = SesHash(0xcbf29ce484222325ULL, key.data(), key.size());
+        h = SesHash(h, &frame, sizeof(frame));
+        sesTrackHash += SesHash(h, rnd, sizeof(rnd));
+    }
+    if (bCount) {
+        sesAcFrames += (long)acFrameData.size();
+        sesAcMax = std::max(sesAcMax, acFrameData.size());
+    }
+    mapSesLastPos.swap(mapPos);
+}
+
+//
+//MARK: Output
+//
+
+void WritePct (FILE* f, const char* name, sesSeriesTy& s, const char* term)
+{
+    fprintf(f, "  \"%s\": { \"n\": %zu, \"mean\": %.1f, \"p50\": %.1f, \"p90\": %.1f, "
+               "\"p99\": %.1f, \"p99_9\": %.1f, \"max\": %.1f }%s\n",
+            name, s.v.size(), s.Mean(), s.Pct(0.5), s.Pct(0.9),
+            s.Pct(0.99), s.Pct(0.999), s.Pct(1.0), term);
+}
+
+void WriteResults (FILE* f)
+{
+    char szDate[32] = "";
+    const time_t now = time(nullptr);
+    struct tm tm;
+    gmtime_s(&tm, &now);
+    strftime(szDate, sizeof(szDate), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    
+    fprintf(f, "{\n");
+    fprintf(f, "  \"version\": \"%s\",\n", LT_VERSION_FULL);
+    fprintf(f, "  \"date\": \"%s\",\n", szDate);
+    fprintf(f, "  \"config\": { \"source\": \"%s\", \"num_flights\": %d, \"seed\": %d, "
+               "\"max_num_ac\": %d, \"duration_s\": %.0f, \"warm_up_s\": %.0f, \"fps\": %d, "
+               "\"gov_target_fps\": %d, \"start\": %.0f },\n",
+            sesCapture.empty() ? "synthetic" : sesCapture.c_str(),
+            sesNumFlights, sesSeed, sesMaxNumAc, sesDuration, sesWarmUp, sesFps,
+            sesGovFps, sesStartTs);
+    // cost per frame [µs], with histogram
+    WritePct(f, "frame_us", sesFrame, ",");
+    fprintf(f, "  \"frame_histogram_us\": [");
+    size_t from = 0;
+    std::sort(sesFrame.v.begin(), sesFrame.v.end());
+    for (double le: SES_HIST_US) {
+        const size_t to = size_t(std::upper_bound(sesFrame.v.begin(), sesFrame.v.end(), le) - sesFrame.v.begin());
+        fprintf(f, " { \"le\": %.0f, \"n\": %zu },", le, to - from);
+        from = to;
+    }
+    fprintf(f, " { \"le\": null, \"n\": %zu } ],\n", sesFrame.v.size() - from);
+    // background work
+    WritePct(f, "fetch_cycle_us", sesFetch, ",");
+    WritePct(f, "calc_next_pos_us", sesCalcPos, ",");
+    // aircraft
+    fprintf(f, "  \"aircraft\": { \"mean\": %.1f, \"max\": %zu, "
+               "\"no_pos_frames\": %ld, \"no_pos_ac\": %zu, "
+               "\"frozen_frames\": %ld, \"frozen_ac\": %zu },\n",
+            sesFrame.v.empty() ? 0.0 : double(sesAcFrames) / double(sesFrame.v.size()),
+            sesAcMax, sesNoPosFrames, sesNoPosAc.size(),
+            sesFrozenFrames, sesFrozenAc.size());
+    fprintf(f, "  \"track_hash\": \"%016llx\"\n", (unsigned long long)sesTrackHash);
+    fprintf(f, "}\n");
+}
+
+//
+//MARK: main
+//
+
+int main (int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i+1 < argc)       sesCapture = argv[++i];
+        else if (!strcmp(argv[i], "-n") && i+1 < argc)  sesNumFlights = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i+1 < argc)  sesSeed = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-c") && i+1 < argc &&
+                 sscanf(argv[++i], "%lf,%lf", &sesLat, &sesLon) == 2) {}
+        else if (!strcmp(argv[i], "-a") && i+1 < argc)  sesMaxNumAc = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-d") && i+1 < argc)  sesDuration = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-w") && i+1 < argc)  sesWarmUp = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-p") && i+1 < argc)  sesFps = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-g") && i+1 < argc)  sesGovFps = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-b") && i+1 < argc)  sesStartTs = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-f") && i+1 < argc)  sesResultFile = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [-r <capture.ltc.gz>] [-n <num synthetic flights>] [-s <seed>] "
+                            "[-c <lat>,<lon>] [-a <max num aircraft>] "
+                            "[-d <duration s>] [-w <warm-up s>] [-p <frames per second>] "
+                            "[-g <governor target fps>] [-b <start epoch s>] [-f <result file>]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (sesFps < 1 || sesDuration <= 0.0 || sesWarmUp < 0.0) {
+        fprintf(stderr, "Need at least 1 fps and a positive duration\n");
+        return 1;
+    }
+    // LiveTraffic's limits for the number of aircraft
+    // (headless we may go beyond the plugin's limit)
+    const int reqMaxNumAc = sesMaxNumAc;
+    sesMaxNumAc = std::max(5, std::min(sesMaxNumAc, MAX_NUM_AC_HEADLESS));
+    if (sesMaxNumAc != reqMaxNumAc)
+        fprintf(stderr, "Max number of aircraft limited to %d..%d, running with %d\n",
+                5, MAX_NUM_AC_HEADLESS, sesMaxNumAc);
+    
+    // play X-Plane: the current folder is LiveTraffic's folder
+    XPStubSetPluginPath("./64/lin.xpl");
+    XPStubSetCamera(sesLat, sesLon, SES_CAM_ALT);
+    char szName[256], szSig[256], szDesc[256];
+    if (!XPluginStart(szName, szSig, szDesc)) {
+        fprintf(stderr, "LiveTraffic failed to start\n");
+        return 1;
+    }
+    // we show aircraft ourselves, driving LiveTraffic synchronously
+    // by our own clock
+    double simTime = sesStartTs;
+    dataRefs.SetSimTimeStepped(simTime);
+    bFDSynchronous = true;
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/auto_start"), 0);
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/log_level"), logERR);
+    dataRefs.SetMaxNumAcLimit(MAX_NUM_AC_HEADLESS);
+    dataRefs.SetSaveConfig(false);          // our settings are not the user's
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/max_num_ac"), sesMaxNumAc);
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/gov_target_fps"), sesGovFps);
+    if (sesCapture.empty()) {
+        XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/synth_num_ac"), sesNumFlights);
+        XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/synth_seed"), sesSeed);
+        XPLMSetDatai(XPLMFindDataRef("livetraffic/channel/synthetic"), 1);
+    } else {
+        XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/replay_speed"), 1);
+    }
+    if (!XPluginEnable()) {
+        fprintf(stderr, "LiveTraffic failed to enable\n");
+        XPluginStop();
+        return 1;
+    }
+    // replay the given capture instead of whatever the channels are
+    if (!sesCapture.empty()) {
+        listFDC.clear();
+        XPLMSetDatai(XPLMFindDataRef("livetraffic/channel/replay"), 1);
+        listFDC.emplace_back(new ReplayChannel(sesCapture, ""));
+        // (an invalid channel disables itself)
+        if (!listFDC.front()->IsEnabled()) {
+            fprintf(stderr, "Could not open capture '%s'\n", sesCapture.c_str());
+            XPluginDisable();
+            XPluginStop();
+            return 1;
+        }
+    }
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/aircrafts_displayed"), 1);
+    
+    // run the session
+    using clk = std::chrono::steady_clock;
+    const double dt = 1.0 / sesFps;
+    const long nFrames = lround((sesWarmUp + sesDuration) * sesFps);
+    const long nWarmUp = lround(sesWarmUp * sesFps);
+    double nextFetch = simTime;
+    for (long frame = 0; frame < nFrames; frame++) {
+        const bool bCount = frame >= nWarmUp;
+        simTime = sesStartTs + double(frame) * dt;
+        dataRefs.SetSimTimeStepped(simTime);
+        
+        // what the flight data thread does every fdRefreshIntvl
+        if (simTime >= nextFetch) {
+            const clk::time_point t0 = clk::now();
+            LTFlightDataSelectAcCycle();
+            if (bCount)
+                sesFetch.Add(std::chrono::duration<double,std::micro>(clk::now() - t0).count());
+            nextFetch += dataRefs.GetFdRefreshIntvl();
+        }
+        
+        // what the position calculation thread does when woken up
+        {
+            const clk::time_point t0 = clk::now();
+            LTFlightData::CalcNextPosPending();
+            if (bCount)
+                sesCalcPos.Add(std::chrono::duration<double,std::micro>(clk::now() - t0).count());
+        }
+        
+        // X-Plane's frame: flight loop callbacks and drawing
+        const clk::time_point t0 = clk::now();
+        XPStubRunFrame(float(dt));
+        if (bCount)
+            sesFrame.Add(std::chrono::duration<double,std::micro>(clk::now() - t0).count());
+        
+        SesCheckFrame(frame, bCount);
+    }
+    
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/aircrafts_displayed"), 0);
+    XPluginDisable();
+    XPluginStop();
+    
+    // output the results
+    FILE* f = sesResultFile.empty() ? stdout : fopen(sesResultFile.c_str(), "w");
+    if (!f) {
+        fprintf(stderr, "Could not create '%s'\n", sesResultFile.c_str());
+        return 1;
+    }
+    WriteResults(f);
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
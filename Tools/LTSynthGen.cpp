@@ -0,0 +1,227 @@
+//
+//  LTSynthGen.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Fixture writer for synthetic traffic (see LTSynthetic.h), run headless
+// (livetraffic_core with the X-Plane stubs, see Headless/XPStub.h).
+//
+// Writes what a receiver network would have sent every <interval> seconds
+// over <duration> seconds:
+//  -f  the last response as ADS-B Exchange AircraftList.json,
+//      e.g. as fixture for livetraffic_bench -a
+//  -o  all responses as raw data capture (like LTRawCapture.ltc.gz),
+//      to be replayed by the replay channel
+//
+// Usage: livetraffic_synth [-n <num flights>] [-s <seed>]
+//                          [-m <density map> | -c <lat>,<lon> [-r <radius km>]]
+//                          [-d <duration s>] [-i <interval s>] [-b <start epoch s>]
+//                          [-f <AircraftList.json>] [-o <capture.ltc.gz>]
+//        defaults: 1000 flights, seed 1, within 50km around EGLL,
+//                  600s in 20s intervals, starting now
+//        Run from LiveTraffic's root folder, which also serves as
+//        plugin folder (Resources/FlightModels.prf).
+
+#include "LiveTraffic.h"
+#include "XPStub.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <zlib.h>
+
+PLUGIN_API int  XPluginStart (char* outName, char* outSig, char* outDesc);
+PLUGIN_API void XPluginStop (void);
+
+//
+//MARK: Settings
+//
+
+int         synNumFlights   = 1000;
+unsigned    synSeed         = 1;
+std::string synDensityMap;                  // empty: one area around synLat/synLon
+double      synLat          = 51.4700;      // EGLL
+double      synLon          = -0.4543;
+double      synRadius_km    = 50.0;
+double      synDuration     = 600.0;        // [s]
+double      synIntvl        = 20.0;         // [s] between two responses
+double      synStartTs      = NAN;          // NAN: now
+std::string synSnapshotFile;
+std::string synCaptureFile;
+
+//
+//MARK: Output
+//
+
+// writes one response record to the capture
+bool WriteCaptureRec (gzFile f, const std::string& data, double ts)
+{
+    rawRecHeadTy head;
+    memset(&head, 0, sizeof(head));
+    head.len        = (uint32_t)data.size();
+    head.httpStatus = HTTP_OK;
+    head.type       = RAW_REC_RESPONSE;
+    head.chId       = uint8_t(DR_CHANNEL_ADSB_EXCHANGE_ONLINE - DR_CHANNEL_FIRST);
+    // received 'now', which is ahead of sim time by the buffering period
+    head.simTime    = ts - dataRefs.GetFdBufPeriod();
+    head.wallTime   = ts;
+    return gzwrite(f, &head, sizeof(head)) == (int)sizeof(head) &&
+           gzwrite(f, data.data(), (unsigned)data.size()) == (int)data.size();
+}
+
+//
+//MARK: Main
+//
+
+int main (int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i+1 < argc)       synNumFlights = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i+1 < argc)  synSeed = (unsigned)atol(argv[++i]);
+        else if (!strcmp(argv[i], "-m") && i+1 < argc)  synDensityMap = argv[++i];
+        else if (!strcmp(argv[i], "-c") && i+1 < argc &&
+                 sscanf(argv[++i], "%lf,%lf", &synLat, &synLon) == 2) {}
+        else if (!strcmp(argv[i], "-r") && i+1 < argc)  synRadius_km = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-d") && i+1 < argc)  synDuration = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-i") && i+1 < argc)  synIntvl = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-b") && i+1 < argc)  synStartTs = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-f") && i+1 < argc)  synSnapshotFile = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i+1 < argc)  synCaptureFile = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [-n <num flights>] [-s <seed>] "
+                            "[-m <density map> | -c <lat>,<lon> [-r <radius km>]] "
+                            "[-d <duration s>] [-i <interval s>] [-b <start epoch s>] "
+                            "[-f <AircraftList.json>] [-o <capture.ltc.gz>]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (synNumFlights < 1 || synIntvl <= 0.0 || synDuration < synIntvl || synRadius_km <= 0.0) {
+        fprintf(stderr, "Need at least 1 flight, a positive radius, and a duration of at least one interval\n");
+        return 1;
+    }
+    if (synSnapshotFile.empty() && synCaptureFile.empty())
+        fprintf(stderr, "Neither -f nor -o given, just generating\n");
+    if (std::isnan(synStartTs))
+        synStartTs = double(time(nullptr));
+    
+    // the areas to generate traffic in
+    vecSynthAreaTy vAreas;
+    if (!synDensityMap.empty()) {
+        if (!SynthReadDensityMap(synDensityMap, vAreas) || vAreas.empty()) {
+            fprintf(stderr, "Could not read density map '%s'\n", synDensityMap.c_str());
+            return 1;
+        }
+    } else {
+        synthAreaTy area;
+        area.lat    = synLat;
+        area.lon    = synLon;
+        area.radius = synRadius_km * M_per_KM;
+        area.numAp  = SYNTH_DEFAULT_NUM_AP;
+        vAreas.push_back(area);
+    }
+    
+    // play X-Plane: the current folder is LiveTraffic's folder,
+    // starting the plugin reads the flight models
+    XPStubSetPluginPath("./64/lin.xpl");
+    XPStubSetCamera(vAreas.front().lat, vAreas.front().lon, 1000.0);
+    char szName[256], szSig[256], szDesc[256];
+    if (!XPluginStart(szName, szSig, szDesc)) {
+        fprintf(stderr, "LiveTraffic failed to start\n");
+        return 1;
+    }
+    XPLMSetDatai(XPLMFindDataRef("livetraffic/cfg/auto_start"), 0);
+    dataRefs.SetSaveConfig(false);          // our settings are not the user's
+    
+    // the capture file
+    gzFile fCap = NULL;
+    if (!synCaptureFile.empty()) {
+        fCap = gzopen(synCaptureFile.c_str(), "wb");
+        rawFileHeadTy head;
+        memcpy(head.magic, RAW_FILE_MAGIC, sizeof(head.magic));
+        head.version = RAW_FILE_VER;
+        head.recHeadSize = sizeof(rawRecHeadTy);
+        if (!fCap || gzwrite(fCap, &head, sizeof(head)) != (int)sizeof(head)) {
+            fprintf(stderr, "Could not create '%s'\n", synCaptureFile.c_str());
+            if (fCap) gzclose(fCap);
+            XPluginStop();
+            return 1;
+        }
+    }
+    
+    // generate
+    SynthTraffic traffic (synSeed, synNumFlights, vAreas,
+                          positionTy(vAreas.front().lat, vAreas.front().lon),
+                          synStartTs);
+    vecSynthReportTy vRpt;
+    std::string response;
+    int nRsp = 0;
+    bool bOK = true;
+    for (double ts = synStartTs + synIntvl;
+         bOK && ts <= synStartTs + synDuration + 0.001;
+         ts += synIntvl)
+    {
+        vRpt.clear();
+        traffic.Advance(ts, vRpt);
+        SynthWriteADSBEx(response, vRpt);
+        nRsp++;
+        if (fCap && !WriteCaptureRec(fCap, response, ts)) {
+            fprintf(stderr, "Could not write to '%s'\n", synCaptureFile.c_str());
+            bOK = false;
+        }
+    }
+    if (fCap)
+        gzclose(fCap);
+    
+    // the last response as snapshot
+    if (bOK && !synSnapshotFile.empty()) {
+        FILE* f = fopen(synSnapshotFile.c_str(), "w");
+        if (f) {
+            fwrite(response.data(), 1, response.size(), f);
+            fclose(f);
+        } else {
+            fprintf(stderr, "Could not create '%s'\n", synSnapshotFile.c_str());
+            bOK = false;
+        }
+    }
+    
+    // what we did
+    const SynthTraffic::statsTy& stats = traffic.GetStats();
+    fprintf(stderr, "%d flights at %d airports, seed %u, %d responses with %.0fs interval\n",
+            (int)traffic.GetNumFlights(), (int)traffic.GetNumAirports(),
+            synSeed, nRsp, synIntvl);
+    fprintf(stderr, "flights started %ld, reports %ld (duplicates %ld, late %ld), dropped %ld\n",
+            stats.flights, stats.reports, stats.duplicates, stats.late, stats.dropped);
+    const char* PHASE_NAMES[SYN_CNT_PHASES] = {
+        "taxi out", "take-off", "climb", "cruise", "descend",
+        "approach", "roll-out", "taxi in", "done" };
+    fprintf(stderr, "now:");
+    for (int p = 0; p < SYN_CNT_PHASES; p++)
+        fprintf(stderr, " %s %d%s", PHASE_NAMES[p],
+                (int)traffic.CntPhase(synthPhaseTy(p)),
+                p + 1 < SYN_CNT_PHASES ? "," : "\n");
+    
+    XPluginStop();
+    return bOK ? 0 : 1;
+}
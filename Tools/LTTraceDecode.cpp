@@ -0,0 +1,138 @@
+//
+//  LTTraceDecode.cpp
+//  LiveTraffic
+/*
+ * Copyright (c) 2018, Birger Hoppe
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Standalone decoder for the position pipeline trace (LTTrace.bin),
+// prints a timeline per aircraft.
+//
+// Usage: LTTraceDecode <LTTrace.bin> [<transpIcao hex>]
+
+#define LT_TRACE_DECODER
+#include "LTTrace.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+
+// names for positionTy::onGrndE
+const char* GND_NAMES[] = { "?", "AIR", "GND" };
+
+// names for traceDropTy
+const char* DropReason (uint16_t info)
+{
+    switch (info) {
+        case TRC_DROP_BEFORE_TO:    return "before 'to' pos";
+        case TRC_DROP_OVERLAP:      return "overlaps neighbours";
+        case TRC_DROP_NOT_OK:       return "sharp turn/invalid speed";
+        case TRC_DROP_CH_SWITCH:    return "channel switched";
+        default:                    return "";
+    }
+}
+
+// prints one record
+void PrintRec (const traceRecTy& rec)
+{
+    const char* szEvt = rec.evt < TRC_CNT_EVT ? TRACE_EVT_NAMES[rec.evt] : "?";
+    printf("  %12.3f  %-9s", rec.tWall, szEvt);
+    if (std::isnan(rec.posTs)) {
+        printf("\n");
+        return;
+    }
+    
+    // position's timestamp human readable
+    char szTs[30] = "";
+    const time_t t = time_t(rec.posTs);
+    struct tm tm;
+#if IBM
+    gmtime_s(&tm, &t);
+#else
+    gmtime_r(&t, &tm);
+#endif
+    strftime(szTs, sizeof(szTs), "%F %T", &tm);
+    
+    printf("  %s.%01d  %10.6f %11.6f %7.0fm %s",
+           szTs, int(std::fmod(rec.posTs, 1.0) * 10),
+           rec.lat, rec.lon, rec.alt_m,
+           rec.gnd < 3 ? GND_NAMES[rec.gnd] : "?");
+    if (rec.evt == TRC_DROP)
+        printf("  (%s)", DropReason(rec.info));
+    printf("\n");
+}
+
+int main (int argc, const char* argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <LTTrace.bin> [<transpIcao hex>]\n", argv[0]);
+        return 1;
+    }
+    const unsigned long filterKey = argc >= 3 ? strtoul(argv[2], nullptr, 16) : 0;
+    
+    // read and verify header
+    std::ifstream in (argv[1], std::ios_base::in | std::ios_base::binary);
+    if (!in) {
+        fprintf(stderr, "Could not open %s\n", argv[1]);
+        return 1;
+    }
+    traceFileHeadTy head;
+    if (!in.read(reinterpret_cast<char*>(&head), sizeof(head)) ||
+        memcmp(head.magic, TRACE_FILE_MAGIC, sizeof(head.magic)) != 0 ||
+        head.version != TRACE_FILE_VER ||
+        head.recSize != sizeof(traceRecTy))
+    {
+        fprintf(stderr, "%s: Not a LiveTraffic trace file of version %d\n", argv[1], int(TRACE_FILE_VER));
+        return 1;
+    }
+    
+    // read all records
+    std::vector<traceRecTy> vRec (head.numRec);
+    if (!in.read(reinterpret_cast<char*>(vRec.data()), std::streamsize(vRec.size() * sizeof(traceRecTy)))) {
+        fprintf(stderr, "%s: File truncated\n", argv[1]);
+        vRec.resize(size_t(in.gcount()) / sizeof(traceRecTy));
+    }
+    printf("%s: %lu events (%lu older events were lost)\n",
+           argv[1], (unsigned long)vRec.size(), (unsigned long)head.numLost);
+    
+    // sort into per-aircraft timelines
+    // (records are oldest first already, stable sort keeps it that way)
+    std::map<uint32_t, std::vector<const traceRecTy*>> mapTimeline;
+    for (const traceRecTy& rec: vRec)
+        if (!filterKey || rec.acKey == filterKey)
+            mapTimeline[rec.acKey].push_back(&rec);
+    
+    for (auto& tl: mapTimeline) {
+        std::stable_sort(tl.second.begin(), tl.second.end(),
+                         [](const traceRecTy* a, const traceRecTy* b){return a->tWall < b->tWall;});
+        printf("\n=== %06X: %lu events ===\n", tl.first, (unsigned long)tl.second.size());
+        for (const traceRecTy* pRec: tl.second)
+            PrintRec(*pRec);
+    }
+    
+    return 0;
+}